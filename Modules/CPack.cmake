@@ -201,6 +201,32 @@
 #  will be a boolean variable which enables stripping of all files (a list
 #  of files evaluates to TRUE in CMake, so this change is compatible).
 #
+# .. variable:: CPACK_THREADS
+#
+#  Number of threads used to compress gzip and xz packages of the Archive
+#  and DEB generators.  The value 0 selects the number of hardware
+#  threads, and at most four times that number are used.  When these
+#  generators create one package per component or component group, the
+#  packages are also created concurrently, each compressed on its share
+#  of the threads.  Components installed into separate directories are
+#  installed concurrently too, each by its own ``cmake -P`` process.
+#
+#  * Mandatory : NO
+#  * Default   : 1
+#
+# .. variable:: CPACK_INCREMENTAL_INSTALL
+#
+#  If set to TRUE, the files the previous run of the generator installed
+#  into its temporary directory are reused: a file whose source has the
+#  same size and modification time as when it was installed last time is
+#  hard linked (or copied) from there instead of being installed again.
+#  A target whose install RPATH changed is installed again.
+#  The :variable:`CPACK_PACKAGE_FILE_NAME` and the install destinations
+#  should not change between runs for files to be reused.
+#
+#  * Mandatory : NO
+#  * Default   : FALSE
+#
 # .. variable:: CPACK_VERBATIM_VARIABLES
 #
 #  If set to TRUE, values of variables prefixed with CPACK_ will be escaped
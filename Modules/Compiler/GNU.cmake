@@ -34,6 +34,12 @@ macro(__compiler_gnu lang)
     # internally, as it ought to.  Work around this bug by setting -MT here
     # even though it isn't strictly necessary.
     set(CMAKE_DEPFILE_FLAGS_${lang} "-MD -MT <OBJECT> -MF <DEPFILE>")
+    if(CMAKE_GENERATOR MATCHES "Make")
+      # Makefiles include the depfiles.  Give each header a rule so that
+      # removing one does not break the build.
+      string(APPEND CMAKE_DEPFILE_FLAGS_${lang} " -MP")
+    endif()
+    set(CMAKE_${lang}_DEPFILE_FORMAT gcc)
   endif()
 
   # Initial configuration flags.
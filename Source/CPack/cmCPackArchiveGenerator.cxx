@@ -2,6 +2,7 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmCPackArchiveGenerator.h"
 
+#include "cmAlgorithms.h"
 #include "cmCPackComponentGroup.h"
 #include "cmCPackGenerator.h"
 #include "cmCPackLog.h"
@@ -11,6 +12,7 @@
 
 #include <map>
 #include <ostream>
+#include <sstream>
 #include <utility>
 #include <vector>
 
@@ -52,41 +54,107 @@ int cmCPackArchiveGenerator::InitializeInternal()
   this->SetOptionIfNotSet("CPACK_INCLUDE_TOPLEVEL_DIRECTORY", "1");
   return this->Superclass::InitializeInternal();
 }
-int cmCPackArchiveGenerator::addOneComponentToArchive(
-  cmArchiveWrite& archive, cmCPackComponent* component)
+
+/** \class cmCPackArchiveGenerator::ArchiveJob
+ * \brief Creates the archive of one or more components.
+ */
+class cmCPackArchiveGenerator::ArchiveJob
+  : public cmCPackGenerator::PackageJob
 {
-  cmCPackLogger(cmCPackLog::LOG_VERBOSE,
-                "   - packaging component: " << component->Name << std::endl);
-  // Add the files of this component to the archive
-  std::string localToplevel(this->GetOption("CPACK_TEMPORARY_DIRECTORY"));
-  localToplevel += "/" + component->Name;
-  // Change to local toplevel
-  cmWorkingDirectory workdir(localToplevel);
-  std::string filePrefix;
+public:
+  ArchiveJob(cmCPackLog* logger, std::string const& fileName)
+    : PackageJob(logger, cmSystemTools::GetFilenameName(fileName))
+    , FileName(fileName)
+    , Compress(cmArchiveWrite::CompressNone)
+  {
+  }
+
+  int Package() CM_OVERRIDE;
+
+  std::string FileName;
+  std::string Header;
+  cmArchiveWrite::Compress Compress;
+  std::string Format;
+  //! Component install directories are under this one
+  std::string TemporaryDirectory;
+  //! Prepended to the paths of the component files in the archive
+  std::string FilePrefix;
+  std::vector<cmCPackComponent const*> Components;
+};
+
+int cmCPackArchiveGenerator::ArchiveJob::Package()
+{
+  cmGeneratedFileStream gf;
+  gf.Open(this->FileName.c_str(), false, true);
+  gf << this->Header;
+  cmArchiveWrite archive(gf, this->Compress, this->Format, this->Threads);
+  archive.SetLocaleHeld(true);
+  if (!archive) {
+    cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem to create archive < "
+                    << this->FileName << ">. ERROR =" << archive.GetError()
+                    << std::endl);
+    return 0;
+  }
+  std::vector<cmCPackComponent const*>::const_iterator compIt;
+  for (compIt = this->Components.begin(); compIt != this->Components.end();
+       ++compIt) {
+    cmCPackComponent const* component = *compIt;
+    cmCPackLogger(cmCPackLog::LOG_VERBOSE, "   - packaging component: "
+                    << component->Name << std::endl);
+    // Add the files of this component to the archive
+    std::string const localToplevel =
+      this->TemporaryDirectory + "/" + component->Name;
+    std::vector<std::string>::const_iterator fileIt;
+    for (fileIt = component->Files.begin();
+         fileIt != component->Files.end(); ++fileIt) {
+      std::string rp = this->FilePrefix + *fileIt;
+      cmCPackLogger(cmCPackLog::LOG_DEBUG, "Adding file: " << rp
+                                                           << std::endl);
+      archive.Add(localToplevel + "/" + rp, localToplevel.size() + 1,
+                  CM_NULLPTR, false);
+      if (!archive) {
+        cmCPackLogger(cmCPackLog::LOG_ERROR, "ERROR while packaging files: "
+                        << archive.GetError() << std::endl);
+        return 0;
+      }
+    }
+  }
+  if (!archive.Close()) {
+    cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem to finish archive < "
+                    << this->FileName << ">. ERROR =" << archive.GetError()
+                    << std::endl);
+    return 0;
+  }
+  return 1;
+}
+
+cmCPackArchiveGenerator::ArchiveJob*
+cmCPackArchiveGenerator::CreateArchiveJob(std::string const& packageFileName)
+{
+  std::ostringstream header;
+  if (!this->GenerateHeader(&header)) {
+    cmCPackLogger(cmCPackLog::LOG_ERROR,
+                  "Problem to generate Header for archive < "
+                    << packageFileName << ">." << std::endl);
+    return CM_NULLPTR;
+  }
+  ArchiveJob* job = new ArchiveJob(this->Logger, packageFileName);
+  job->Header = header.str();
+  job->Compress = this->Compress;
+  job->Format = this->ArchiveFormat;
+  job->TemporaryDirectory = this->GetOption("CPACK_TEMPORARY_DIRECTORY");
   if (this->IsOn("CPACK_COMPONENT_INCLUDE_TOPLEVEL_DIRECTORY")) {
-    filePrefix = this->GetOption("CPACK_PACKAGE_FILE_NAME");
-    filePrefix += "/";
+    job->FilePrefix = this->GetOption("CPACK_PACKAGE_FILE_NAME");
+    job->FilePrefix += "/";
   }
   const char* installPrefix =
     this->GetOption("CPACK_PACKAGING_INSTALL_PREFIX");
   if (installPrefix && installPrefix[0] == '/' && installPrefix[1] != 0) {
     // add to file prefix and remove the leading '/'
-    filePrefix += installPrefix + 1;
-    filePrefix += "/";
-  }
-  std::vector<std::string>::const_iterator fileIt;
-  for (fileIt = component->Files.begin(); fileIt != component->Files.end();
-       ++fileIt) {
-    std::string rp = filePrefix + *fileIt;
-    cmCPackLogger(cmCPackLog::LOG_DEBUG, "Adding file: " << rp << std::endl);
-    archive.Add(rp, 0, CM_NULLPTR, false);
-    if (!archive) {
-      cmCPackLogger(cmCPackLog::LOG_ERROR, "ERROR while packaging files: "
-                      << archive.GetError() << std::endl);
-      return 0;
-    }
+    job->FilePrefix += installPrefix + 1;
+    job->FilePrefix += "/";
   }
-  return 1;
+  return job;
 }
 
 /*
@@ -103,7 +171,8 @@ int cmCPackArchiveGenerator::addOneComponentToArchive(
                     << (filename) << ">." << std::endl);                      \
     return 0;                                                                 \
   }                                                                           \
-  cmArchiveWrite archive(gf, this->Compress, this->ArchiveFormat);            \
+  cmArchiveWrite archive(gf, this->Compress, this->ArchiveFormat,            \
+                         this->GetThreadCount());                             \
   if (!(archive)) {                                                           \
     cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem to create archive < "       \
                     << (filename) << ">. ERROR =" << (archive).GetError()     \
@@ -114,6 +183,7 @@ int cmCPackArchiveGenerator::addOneComponentToArchive(
 int cmCPackArchiveGenerator::PackageComponents(bool ignoreGroup)
 {
   packageFileNames.clear();
+  std::vector<PackageJob*> jobs;
   // The default behavior is to have one package by component group
   // unless CPACK_COMPONENTS_IGNORE_GROUP is specified.
   if (!ignoreGroup) {
@@ -125,19 +195,15 @@ int cmCPackArchiveGenerator::PackageComponents(bool ignoreGroup)
       // Begin the archive for this group
       std::string packageFileName = std::string(toplevel) + "/" +
         this->GetArchiveComponentFileName(compGIt->first, true);
-
-      // open a block in order to automatically close archive
-      // at the end of the block
-      {
-        DECLARE_AND_OPEN_ARCHIVE(packageFileName, archive);
-        // now iterate over the component of this group
-        std::vector<cmCPackComponent*>::iterator compIt;
-        for (compIt = (compGIt->second).Components.begin();
-             compIt != (compGIt->second).Components.end(); ++compIt) {
-          // Add the files of this component to the archive
-          addOneComponentToArchive(archive, *compIt);
-        }
+      ArchiveJob* job = this->CreateArchiveJob(packageFileName);
+      if (!job) {
+        cmDeleteAll(jobs);
+        return 0;
       }
+      // now iterate over the component of this group
+      job->Components.assign((compGIt->second).Components.begin(),
+                             (compGIt->second).Components.end());
+      jobs.push_back(job);
       // add the generated package to package file names list
       packageFileNames.push_back(packageFileName);
     }
@@ -152,19 +218,16 @@ int cmCPackArchiveGenerator::PackageComponents(bool ignoreGroup)
             << compIt->second.Name
             << "> does not belong to any group, package it separately."
             << std::endl);
-        std::string localToplevel(
-          this->GetOption("CPACK_TEMPORARY_DIRECTORY"));
         std::string packageFileName = std::string(toplevel);
-
-        localToplevel += "/" + compIt->first;
         packageFileName +=
           "/" + this->GetArchiveComponentFileName(compIt->first, false);
-
-        {
-          DECLARE_AND_OPEN_ARCHIVE(packageFileName, archive);
-          // Add the files of this component to the archive
-          addOneComponentToArchive(archive, &(compIt->second));
+        ArchiveJob* job = this->CreateArchiveJob(packageFileName);
+        if (!job) {
+          cmDeleteAll(jobs);
+          return 0;
         }
+        job->Components.push_back(&(compIt->second));
+        jobs.push_back(job);
         // add the generated package to package file names list
         packageFileNames.push_back(packageFileName);
       }
@@ -176,23 +239,23 @@ int cmCPackArchiveGenerator::PackageComponents(bool ignoreGroup)
     std::map<std::string, cmCPackComponent>::iterator compIt;
     for (compIt = this->Components.begin(); compIt != this->Components.end();
          ++compIt) {
-      std::string localToplevel(this->GetOption("CPACK_TEMPORARY_DIRECTORY"));
       std::string packageFileName = std::string(toplevel);
-
-      localToplevel += "/" + compIt->first;
       packageFileName +=
         "/" + this->GetArchiveComponentFileName(compIt->first, false);
-
-      {
-        DECLARE_AND_OPEN_ARCHIVE(packageFileName, archive);
-        // Add the files of this component to the archive
-        addOneComponentToArchive(archive, &(compIt->second));
+      ArchiveJob* job = this->CreateArchiveJob(packageFileName);
+      if (!job) {
+        cmDeleteAll(jobs);
+        return 0;
       }
+      job->Components.push_back(&(compIt->second));
+      jobs.push_back(job);
       // add the generated package to package file names list
       packageFileNames.push_back(packageFileName);
     }
   }
-  return 1;
+  int const retval = this->PackageConcurrently(jobs);
+  cmDeleteAll(jobs);
+  return retval;
 }
 
 int cmCPackArchiveGenerator::PackageComponentsAllInOne()
@@ -214,18 +277,22 @@ int cmCPackArchiveGenerator::PackageComponentsAllInOne()
                 "Packaging all groups in one package..."
                 "(CPACK_COMPONENTS_ALL_GROUPS_IN_ONE_PACKAGE is set)"
                   << std::endl);
-  DECLARE_AND_OPEN_ARCHIVE(packageFileNames[0], archive);
+  ArchiveJob* job = this->CreateArchiveJob(packageFileNames[0]);
+  if (!job) {
+    return 0;
+  }
 
   // The ALL COMPONENTS in ONE package case
   std::map<std::string, cmCPackComponent>::iterator compIt;
   for (compIt = this->Components.begin(); compIt != this->Components.end();
        ++compIt) {
-    // Add the files of this component to the archive
-    addOneComponentToArchive(archive, &(compIt->second));
+    job->Components.push_back(&(compIt->second));
   }
 
-  // archive goes out of scope so it will finalized and closed.
-  return 1;
+  std::vector<PackageJob*> jobs(1, job);
+  int const retval = this->PackageConcurrently(jobs);
+  cmDeleteAll(jobs);
+  return retval;
 }
 
 int cmCPackArchiveGenerator::PackageFiles()
@@ -263,7 +330,12 @@ int cmCPackArchiveGenerator::PackageFiles()
       return 0;
     }
   }
-  // The destructor of cmArchiveWrite will close and finish the write
+  if (!archive.Close()) {
+    cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem to finish archive < "
+                    << packageFileNames[0] << ">. ERROR ="
+                    << archive.GetError() << std::endl);
+    return 0;
+  }
   return 1;
 }
 
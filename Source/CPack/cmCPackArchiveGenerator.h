@@ -41,14 +41,14 @@ private:
 
 protected:
   int InitializeInternal() CM_OVERRIDE;
+  class ArchiveJob;
   /**
-   * Add the files belonging to the specified component
-   * to the provided (already opened) archive.
-   * @param[in,out] archive the archive object
-   * @param[in] component the component whose file will be added to archive
+   * Prepare a job creating the specified archive.  The caller
+   * adds the components whose files go in the archive.
+   * @param[in] packageFileName the archive to create
+   * @return null if error.
    */
-  int addOneComponentToArchive(cmArchiveWrite& archive,
-                               cmCPackComponent* component);
+  ArchiveJob* CreateArchiveJob(std::string const& packageFileName);
 
   /**
    * The main package file method.
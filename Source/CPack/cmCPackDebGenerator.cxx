@@ -2,6 +2,7 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmCPackDebGenerator.h"
 
+#include "cmAlgorithms.h"
 #include "cmArchiveWrite.h"
 #include "cmCPackComponentGroup.h"
 #include "cmCPackGenerator.h"
@@ -29,6 +30,39 @@
 static int ar_append(const char* archive,
                      const std::vector<std::string>& files);
 
+/** \class cmCPackDebGenerator::DebJob
+ * \brief Creates one Debian package from a snapshot of the options.
+ */
+class cmCPackDebGenerator::DebJob : public cmCPackGenerator::PackageJob
+{
+public:
+  DebJob(cmCPackLog* logger, std::string const& name)
+    : PackageJob(logger, name)
+  {
+  }
+
+  int Package() CM_OVERRIDE;
+
+  const char* GetOption(std::string const& op) const
+  {
+    std::map<std::string, std::string>::const_iterator i =
+      this->Options.find(op);
+    return i != this->Options.end() ? i->second.c_str() : CM_NULLPTR;
+  }
+  bool IsOn(std::string const& op) const
+  {
+    return cmSystemTools::IsOn(this->GetOption(op));
+  }
+  bool IsSet(std::string const& op) const
+  {
+    const char* value = this->GetOption(op);
+    return value && *value && !cmSystemTools::IsNOTFOUND(value);
+  }
+
+  std::map<std::string, std::string> Options;
+  std::vector<std::string> PackageFiles;
+};
+
 cmCPackDebGenerator::cmCPackDebGenerator()
 {
 }
@@ -47,9 +81,9 @@ int cmCPackDebGenerator::InitializeInternal()
 }
 
 int cmCPackDebGenerator::PackageOnePack(std::string const& initialTopLevel,
-                                        std::string const& packageName)
+                                        std::string const& packageName,
+                                        std::vector<PackageJob*>& jobs)
 {
-  int retval = 1;
   // Begin the archive for this pack
   std::string localToplevel(initialTopLevel);
   std::string packageFileName(cmSystemTools::GetParentDirectory(toplevel));
@@ -73,11 +107,15 @@ int cmCPackDebGenerator::PackageOnePack(std::string const& initialTopLevel,
   component_path += packageName;
   this->SetOption("CPACK_DEB_PACKAGE_COMPONENT_PART_PATH",
                   component_path.c_str());
+  return this->PrepareDeb(jobs);
+}
+
+int cmCPackDebGenerator::PrepareDeb(std::vector<PackageJob*>& jobs)
+{
   if (!this->ReadListFile("CPackDeb.cmake")) {
     cmCPackLogger(cmCPackLog::LOG_ERROR, "Error while execution CPackDeb.cmake"
                     << std::endl);
-    retval = 0;
-    return retval;
+    return 0;
   }
 
   cmsys::Glob gl;
@@ -91,18 +129,25 @@ int cmCPackDebGenerator::PackageOnePack(std::string const& initialTopLevel,
                     << std::endl);
     return 0;
   }
-  packageFiles = gl.GetFiles();
 
-  int res = createDeb();
-  if (res != 1) {
-    retval = 0;
+  DebJob* job =
+    new DebJob(this->Logger, this->GetOption("GEN_CPACK_OUTPUT_FILE_NAME"));
+  job->PackageFiles = gl.GetFiles();
+  std::vector<std::string> const options = this->GetOptions();
+  for (std::vector<std::string>::const_iterator oi = options.begin();
+       oi != options.end(); ++oi) {
+    if (const char* value = this->GetOption(*oi)) {
+      job->Options[*oi] = value;
+    }
   }
+  jobs.push_back(job);
+
   // add the generated package to package file names list
-  packageFileName = this->GetOption("CPACK_TOPLEVEL_DIRECTORY");
+  std::string packageFileName = this->GetOption("CPACK_TOPLEVEL_DIRECTORY");
   packageFileName += "/";
   packageFileName += this->GetOption("GEN_CPACK_OUTPUT_FILE_NAME");
   packageFileNames.push_back(packageFileName);
-  return retval;
+  return 1;
 }
 
 int cmCPackDebGenerator::PackageComponents(bool ignoreGroup)
@@ -112,6 +157,7 @@ int cmCPackDebGenerator::PackageComponents(bool ignoreGroup)
    * component packaging run*/
   packageFileNames.clear();
   std::string initialTopLevel(this->GetOption("CPACK_TEMPORARY_DIRECTORY"));
+  std::vector<PackageJob*> jobs;
 
   // The default behavior is to have one package by component group
   // unless CPACK_COMPONENTS_IGNORE_GROUP is specified.
@@ -122,7 +168,7 @@ int cmCPackDebGenerator::PackageComponents(bool ignoreGroup)
       cmCPackLogger(cmCPackLog::LOG_VERBOSE, "Packaging component group: "
                       << compGIt->first << std::endl);
       // Begin the archive for this group
-      retval &= PackageOnePack(initialTopLevel, compGIt->first);
+      retval &= PackageOnePack(initialTopLevel, compGIt->first, jobs);
     }
     // Handle Orphan components (components not belonging to any groups)
     std::map<std::string, cmCPackComponent>::iterator compIt;
@@ -136,7 +182,7 @@ int cmCPackDebGenerator::PackageComponents(bool ignoreGroup)
             << "> does not belong to any group, package it separately."
             << std::endl);
         // Begin the archive for this orphan component
-        retval &= PackageOnePack(initialTopLevel, compIt->first);
+        retval &= PackageOnePack(initialTopLevel, compIt->first, jobs);
       }
     }
   }
@@ -146,9 +192,11 @@ int cmCPackDebGenerator::PackageComponents(bool ignoreGroup)
     std::map<std::string, cmCPackComponent>::iterator compIt;
     for (compIt = this->Components.begin(); compIt != this->Components.end();
          ++compIt) {
-      retval &= PackageOnePack(initialTopLevel, compIt->first);
+      retval &= PackageOnePack(initialTopLevel, compIt->first, jobs);
     }
   }
+  retval &= this->PackageConcurrently(jobs);
+  cmDeleteAll(jobs);
   return retval;
 }
 
@@ -156,7 +204,6 @@ int cmCPackDebGenerator::PackageComponents(bool ignoreGroup)
 int cmCPackDebGenerator::PackageComponentsAllInOne(
   const std::string& compInstDirName)
 {
-  int retval = 1;
   /* Reset package file name list it will be populated during the
    * component packaging run*/
   packageFileNames.clear();
@@ -196,35 +243,10 @@ int cmCPackDebGenerator::PackageComponentsAllInOne(
     this->SetOption("CPACK_DEB_PACKAGE_COMPONENT_PART_PATH",
                     component_path.c_str());
   }
-  if (!this->ReadListFile("CPackDeb.cmake")) {
-    cmCPackLogger(cmCPackLog::LOG_ERROR, "Error while execution CPackDeb.cmake"
-                    << std::endl);
-    retval = 0;
-    return retval;
-  }
-
-  cmsys::Glob gl;
-  std::string findExpr(this->GetOption("GEN_WDIR"));
-  findExpr += "/*";
-  gl.RecurseOn();
-  gl.SetRecurseListDirs(true);
-  if (!gl.FindFiles(findExpr)) {
-    cmCPackLogger(cmCPackLog::LOG_ERROR,
-                  "Cannot find any files in the installed directory"
-                    << std::endl);
-    return 0;
-  }
-  packageFiles = gl.GetFiles();
-
-  int res = createDeb();
-  if (res != 1) {
-    retval = 0;
-  }
-  // add the generated package to package file names list
-  packageFileName = this->GetOption("CPACK_TOPLEVEL_DIRECTORY");
-  packageFileName += "/";
-  packageFileName += this->GetOption("GEN_CPACK_OUTPUT_FILE_NAME");
-  packageFileNames.push_back(packageFileName);
+  std::vector<PackageJob*> jobs;
+  int retval = this->PrepareDeb(jobs);
+  retval &= this->PackageConcurrently(jobs);
+  cmDeleteAll(jobs);
   return retval;
 }
 
@@ -249,7 +271,7 @@ int cmCPackDebGenerator::PackageFiles()
   return PackageComponentsAllInOne("");
 }
 
-int cmCPackDebGenerator::createDeb()
+int cmCPackDebGenerator::DebJob::Package()
 {
   // debian-binary file
   const std::string strGenWDIR(this->GetOption("GEN_WDIR"));
@@ -348,8 +370,8 @@ int cmCPackDebGenerator::createDeb()
       std::string dirName = this->GetOption("CPACK_TEMPORARY_DIRECTORY");
       dirName += '/';
       for (std::vector<std::string>::const_iterator fileIt =
-             packageFiles.begin();
-           fileIt != packageFiles.end(); ++fileIt) {
+             this->PackageFiles.begin();
+           fileIt != this->PackageFiles.end(); ++fileIt) {
         totalSize += cmSystemTools::FileLength(*fileIt);
       }
     }
@@ -438,7 +460,8 @@ int cmCPackDebGenerator::createDeb()
       return 0;
     }
     cmArchiveWrite data_tar(fileStream_data_tar, tar_compression_type,
-                            debian_archive_type);
+                            debian_archive_type, this->Threads);
+    data_tar.SetLocaleHeld(true);
 
     // uid/gid should be the one of the root user, and this root user has
     // always uid/gid equal to 0.
@@ -458,8 +481,8 @@ int cmCPackDebGenerator::createDeb()
     // we have to reconstruct the parent folders as well
 
     for (std::vector<std::string>::const_iterator fileIt =
-           packageFiles.begin();
-         fileIt != packageFiles.end(); ++fileIt) {
+           this->PackageFiles.begin();
+         fileIt != this->PackageFiles.end(); ++fileIt) {
       std::string currentPath = *fileIt;
       while (currentPath != strGenWDIR) {
         // the last one IS strGenWDIR, but we do not want this one:
@@ -509,6 +532,13 @@ int cmCPackDebGenerator::createDeb()
         return 0;
       }
     }
+    if (!data_tar.Close()) {
+      cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem writing tar file:"
+                      << std::endl
+                      << "#file: " << filename_data_tar << std::endl
+                      << "#error:" << data_tar.GetError() << std::endl);
+      return 0;
+    }
   } // scope for file generation
 
   std::string md5filename = strGenWDIR + "/md5sums";
@@ -520,8 +550,8 @@ int cmCPackDebGenerator::createDeb()
       this->GetOption("CPACK_TEMPORARY_DIRECTORY");
     topLevelWithTrailingSlash += '/';
     for (std::vector<std::string>::const_iterator fileIt =
-           packageFiles.begin();
-         fileIt != packageFiles.end(); ++fileIt) {
+           this->PackageFiles.begin();
+         fileIt != this->PackageFiles.end(); ++fileIt) {
       // hash only regular files
       if (cmSystemTools::FileIsDirectory(*fileIt) ||
           cmSystemTools::FileIsSymlink(*fileIt)) {
@@ -561,6 +591,7 @@ int cmCPackDebGenerator::createDeb()
     cmArchiveWrite control_tar(fileStream_control_tar,
                                cmArchiveWrite::CompressGZip,
                                debian_archive_type);
+    control_tar.SetLocaleHeld(true);
 
     // sets permissions and uid/gid for the files
     control_tar.SetUIDAndGID(0u, 0u);
@@ -669,6 +700,13 @@ int cmCPackDebGenerator::createDeb()
         }
       }
     }
+    if (!control_tar.Close()) {
+      cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem writing tar file:"
+                      << std::endl
+                      << "#file: " << filename_control_tar << std::endl
+                      << "#error:" << control_tar.GetError() << std::endl);
+      return 0;
+    }
   }
 
   // ar -r your-package-name.deb debian-binary control.tar.* data.tar.*
@@ -726,6 +764,7 @@ std::string cmCPackDebGenerator::GetComponentInstallDirNameSuffix(
 // -use the stdio file I/O functions instead the file descriptor based ones
 // -merged into one cxx file
 // -no additional options supported
+// -no global state, so packages may be created concurrently
 // The coding style hasn't been modified.
 
 /*-
@@ -789,18 +828,20 @@ struct ar_hdr
     cf.wFile = to;                                                            \
     cf.wname = toname;                                                        \
     cf.flags = pad;                                                           \
+    cf.already_written = 0;                                                   \
   }
 
 /* File copy structure. */
 typedef struct
 {
-  FILE* rFile;        /* read file descriptor */
-  const char* rname;  /* read name */
-  FILE* wFile;        /* write file descriptor */
-  const char* wname;  /* write name */
-#define NOPAD 0x00    /* don't pad */
-#define WPAD 0x02     /* pad on writes */
-  unsigned int flags; /* pad flags */
+  FILE* rFile;            /* read file descriptor */
+  const char* rname;      /* read name */
+  FILE* wFile;            /* write file descriptor */
+  const char* wname;      /* write name */
+#define NOPAD 0x00        /* don't pad */
+#define WPAD 0x02         /* pad on writes */
+  unsigned int flags;     /* pad flags */
+  size_t already_written; /* long name written before the object */
 } CF;
 
 /* misc.c */
@@ -814,9 +855,6 @@ static const char* ar_rname(const char* path)
 /* archive.c */
 
 typedef struct ar_hdr HDR;
-static char ar_hb[sizeof(HDR) + 1]; /* real header */
-
-static size_t ar_already_written;
 
 /* copy_ar --
  *      Copy size bytes from one file to another - taking care to handle the
@@ -833,7 +871,7 @@ static size_t ar_already_written;
  */
 static int copy_ar(CF* cfp, off_t size)
 {
-  static char pad = '\n';
+  static const char pad = '\n';
   off_t sz = size;
   size_t nr, nw;
   char buf[8 * 1024];
@@ -860,7 +898,7 @@ static int copy_ar(CF* cfp, off_t size)
     return -2;
   }
 
-  if (cfp->flags & WPAD && (size + ar_already_written) & 1 &&
+  if (cfp->flags & WPAD && (size + cfp->already_written) & 1 &&
       fwrite(&pad, 1, 1, to) != 1) {
     return -4;
   }
@@ -872,6 +910,7 @@ static int copy_ar(CF* cfp, off_t size)
 static int put_arobj(CF* cfp, struct stat* sb)
 {
   int result = 0;
+  char ar_hb[sizeof(HDR) + 1]; /* real header */
 
   /* If passed an sb structure, reading a file from disk.  Get stat(2)
    * information, build a name and construct a header.  (Files are named
@@ -910,10 +949,10 @@ static int put_arobj(CF* cfp, struct stat* sb)
     if (fwrite(name, 1, lname, cfp->wFile) != lname) {
       return -2;
     }
-    ar_already_written = lname;
+    cfp->already_written = lname;
   }
   result = copy_ar(cfp, size);
-  ar_already_written = 0;
+  cfp->already_written = 0;
   return result;
 }
 
@@ -45,7 +45,13 @@ protected:
    * This method factors out the work done in component packaging case.
    */
   int PackageOnePack(std::string const& initialToplevel,
-                     std::string const& packageName);
+                     std::string const& packageName,
+                     std::vector<PackageJob*>& jobs);
+  /**
+   * Read CPackDeb.cmake for the package set up in the options and
+   * append a job creating it.
+   */
+  int PrepareDeb(std::vector<PackageJob*>& jobs);
   /**
    * The method used to package files when component
    * install is used. This will create one
@@ -64,8 +70,7 @@ protected:
     const std::string& componentName) CM_OVERRIDE;
 
 private:
-  int createDeb();
-  std::vector<std::string> packageFiles;
+  class DebJob;
 };
 
 #endif
@@ -4,8 +4,11 @@
 
 #include "cmsys/FStream.hxx"
 #include "cmsys/Glob.hxx"
+#include "cmsys/Process.h"
 #include "cmsys/RegularExpression.hxx"
 #include <algorithm>
+#include <iomanip>
+#include <iterator>
 #include <utility>
 
 #include "cmCPackComponentGroup.h"
@@ -13,7 +16,10 @@
 #include "cmCryptoHash.h"
 #include "cmGeneratedFileStream.h"
 #include "cmGlobalGenerator.h"
+#include "cmLocale.h"
 #include "cmMakefile.h"
+#include "cmOutputConverter.h"
+#include "cmProcessOutput.h"
 #include "cmStateSnapshot.h"
 #include "cmWorkingDirectory.h"
 #include "cmXMLSafe.h"
@@ -609,26 +615,18 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
       cmCPackLogger(cmCPackLog::LOG_OUTPUT,
                     "- Install project: " << installProjectName << std::endl);
 
-      // Run the installation for each component
+      // Prepare the installation of each component
+      std::vector<ComponentInstall> installs;
       std::vector<std::string>::iterator componentIt;
       for (componentIt = componentsVector.begin();
            componentIt != componentsVector.end(); ++componentIt) {
         std::string tempInstallDirectory = baseTempInstallDirectory;
         installComponent = *componentIt;
-        if (componentInstall) {
-          cmCPackLogger(cmCPackLog::LOG_OUTPUT, "-   Install component: "
-                          << installComponent << std::endl);
-        }
+        installs.push_back(ComponentInstall());
+        ComponentInstall& install = installs.back();
+        install.Component = installComponent;
+        install.ListFiles = componentInstall;
 
-        cmake cm(cmake::RoleScript);
-        cm.SetHomeDirectory("");
-        cm.SetHomeOutputDirectory("");
-        cm.GetCurrentSnapshot().SetDefaultDefinitions();
-        cm.AddCMakePaths();
-        cm.SetProgressCallback(cmCPackGeneratorProgress, this);
-        cmGlobalGenerator gg(&cm);
-        CM_AUTO_PTR<cmMakefile> mf(
-          new cmMakefile(&gg, cm.GetCurrentSnapshot()));
         if (!installSubDirectory.empty() && installSubDirectory != "/" &&
             installSubDirectory != ".") {
           tempInstallDirectory += installSubDirectory;
@@ -674,7 +672,8 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
           if (this->GetOption("CPACK_INSTALL_PREFIX")) {
             dir += this->GetOption("CPACK_INSTALL_PREFIX");
           }
-          mf->AddDefinition("CMAKE_INSTALL_PREFIX", dir.c_str());
+          install.Definitions.push_back(
+            std::make_pair(std::string("CMAKE_INSTALL_PREFIX"), dir));
 
           cmCPackLogger(
             cmCPackLog::LOG_DEBUG,
@@ -703,8 +702,7 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
            *     - Because it was already used for component install
            *       in order to put things in subdirs...
            */
-          cmSystemTools::PutEnv(std::string("DESTDIR=") +
-                                tempInstallDirectory);
+          install.DestDir = tempInstallDirectory;
           cmCPackLogger(cmCPackLog::LOG_DEBUG, "- Creating directory: '"
                           << dir << "'" << std::endl);
 
@@ -715,8 +713,8 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
             return 0;
           }
         } else {
-          mf->AddDefinition("CMAKE_INSTALL_PREFIX",
-                            tempInstallDirectory.c_str());
+          install.Definitions.push_back(std::make_pair(
+            std::string("CMAKE_INSTALL_PREFIX"), tempInstallDirectory));
 
           if (!cmsys::SystemTools::MakeDirectory(
                 tempInstallDirectory.c_str())) {
@@ -733,41 +731,32 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
                         "- Setting CMAKE_INSTALL_PREFIX to '"
                           << tempInstallDirectory << "'" << std::endl);
         }
+        install.Directory = tempInstallDirectory;
 
         if (!buildConfig.empty()) {
-          mf->AddDefinition("BUILD_TYPE", buildConfig.c_str());
+          install.Definitions.push_back(
+            std::make_pair(std::string("BUILD_TYPE"), buildConfig));
         }
         std::string installComponentLowerCase =
           cmSystemTools::LowerCase(installComponent);
         if (installComponentLowerCase != "all") {
-          mf->AddDefinition("CMAKE_INSTALL_COMPONENT",
-                            installComponent.c_str());
+          install.Definitions.push_back(std::make_pair(
+            std::string("CMAKE_INSTALL_COMPONENT"), installComponent));
         }
 
         // strip on TRUE, ON, 1, one or several file names, but not on
         // FALSE, OFF, 0 and an empty string
         if (!cmSystemTools::IsOff(this->GetOption("CPACK_STRIP_FILES"))) {
-          mf->AddDefinition("CMAKE_INSTALL_DO_STRIP", "1");
-        }
-        // Remember the list of files before installation
-        // of the current component (if we are in component install)
-        const char* InstallPrefix = tempInstallDirectory.c_str();
-        std::vector<std::string> filesBefore;
-        std::string findExpr(InstallPrefix);
-        if (componentInstall) {
-          cmsys::Glob glB;
-          findExpr += "/*";
-          glB.RecurseOn();
-          glB.SetRecurseListDirs(true);
-          glB.FindFiles(findExpr);
-          filesBefore = glB.GetFiles();
-          std::sort(filesBefore.begin(), filesBefore.end());
+          install.Definitions.push_back(std::make_pair(
+            std::string("CMAKE_INSTALL_DO_STRIP"), std::string("1")));
         }
 
         // If CPack was asked to warn on ABSOLUTE INSTALL DESTINATION
         // then forward request to cmake_install.cmake script
         if (this->IsOn("CPACK_WARN_ON_ABSOLUTE_INSTALL_DESTINATION")) {
-          mf->AddDefinition("CMAKE_WARN_ON_ABSOLUTE_INSTALL_DESTINATION", "1");
+          install.Definitions.push_back(std::make_pair(
+            std::string("CMAKE_WARN_ON_ABSOLUTE_INSTALL_DESTINATION"),
+            std::string("1")));
         }
         // If current CPack generator does support
         // ABSOLUTE INSTALL DESTINATION or CPack has been asked for
@@ -775,58 +764,59 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
         // as soon as it occurs (before installing file)
         if (!SupportsAbsoluteDestination() ||
             this->IsOn("CPACK_ERROR_ON_ABSOLUTE_INSTALL_DESTINATION")) {
-          mf->AddDefinition("CMAKE_ERROR_ON_ABSOLUTE_INSTALL_DESTINATION",
-                            "1");
+          install.Definitions.push_back(std::make_pair(
+            std::string("CMAKE_ERROR_ON_ABSOLUTE_INSTALL_DESTINATION"),
+            std::string("1")));
         }
-        // do installation
-        int res = mf->ReadListFile(installFile.c_str());
-        // forward definition of CMAKE_ABSOLUTE_DESTINATION_FILES
-        // to CPack (may be used by generators like CPack RPM or DEB)
-        // in order to transparently handle ABSOLUTE PATH
-        if (mf->GetDefinition("CMAKE_ABSOLUTE_DESTINATION_FILES")) {
-          mf->AddDefinition(
-            "CPACK_ABSOLUTE_DESTINATION_FILES",
-            mf->GetDefinition("CMAKE_ABSOLUTE_DESTINATION_FILES"));
+        // Let the installation take unchanged files over from the
+        // previous one.
+        if (!this->PreviousInstallDirectory.empty()) {
+          install.Definitions.push_back(std::make_pair(
+            std::string("CMAKE_INSTALL_REUSE_TREE"),
+            baseTempInstallDirectory + ";" + this->PreviousInstallDirectory));
         }
+      }
 
-        // Now rebuild the list of files after installation
-        // of the current component (if we are in component install)
+      // Run the installation for each component
+      bool const concurrent =
+        installs.size() > 1 && this->GetThreadCount() != 1;
+      if (concurrent) {
+        this->InstallComponentsConcurrently(installs, installDirectory,
+                                            installFile);
+      }
+      std::vector<ComponentInstall>::iterator installIt;
+      for (installIt = installs.begin(); installIt != installs.end();
+           ++installIt) {
+        installComponent = installIt->Component;
         if (componentInstall) {
-          cmsys::Glob glA;
-          glA.RecurseOn();
-          glA.SetRecurseListDirs(true);
-          glA.SetRecurseThroughSymlinks(false);
-          glA.FindFiles(findExpr);
-          std::vector<std::string> filesAfter = glA.GetFiles();
-          std::sort(filesAfter.begin(), filesAfter.end());
-          std::vector<std::string>::iterator diff;
-          std::vector<std::string> result(filesAfter.size());
-          diff = std::set_difference(filesAfter.begin(), filesAfter.end(),
-                                     filesBefore.begin(), filesBefore.end(),
-                                     result.begin());
-
-          std::vector<std::string>::iterator fit;
-          std::string localFileName;
-          // Populate the File field of each component
-          for (fit = result.begin(); fit != diff; ++fit) {
-            localFileName =
-              cmSystemTools::RelativePath(InstallPrefix, fit->c_str());
-            localFileName =
-              localFileName.substr(localFileName.find_first_not_of('/'));
-            Components[installComponent].Files.push_back(localFileName);
-            cmCPackLogger(cmCPackLog::LOG_DEBUG, "Adding file <"
-                            << localFileName << "> to component <"
-                            << installComponent << ">" << std::endl);
+          cmCPackLogger(cmCPackLog::LOG_OUTPUT, "-   Install component: "
+                          << installComponent << std::endl);
+        }
+        if (concurrent) {
+          if (!installIt->Output.empty()) {
+            cmCPackLogger(installIt->Result ? cmCPackLog::LOG_VERBOSE
+                                            : cmCPackLog::LOG_ERROR,
+                          installIt->Output);
           }
+        } else {
+          this->InstallComponent(*installIt, installFile);
         }
 
-        if (CM_NULLPTR !=
-            mf->GetDefinition("CPACK_ABSOLUTE_DESTINATION_FILES")) {
+        // Populate the File field of each component
+        std::vector<std::string>::const_iterator fit;
+        for (fit = installIt->Files.begin(); fit != installIt->Files.end();
+             ++fit) {
+          Components[installComponent].Files.push_back(*fit);
+          cmCPackLogger(cmCPackLog::LOG_DEBUG, "Adding file <"
+                          << *fit << "> to component <" << installComponent
+                          << ">" << std::endl);
+        }
+
+        if (!installIt->AbsoluteDestinationFiles.empty()) {
           if (!absoluteDestFiles.empty()) {
             absoluteDestFiles += ";";
           }
-          absoluteDestFiles +=
-            mf->GetDefinition("CPACK_ABSOLUTE_DESTINATION_FILES");
+          absoluteDestFiles += installIt->AbsoluteDestinationFiles;
           cmCPackLogger(cmCPackLog::LOG_DEBUG,
                         "Got some ABSOLUTE DESTINATION FILES: "
                           << absoluteDestFiles << std::endl);
@@ -840,17 +830,16 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
                 this->GetOption(absoluteDestFileComponent);
               absoluteDestFilesListComponent += ";";
               absoluteDestFilesListComponent +=
-                mf->GetDefinition("CPACK_ABSOLUTE_DESTINATION_FILES");
+                installIt->AbsoluteDestinationFiles;
               this->SetOption(absoluteDestFileComponent,
                               absoluteDestFilesListComponent.c_str());
             } else {
-              this->SetOption(
-                absoluteDestFileComponent,
-                mf->GetDefinition("CPACK_ABSOLUTE_DESTINATION_FILES"));
+              this->SetOption(absoluteDestFileComponent,
+                              installIt->AbsoluteDestinationFiles.c_str());
             }
           }
         }
-        if (cmSystemTools::GetErrorOccuredFlag() || !res) {
+        if (!installIt->Result) {
           return 0;
         }
       }
@@ -861,6 +850,309 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
   return 1;
 }
 
+cmCPackGenerator::ComponentInstall::ComponentInstall()
+  : ListFiles(false)
+  , Result(false)
+{
+}
+
+static std::vector<std::string> cmCPackGeneratorFindFiles(
+  std::string const& directory, bool recurseThroughSymlinks)
+{
+  cmsys::Glob gl;
+  gl.RecurseOn();
+  gl.SetRecurseListDirs(true);
+  gl.SetRecurseThroughSymlinks(recurseThroughSymlinks);
+  gl.FindFiles(directory + "/*");
+  std::vector<std::string> files = gl.GetFiles();
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+// Find the files an installation added to a directory, relative to it.
+static void cmCPackGeneratorFindNewFiles(
+  std::string const& directory, std::vector<std::string> const& filesBefore,
+  std::vector<std::string>& files)
+{
+  std::vector<std::string> const filesAfter =
+    cmCPackGeneratorFindFiles(directory, false);
+  std::vector<std::string> result;
+  std::set_difference(filesAfter.begin(), filesAfter.end(),
+                      filesBefore.begin(), filesBefore.end(),
+                      std::back_inserter(result));
+  std::vector<std::string>::const_iterator fit;
+  for (fit = result.begin(); fit != result.end(); ++fit) {
+    std::string localFileName =
+      cmSystemTools::RelativePath(directory.c_str(), fit->c_str());
+    localFileName =
+      localFileName.substr(localFileName.find_first_not_of('/'));
+    files.push_back(localFileName);
+  }
+}
+
+void cmCPackGenerator::InstallComponent(ComponentInstall& install,
+                                        std::string const& installFile)
+{
+  cmake cm(cmake::RoleScript);
+  cm.SetHomeDirectory("");
+  cm.SetHomeOutputDirectory("");
+  cm.GetCurrentSnapshot().SetDefaultDefinitions();
+  cm.AddCMakePaths();
+  cm.SetProgressCallback(cmCPackGeneratorProgress, this);
+  cmGlobalGenerator gg(&cm);
+  CM_AUTO_PTR<cmMakefile> mf(new cmMakefile(&gg, cm.GetCurrentSnapshot()));
+  std::vector<std::pair<std::string, std::string> >::const_iterator di;
+  for (di = install.Definitions.begin(); di != install.Definitions.end();
+       ++di) {
+    mf->AddDefinition(di->first, di->second.c_str());
+  }
+  if (!install.DestDir.empty()) {
+    cmSystemTools::PutEnv(std::string("DESTDIR=") + install.DestDir);
+  }
+
+  // Remember the list of files before installation
+  // of the current component (if we are in component install)
+  std::vector<std::string> filesBefore;
+  if (install.ListFiles) {
+    filesBefore = cmCPackGeneratorFindFiles(install.Directory, true);
+  }
+
+  // do installation
+  bool res = mf->ReadListFile(installFile.c_str());
+  // forward definition of CMAKE_ABSOLUTE_DESTINATION_FILES
+  // to CPack (may be used by generators like CPack RPM or DEB)
+  // in order to transparently handle ABSOLUTE PATH
+  if (const char* absoluteDestFiles =
+        mf->GetDefinition("CMAKE_ABSOLUTE_DESTINATION_FILES")) {
+    install.AbsoluteDestinationFiles = absoluteDestFiles;
+  }
+
+  // Now rebuild the list of files after installation
+  // of the current component (if we are in component install)
+  if (install.ListFiles) {
+    cmCPackGeneratorFindNewFiles(install.Directory, filesBefore,
+                                 install.Files);
+  }
+  install.Result = res && !cmSystemTools::GetErrorOccuredFlag();
+}
+
+/** \class cmCPackInstallChain
+ * \brief Installations into one directory, run one after another.
+ */
+struct cmCPackInstallChain
+{
+  cmCPackInstallChain(std::vector<size_t> const& installs)
+    : Installs(installs)
+    , Next(0)
+    , Process(CM_NULLPTR)
+  {
+  }
+  ~cmCPackInstallChain() { cmsysProcess_Delete(this->Process); }
+
+  std::vector<size_t> Installs;
+  size_t Next;
+  cmsysProcess* Process;
+  cmProcessOutput Decoder;
+  std::string Script;
+  std::string ResultFile;
+  std::vector<std::string> FilesBefore;
+};
+
+// Write a script running a project's install script with the given
+// variables and DESTDIR, if any.  It saves CMAKE_ABSOLUTE_DESTINATION_FILES
+// to the result file.
+static bool cmCPackGeneratorWriteInstallScript(
+  std::string const& script, std::string const& installFile,
+  std::string const& destDir,
+  std::vector<std::pair<std::string, std::string> > const& definitions,
+  std::string const& resultFile)
+{
+  cmGeneratedFileStream fout(script.c_str());
+  if (!destDir.empty()) {
+    fout << "set(ENV{DESTDIR} " << cmOutputConverter::EscapeForCMake(destDir)
+         << ")\n";
+  }
+  std::vector<std::pair<std::string, std::string> >::const_iterator di;
+  for (di = definitions.begin(); di != definitions.end(); ++di) {
+    fout << "set(" << di->first << " "
+         << cmOutputConverter::EscapeForCMake(di->second) << ")\n";
+  }
+  fout << "include(" << cmOutputConverter::EscapeForCMake(installFile)
+       << ")\n"
+       << "file(WRITE " << cmOutputConverter::EscapeForCMake(resultFile)
+       << " \"${CMAKE_ABSOLUTE_DESTINATION_FILES}\")\n";
+  return fout.Close();
+}
+
+void cmCPackGenerator::InstallComponentsConcurrently(
+  std::vector<ComponentInstall>& installs,
+  std::string const& installDirectory, std::string const& installFile)
+{
+  // The files of a component are those its installation adds to the
+  // directory, so installations into one directory must not overlap.
+  std::vector<std::vector<size_t> > chains;
+  std::map<std::string, size_t> chainOfDirectory;
+  for (size_t i = 0; i < installs.size(); ++i) {
+    size_t const chain =
+      chainOfDirectory.insert(std::make_pair(installs[i].Directory,
+                                             chains.size()))
+        .first->second;
+    if (chain == chains.size()) {
+      chains.push_back(std::vector<size_t>());
+    }
+    chains[chain].push_back(i);
+  }
+
+  unsigned int threads = this->GetThreadCount();
+  if (threads == 0) {
+    threads = cmWorkerPool::GetHardwareThreadCount();
+  }
+  std::string const scriptPrefix =
+    std::string(this->GetOption("CPACK_TOPLEVEL_DIRECTORY")) +
+    "/InstallComponent";
+  std::vector<const char*> command;
+  command.push_back(cmSystemTools::GetCMakeCommand().c_str());
+  command.push_back("-P");
+  command.push_back(CM_NULLPTR);
+  command.push_back(CM_NULLPTR);
+
+  std::vector<cmCPackInstallChain*> running;
+  size_t nextChain = 0;
+  while (nextChain < chains.size() || !running.empty()) {
+    while (running.size() < threads && nextChain < chains.size()) {
+      running.push_back(new cmCPackInstallChain(chains[nextChain]));
+      ++nextChain;
+    }
+
+    // Share a tenth of a second between the running installations.
+    double const timeout = 0.1 / static_cast<double>(running.size());
+    for (size_t r = 0; r < running.size();) {
+      cmCPackInstallChain* chain = running[r];
+      ComponentInstall& install = installs[chain->Installs[chain->Next]];
+      if (!chain->Process) {
+        std::ostringstream name;
+        name << scriptPrefix << chain->Installs[chain->Next];
+        chain->Script = name.str() + ".cmake";
+        chain->ResultFile = name.str() + ".txt";
+        cmSystemTools::RemoveFile(chain->ResultFile);
+        if (install.ListFiles) {
+          chain->FilesBefore =
+            cmCPackGeneratorFindFiles(install.Directory, true);
+        }
+        if (!cmCPackGeneratorWriteInstallScript(
+              chain->Script, installFile, install.DestDir,
+              install.Definitions, chain->ResultFile)) {
+          install.Output = "Cannot write " + chain->Script + "\n";
+          install.Result = false;
+        } else {
+          command[2] = chain->Script.c_str();
+          chain->Process = cmsysProcess_New();
+          cmsysProcess_SetCommand(chain->Process, &*command.begin());
+          cmsysProcess_SetWorkingDirectory(chain->Process,
+                                           installDirectory.c_str());
+          cmsysProcess_SetOption(chain->Process,
+                                 cmsysProcess_Option_HideWindow, 1);
+          cmsysProcess_SetOption(chain->Process,
+                                 cmsysProcess_Option_MergeOutput, 1);
+          cmsysProcess_Execute(chain->Process);
+        }
+      }
+
+      if (chain->Process) {
+        // Collect output until the installation is done.
+        char* data;
+        int length;
+        double wait = timeout;
+        int pipe;
+        std::string strdata;
+        while ((pipe = cmsysProcess_WaitForData(chain->Process, &data,
+                                                &length, &wait)) ==
+               cmsysProcess_Pipe_STDOUT) {
+          chain->Decoder.DecodeText(data, length, strdata);
+          install.Output += strdata;
+        }
+        if (pipe == cmsysProcess_Pipe_Timeout) {
+          ++r;
+          continue;
+        }
+        chain->Decoder.DecodeText(std::string(), strdata);
+        install.Output += strdata;
+        cmsysProcess_WaitForExit(chain->Process, CM_NULLPTR);
+
+        switch (cmsysProcess_GetState(chain->Process)) {
+          case cmsysProcess_State_Exited:
+            install.Result = cmsysProcess_GetExitValue(chain->Process) == 0;
+            break;
+          case cmsysProcess_State_Exception:
+            install.Output += cmsysProcess_GetExceptionString(chain->Process);
+            install.Result = false;
+            break;
+          case cmsysProcess_State_Error:
+            install.Output += cmsysProcess_GetErrorString(chain->Process);
+            install.Result = false;
+            break;
+          default:
+            install.Result = false;
+            break;
+        }
+        cmsysProcess_Delete(chain->Process);
+        chain->Process = CM_NULLPTR;
+
+        cmsys::ifstream fin(chain->ResultFile.c_str());
+        cmSystemTools::GetLineFromStream(fin,
+                                         install.AbsoluteDestinationFiles);
+        fin.close();
+        cmSystemTools::RemoveFile(chain->ResultFile);
+        cmSystemTools::RemoveFile(chain->Script);
+        if (install.ListFiles) {
+          cmCPackGeneratorFindNewFiles(install.Directory, chain->FilesBefore,
+                                       install.Files);
+        }
+      }
+
+      // Start the next installation into this directory, if any.
+      if (++chain->Next == chain->Installs.size()) {
+        delete chain;
+        running.erase(running.begin() + r);
+      }
+    }
+  }
+}
+
+int cmCPackGenerator::PreparePreviousInstall()
+{
+  this->PreviousInstallDirectory.clear();
+  if (!this->IsOn("CPACK_INCREMENTAL_INSTALL")) {
+    return 1;
+  }
+  // Keep it out of the toplevel directory, which may be removed.
+  std::string const previous =
+    std::string(this->GetOption("CPACK_TOPLEVEL_DIRECTORY")) + ".previous";
+  if (cmSystemTools::FileExists(previous) &&
+      !cmSystemTools::RepeatedRemoveDirectory(previous.c_str())) {
+    cmCPackLogger(cmCPackLog::LOG_ERROR,
+                  "Problem removing previous install directory: "
+                    << previous << std::endl);
+    return 0;
+  }
+  std::string const installDirectory =
+    this->GetOption("CPACK_TEMPORARY_INSTALL_DIRECTORY");
+  if (!cmSystemTools::FileIsDirectory(installDirectory)) {
+    return 1;
+  }
+  if (!cmSystemTools::RenameFile(installDirectory.c_str(),
+                                 previous.c_str())) {
+    cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem moving "
+                    << installDirectory << " to " << previous << std::endl);
+    return 0;
+  }
+  cmCPackLogger(cmCPackLog::LOG_VERBOSE,
+                "Reuse unchanged files of previous install: " << previous
+                                                              << std::endl);
+  this->PreviousInstallDirectory = previous;
+  return 1;
+}
+
 bool cmCPackGenerator::ReadListFile(const char* moduleName)
 {
   bool retval;
@@ -909,6 +1201,10 @@ int cmCPackGenerator::DoPackage()
     return 0;
   }
 
+  if (!this->PreparePreviousInstall()) {
+    return 0;
+  }
+
   if (cmSystemTools::IsOn(
         this->GetOption("CPACK_REMOVE_TOPLEVEL_DIRECTORY"))) {
     const char* toplevelDirectory =
@@ -927,7 +1223,13 @@ int cmCPackGenerator::DoPackage()
   cmCPackLogger(cmCPackLog::LOG_DEBUG, "About to install project "
                   << std::endl);
 
-  if (!this->InstallProject()) {
+  int const installed = this->InstallProject();
+  if (!this->PreviousInstallDirectory.empty()) {
+    cmSystemTools::RepeatedRemoveDirectory(
+      this->PreviousInstallDirectory.c_str());
+    this->PreviousInstallDirectory.clear();
+  }
+  if (!installed) {
     return 0;
   }
   cmCPackLogger(cmCPackLog::LOG_DEBUG, "Done install project " << std::endl);
@@ -1205,6 +1507,80 @@ cmInstalledFile const* cmCPackGenerator::GetInstalledFile(
   return cm->GetInstalledFile(name);
 }
 
+unsigned int cmCPackGenerator::GetThreadCount() const
+{
+  unsigned long threads = 1;
+  std::string const value = this->GetOption("CPACK_THREADS")
+    ? this->GetOption("CPACK_THREADS")
+    : "";
+  if (!value.empty() &&
+      (value.find_first_not_of("0123456789") != std::string::npos ||
+       !cmSystemTools::StringToULong(value.c_str(), &threads))) {
+    cmCPackLogger(cmCPackLog::LOG_WARNING,
+                  "Ignoring invalid CPACK_THREADS value: " << value
+                                                           << std::endl);
+    threads = 1;
+  }
+  // Compressors keep several blocks in flight per thread.
+  unsigned long const limit = 4ul * cmWorkerPool::GetHardwareThreadCount();
+  return static_cast<unsigned int>(std::min(threads, limit));
+}
+
+cmCPackGenerator::PackageJob::PackageJob(cmCPackLog* logger,
+                                         std::string const& name)
+  : Logger(logger)
+  , Name(name)
+  , Threads(1)
+  , Result(0)
+  , Time(0)
+{
+}
+
+void cmCPackGenerator::PackageJob::Process()
+{
+  double const start = cmSystemTools::GetTime();
+  this->Result = this->Package();
+  this->Time = cmSystemTools::GetTime() - start;
+}
+
+int cmCPackGenerator::PackageConcurrently(
+  std::vector<PackageJob*> const& jobs)
+{
+  unsigned int threads = this->GetThreadCount();
+  if (threads == 0) {
+    threads = cmWorkerPool::GetHardwareThreadCount();
+  }
+  unsigned int packages = threads;
+  if (packages > jobs.size()) {
+    packages = static_cast<unsigned int>(jobs.size());
+  }
+  for (std::vector<PackageJob*>::const_iterator ji = jobs.begin();
+       ji != jobs.end(); ++ji) {
+    (*ji)->Threads = packages > 1 ? threads / packages : threads;
+  }
+
+  {
+    // Switching the process locale is not thread-safe.  Switch it once
+    // for all jobs; their archives are told not to switch it again.
+    cmLocaleRAII localeRAII;
+    static_cast<void>(localeRAII);
+    cmWorkerPool pool(packages > 0 ? packages : 1);
+    std::vector<cmWorkerPool::Job*> const poolJobs(jobs.begin(), jobs.end());
+    pool.Process(poolJobs);
+  }
+
+  int result = 1;
+  for (std::vector<PackageJob*>::const_iterator ji = jobs.begin();
+       ji != jobs.end(); ++ji) {
+    cmCPackLogger(cmCPackLog::LOG_VERBOSE,
+                  "Packaged " << (*ji)->Name << " in " << std::fixed
+                              << std::setprecision(2) << (*ji)->Time
+                              << " s" << std::endl);
+    result &= (*ji)->Result;
+  }
+  return result;
+}
+
 int cmCPackGenerator::PrepareGroupingKind()
 {
   // find a component package method specified by the user
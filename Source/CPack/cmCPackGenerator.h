@@ -12,6 +12,7 @@
 
 #include "cmCPackComponentGroup.h"
 #include "cmSystemTools.h"
+#include "cmWorkerPool.h"
 
 class cmCPackLog;
 class cmInstalledFile;
@@ -104,6 +105,49 @@ protected:
 
   cmInstalledFile const* GetInstalledFile(std::string const& name) const;
 
+  /**
+   * Return the number of threads to compress packages with as given by
+   * CPACK_THREADS.  Zero selects the number of hardware threads.
+   */
+  unsigned int GetThreadCount() const;
+
+  /** \class PackageJob
+   * \brief One of several packages built concurrently.
+   *
+   * Generator options cannot be read from several threads, so a job
+   * gets everything it needs up front and logs through its own Logger.
+   * PackageConcurrently holds the process locale while jobs run, so
+   * archives written by a job must not switch it themselves.
+   */
+  class PackageJob : public cmWorkerPool::Job
+  {
+  public:
+    PackageJob(cmCPackLog* logger, std::string const& name);
+
+    /**
+     * Build the package.
+     * @return 0 if error.
+     */
+    virtual int Package() = 0;
+
+    void Process() CM_OVERRIDE;
+
+    cmCPackLog* Logger;
+    std::string Name;
+    //! Number of threads the package may be compressed with
+    unsigned int Threads;
+    int Result;
+    double Time;
+  };
+
+  /**
+   * Build independent packages on up to CPACK_THREADS threads.  Threads
+   * left over are shared out for compressing the packages.  The time
+   * each package took is logged in the order of the jobs.
+   * @return 0 if a package failed.
+   */
+  int PackageConcurrently(std::vector<PackageJob*> const& jobs);
+
   virtual const char* GetOutputExtension() { return ".cpack"; }
   virtual const char* GetOutputPostfix() { return CM_NULLPTR; }
 
@@ -172,6 +216,48 @@ protected:
   virtual int InstallProjectViaInstallCMakeProjects(
     bool setDestDir, const std::string& tempInstallDirectory);
 
+  /** \class ComponentInstall
+   * \brief One run of the cmake_install.cmake script of a project.
+   */
+  struct ComponentInstall
+  {
+    ComponentInstall();
+
+    std::string Component;
+    //! Directory the component is installed into
+    std::string Directory;
+    //! DESTDIR for the installation, if it uses one
+    std::string DestDir;
+    //! Variables the install script is run with
+    std::vector<std::pair<std::string, std::string> > Definitions;
+    //! Whether to find the files the installation adds to Directory
+    bool ListFiles;
+
+    std::vector<std::string> Files;
+    std::string AbsoluteDestinationFiles;
+    std::string Output;
+    bool Result;
+  };
+
+  //! Run an installation in this process
+  void InstallComponent(ComponentInstall& install,
+                        std::string const& installFile);
+
+  /**
+   * Run installations on up to CPACK_THREADS threads, each in its own
+   * cmake process.  Installations into the same directory still run
+   * one after another so the files of each can be found.
+   */
+  void InstallComponentsConcurrently(std::vector<ComponentInstall>& installs,
+                                     std::string const& installDirectory,
+                                     std::string const& installFile);
+
+  /**
+   * Move the previous installation aside for CPACK_INCREMENTAL_INSTALL.
+   * @return 0 if error.
+   */
+  int PreparePreviousInstall();
+
   /**
    * The various level of support of
    * CPACK_SET_DESTDIR used by the generator.
@@ -258,6 +344,12 @@ protected:
    */
   std::vector<std::string> files;
 
+  /**
+   * Where the previous installation was moved to while the project is
+   * installed again, if CPACK_INCREMENTAL_INSTALL is on.
+   */
+  std::string PreviousInstallDirectory;
+
   std::map<std::string, cmCPackInstallationType> InstallationTypes;
   /**
    * The set of components.
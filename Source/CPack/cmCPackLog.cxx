@@ -21,11 +21,17 @@ cmCPackLog::cmCPackLog()
 
   this->LogOutput = CM_NULLPTR;
   this->LogOutputCleanup = false;
+#ifdef CMAKE_USE_LIBUV
+  uv_mutex_init(&this->Mutex);
+#endif
 }
 
 cmCPackLog::~cmCPackLog()
 {
   this->SetLogOutputStream(CM_NULLPTR);
+#ifdef CMAKE_USE_LIBUV
+  uv_mutex_destroy(&this->Mutex);
+#endif
 }
 
 void cmCPackLog::SetLogOutputStream(std::ostream* os)
@@ -57,6 +63,18 @@ bool cmCPackLog::SetLogOutputFile(const char* fname)
 
 void cmCPackLog::Log(int tag, const char* file, int line, const char* msg,
                      size_t length)
+{
+#ifdef CMAKE_USE_LIBUV
+  uv_mutex_lock(&this->Mutex);
+#endif
+  this->LogUnlocked(tag, file, line, msg, length);
+#ifdef CMAKE_USE_LIBUV
+  uv_mutex_unlock(&this->Mutex);
+#endif
+}
+
+void cmCPackLog::LogUnlocked(int tag, const char* file, int line,
+                             const char* msg, size_t length)
 {
   // By default no logging
   bool display = false;
@@ -9,6 +9,10 @@
 #include <string.h>
 #include <string>
 
+#ifdef CMAKE_USE_LIBUV
+#include "cm_uv.h"
+#endif
+
 #define cmCPack_Log(ctSelf, logType, msg)                                     \
   do {                                                                        \
     std::ostringstream cmCPackLog_msg;                                        \
@@ -93,6 +97,9 @@ public:
   void SetErrorPrefix(std::string const& pfx) { this->ErrorPrefix = pfx; }
 
 private:
+  void LogUnlocked(int tag, const char* file, int line, const char* msg,
+                   size_t length);
+
   bool Verbose;
   bool Debug;
   bool Quiet;
@@ -115,6 +122,11 @@ private:
   std::ostream* LogOutput;
   // Do we need to cleanup log output stream
   bool LogOutputCleanup;
+
+#ifdef CMAKE_USE_LIBUV
+  // Packages may be built and log concurrently
+  uv_mutex_t Mutex;
+#endif
 };
 
 class cmCPackLogWrite
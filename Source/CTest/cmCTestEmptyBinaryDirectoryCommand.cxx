@@ -3,6 +3,7 @@
 #include "cmCTestEmptyBinaryDirectoryCommand.h"
 
 #include "cmCTestScriptHandler.h"
+#include "cmPathCache.h"
 
 #include <sstream>
 
@@ -16,7 +17,10 @@ bool cmCTestEmptyBinaryDirectoryCommand::InitialPass(
     return false;
   }
 
-  if (!cmCTestScriptHandler::EmptyBinaryDirectory(args[0].c_str())) {
+  bool const emptied =
+    cmCTestScriptHandler::EmptyBinaryDirectory(args[0].c_str());
+  cmPathCache::InvalidateTree(args[0]);
+  if (!emptied) {
     std::ostringstream ostr;
     ostr << "problem removing the binary directory: " << args[0];
     this->SetError(ostr.str());
@@ -5,6 +5,7 @@
 #include "cmCTest.h"
 #include "cmCTestGenericHandler.h"
 #include "cmMakefile.h"
+#include "cmPathCache.h"
 #include "cmSystemTools.h"
 #include "cmWorkingDirectory.h"
 #include "cmake.h"
@@ -220,6 +221,8 @@ bool cmCTestHandlerCommand::InitialPass(std::vector<std::string> const& args,
   cmWorkingDirectory workdir(
     this->CTest->GetCTestConfiguration("BuildDirectory"));
   int res = handler->ProcessHandler();
+  // Builds, tests and updates may have created or removed any file.
+  cmPathCache::InvalidateFileSystem();
   if (this->Values[ct_RETURN_VALUE] && *this->Values[ct_RETURN_VALUE]) {
     std::ostringstream str;
     str << res;
@@ -6,6 +6,7 @@
 #include "cmCTestVC.h"
 #include "cmGeneratedFileStream.h"
 #include "cmMakefile.h"
+#include "cmPathCache.h"
 #include "cmSystemTools.h"
 
 #include <sstream>
@@ -149,7 +150,10 @@ bool cmCTestStartCommand::InitialCheckout(std::ostream& ofs,
     // Use a generic VC object to run and log the command.
     cmCTestVC vc(this->CTest, ofs);
     vc.SetSourceDirectory(sourceDir);
-    if (!vc.InitialCheckout(initialCheckoutCommand)) {
+    bool const checkedOut = vc.InitialCheckout(initialCheckoutCommand);
+    // The command may have created or removed any file.
+    cmPathCache::InvalidateFileSystem();
+    if (!checkedOut) {
       return false;
     }
   }
@@ -2,16 +2,29 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmArchiveWrite.h"
 
+#include "cmAlgorithms.h"
 #include "cmLocale.h"
 #include "cmSystemTools.h"
+#include "cmWorkerPool.h"
 #include "cm_get_date.h"
 #include "cm_libarchive.h"
+#include "cm_zlib.h"
 #include "cmsys/Directory.hxx"
 #include "cmsys/Encoding.hxx"
 #include "cmsys/FStream.hxx"
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 #include <string.h>
 #include <time.h>
+#include <vector>
+
+// The bundled libarchive comes with liblzma.  A system libarchive uses
+// the multi-threaded encoder of its own liblzma if it has one.
+#if !defined(CMAKE_USE_SYSTEM_LIBARCHIVE)
+#define CM_ARCHIVE_WRITE_BLOCK_XZ
+#include "cm_lzma.h"
+#endif
 
 #ifndef __LA_SSIZE_T
 #define __LA_SSIZE_T la_ssize_t
@@ -56,6 +69,450 @@ public:
   operator struct archive_entry*() { return this->Object; }
 };
 
+/** \class cmArchiveWriteCompressor
+ * \brief Compress the archive stream in independent blocks on a worker pool.
+ *
+ * Blocks are compressed a batch at a time and written in order.  Block
+ * boundaries depend only on the input, so the output does not depend on
+ * the number of threads.  Subclasses write a single stream of their
+ * format that standard tools decompress as usual.
+ */
+class cmArchiveWriteCompressor
+{
+  CM_DISABLE_COPY(cmArchiveWriteCompressor)
+
+public:
+  virtual ~cmArchiveWriteCompressor() { cmDeleteAll(this->Blocks); }
+
+  /** Compress data that follows the data given so far.  After an error
+      this and Finish() do nothing and fail.  */
+  bool Write(const char* data, size_t size);
+
+  /** Compress the remaining data and end the stream.  Later calls
+      return the result of the first.  */
+  bool Finish();
+
+  std::string const& GetError() const { return this->Error; }
+
+protected:
+  class Block : public cmWorkerPool::Job
+  {
+  public:
+    Block()
+      : Last(false)
+    {
+    }
+
+    std::string Input;
+    std::vector<char> Output;
+    std::string Error;
+    bool Last;
+  };
+
+  cmArchiveWriteCompressor(std::ostream& os, size_t blockSize,
+                           unsigned int threads, size_t batchSize)
+    : Stream(os)
+    , Pool(threads)
+    , BlockSize(blockSize)
+    , BatchSize(batchSize)
+    , Current(0)
+    , Started(false)
+    , Finished(false)
+    , Failed(false)
+  {
+  }
+
+  virtual Block* NewBlock() = 0;
+  virtual std::string GetHeader() = 0;
+  virtual std::string GetTrailer() = 0;
+
+  /** Called in stream order before a block is compressed.  */
+  virtual void PrepareBlock(Block& /*block*/) {}
+
+  /** Called in stream order after a block has been compressed.  */
+  virtual bool FinishBlock(Block& block) = 0;
+
+  std::string Error;
+
+private:
+  Block* GetCurrentBlock();
+  bool Flush(size_t count, bool last);
+  bool FlushBatch(size_t count, bool last);
+  bool WriteOutput(const char* data, size_t size);
+
+  std::ostream& Stream;
+  cmWorkerPool Pool;
+  size_t const BlockSize;
+  size_t const BatchSize;
+  std::vector<Block*> Blocks;
+  size_t Current;
+  bool Started;
+  bool Finished;
+  bool Failed;
+};
+
+bool cmArchiveWriteCompressor::Write(const char* data, size_t size)
+{
+  if (this->Failed || this->Finished) {
+    return false;
+  }
+  while (size > 0) {
+    Block* block = this->GetCurrentBlock();
+    size_t const n = std::min(size, this->BlockSize - block->Input.size());
+    block->Input.append(data, n);
+    data += n;
+    size -= n;
+    if (block->Input.size() == this->BlockSize &&
+        ++this->Current == this->BatchSize &&
+        !this->Flush(this->Current, false)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool cmArchiveWriteCompressor::Finish()
+{
+  if (this->Failed || this->Finished) {
+    return !this->Failed;
+  }
+  this->Finished = true;
+  // The current block is the last one even if it is empty.
+  this->GetCurrentBlock();
+  if (!this->Flush(this->Current + 1, true)) {
+    return false;
+  }
+  std::string const trailer = this->GetTrailer();
+  if (!this->Error.empty() ||
+      !this->WriteOutput(trailer.data(), trailer.size())) {
+    this->Failed = true;
+    return false;
+  }
+  return true;
+}
+
+cmArchiveWriteCompressor::Block* cmArchiveWriteCompressor::GetCurrentBlock()
+{
+  if (this->Blocks.empty()) {
+    for (size_t i = 0; i < this->BatchSize; ++i) {
+      this->Blocks.push_back(this->NewBlock());
+    }
+  }
+  return this->Blocks[this->Current];
+}
+
+bool cmArchiveWriteCompressor::Flush(size_t count, bool last)
+{
+  bool const okay = this->FlushBatch(count, last);
+  // The batch is done either way.  After a failure no more output may
+  // be written, so drop the blocks and refuse further data.
+  this->Current = 0;
+  if (!okay) {
+    this->Failed = true;
+    cmDeleteAll(this->Blocks);
+    this->Blocks.clear();
+  }
+  return okay;
+}
+
+bool cmArchiveWriteCompressor::FlushBatch(size_t count, bool last)
+{
+  if (!this->Started) {
+    this->Started = true;
+    std::string const header = this->GetHeader();
+    if (!this->Error.empty() ||
+        !this->WriteOutput(header.data(), header.size())) {
+      return false;
+    }
+  }
+
+  std::vector<cmWorkerPool::Job*> jobs;
+  for (size_t i = 0; i < count; ++i) {
+    Block* block = this->Blocks[i];
+    block->Last = last && i + 1 == count;
+    this->PrepareBlock(*block);
+    jobs.push_back(block);
+  }
+  this->Pool.Process(jobs);
+
+  for (size_t i = 0; i < count; ++i) {
+    Block* block = this->Blocks[i];
+    if (!block->Error.empty()) {
+      this->Error = block->Error;
+      return false;
+    }
+    if (!this->FinishBlock(*block) ||
+        (!block->Output.empty() &&
+         !this->WriteOutput(&block->Output[0], block->Output.size()))) {
+      return false;
+    }
+    block->Input.clear();
+    block->Output.clear();
+  }
+  return true;
+}
+
+bool cmArchiveWriteCompressor::WriteOutput(const char* data, size_t size)
+{
+  if (!this->Stream.write(data, static_cast<std::streamsize>(size))) {
+    this->Error = "Cannot write compressed archive data: ";
+    this->Error += cmSystemTools::GetLastSystemError();
+    return false;
+  }
+  return true;
+}
+
+namespace {
+
+/* Write a single gzip member the way pigz does.  Each block is a raw
+   deflate stream primed with the last 32 KiB of the preceding input and
+   ended by a sync flush, so the compressed blocks can be concatenated.  */
+class cmArchiveWriteGZip : public cmArchiveWriteCompressor
+{
+public:
+  cmArchiveWriteGZip(std::ostream& os, unsigned int threads)
+    : cmArchiveWriteCompressor(os, 128 * 1024, threads, 4 * threads)
+    , Crc(crc32(0L, Z_NULL, 0))
+    , Size(0)
+  {
+  }
+
+private:
+  enum
+  {
+    DictionarySize = 32 * 1024
+  };
+
+  class GZipBlock : public Block
+  {
+  public:
+    void Process() CM_OVERRIDE;
+
+    std::string Dictionary;
+    uLong Crc;
+  };
+
+  Block* NewBlock() CM_OVERRIDE { return new GZipBlock; }
+  std::string GetHeader() CM_OVERRIDE;
+  std::string GetTrailer() CM_OVERRIDE;
+  void PrepareBlock(Block& block) CM_OVERRIDE;
+  bool FinishBlock(Block& block) CM_OVERRIDE;
+
+  std::string Dictionary;
+  uLong Crc;
+  unsigned long Size;
+};
+
+void cmArchiveWriteGZip::GZipBlock::Process()
+{
+  Bytef* in = reinterpret_cast<Bytef*>(const_cast<char*>(this->Input.data()));
+  uInt const inSize = static_cast<uInt>(this->Input.size());
+  this->Crc = crc32(crc32(0L, Z_NULL, 0), in, inSize);
+
+  z_stream strm;
+  memset(&strm, 0, sizeof(strm));
+  if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    this->Error = "deflateInit2 failed";
+    return;
+  }
+  if (!this->Dictionary.empty()) {
+    deflateSetDictionary(
+      &strm,
+      reinterpret_cast<Bytef*>(const_cast<char*>(this->Dictionary.data())),
+      static_cast<uInt>(this->Dictionary.size()));
+  }
+
+  // Leave room for the empty stored block of a sync flush.
+  this->Output.resize(deflateBound(&strm, inSize) + 16);
+  strm.next_in = in;
+  strm.avail_in = inSize;
+  int const flush = this->Last ? Z_FINISH : Z_SYNC_FLUSH;
+  size_t done = 0;
+  int result;
+  do {
+    if (done == this->Output.size()) {
+      this->Output.resize(this->Output.size() * 2);
+    }
+    strm.next_out = reinterpret_cast<Bytef*>(&this->Output[done]);
+    strm.avail_out = static_cast<uInt>(this->Output.size() - done);
+    result = deflate(&strm, flush);
+    done = this->Output.size() - strm.avail_out;
+  } while (result == Z_OK && strm.avail_out == 0);
+  deflateEnd(&strm);
+  this->Output.resize(done);
+
+  // After a sync flush that exactly filled the buffer the next call
+  // has nothing left to do and reports Z_BUF_ERROR.
+  if (this->Last ? result != Z_STREAM_END
+                 : (result != Z_OK && result != Z_BUF_ERROR)) {
+    this->Error = "deflate failed";
+  }
+}
+
+std::string cmArchiveWriteGZip::GetHeader()
+{
+  // Deflate method, no flags, no modification time, Unix.
+  static const char header[] = { '\x1f', '\x8b', '\x08', '\x00', '\x00',
+                                 '\x00', '\x00', '\x00', '\x00', '\x03' };
+  return std::string(header, sizeof(header));
+}
+
+std::string cmArchiveWriteGZip::GetTrailer()
+{
+  std::string trailer;
+  unsigned long const values[] = { this->Crc, this->Size };
+  for (size_t v = 0; v < 2; ++v) {
+    for (int i = 0; i < 4; ++i) {
+      trailer += static_cast<char>((values[v] >> (8 * i)) & 0xff);
+    }
+  }
+  return trailer;
+}
+
+void cmArchiveWriteGZip::PrepareBlock(Block& block)
+{
+  static_cast<GZipBlock&>(block).Dictionary = this->Dictionary;
+  this->Dictionary += block.Input;
+  if (this->Dictionary.size() > DictionarySize) {
+    this->Dictionary.erase(0, this->Dictionary.size() - DictionarySize);
+  }
+}
+
+bool cmArchiveWriteGZip::FinishBlock(Block& block)
+{
+  this->Crc = crc32_combine(this->Crc, static_cast<GZipBlock&>(block).Crc,
+                            static_cast<z_off_t>(block.Input.size()));
+  // The size in the trailer is taken modulo 2^32.
+  this->Size = (this->Size + block.Input.size()) & 0xffffffffUL;
+  return true;
+}
+
+#ifdef CM_ARCHIVE_WRITE_BLOCK_XZ
+/* Write a single xz stream the way "xz --threads" does.  Each block is
+   compressed independently and recorded in the index at the end.  */
+class cmArchiveWriteXZ : public cmArchiveWriteCompressor
+{
+public:
+  cmArchiveWriteXZ(std::ostream& os, unsigned int threads)
+    : cmArchiveWriteCompressor(os, GetBlockSize(), threads, threads)
+    , Index(lzma_index_init(CM_NULLPTR))
+  {
+    memset(&this->Flags, 0, sizeof(this->Flags));
+    this->Flags.version = 0;
+    this->Flags.check = LZMA_CHECK_CRC64;
+  }
+
+  ~cmArchiveWriteXZ() CM_OVERRIDE { lzma_index_end(this->Index, CM_NULLPTR); }
+
+private:
+  class XZBlock : public Block
+  {
+  public:
+    void Process() CM_OVERRIDE;
+
+    lzma_vli UnpaddedSize;
+  };
+
+  // Use three times the dictionary size like xz does.
+  static size_t GetBlockSize()
+  {
+    lzma_options_lzma options;
+    lzma_lzma_preset(&options, LZMA_PRESET_DEFAULT);
+    return 3 * static_cast<size_t>(options.dict_size);
+  }
+
+  Block* NewBlock() CM_OVERRIDE { return new XZBlock; }
+  std::string GetHeader() CM_OVERRIDE;
+  std::string GetTrailer() CM_OVERRIDE;
+  bool FinishBlock(Block& block) CM_OVERRIDE;
+
+  lzma_stream_flags Flags;
+  lzma_index* Index;
+};
+
+void cmArchiveWriteXZ::XZBlock::Process()
+{
+  // An empty stream has no blocks.
+  if (this->Input.empty()) {
+    return;
+  }
+
+  lzma_options_lzma options;
+  if (lzma_lzma_preset(&options, LZMA_PRESET_DEFAULT)) {
+    this->Error = "lzma_lzma_preset failed";
+    return;
+  }
+  lzma_filter filters[2];
+  filters[0].id = LZMA_FILTER_LZMA2;
+  filters[0].options = &options;
+  filters[1].id = LZMA_VLI_UNKNOWN;
+  filters[1].options = CM_NULLPTR;
+
+  lzma_block block;
+  memset(&block, 0, sizeof(block));
+  block.version = 0;
+  block.check = LZMA_CHECK_CRC64;
+  block.filters = filters;
+
+  this->Output.resize(lzma_block_buffer_bound(this->Input.size()));
+  size_t done = 0;
+  if (lzma_block_buffer_encode(
+        &block, CM_NULLPTR,
+        reinterpret_cast<const uint8_t*>(this->Input.data()),
+        this->Input.size(), reinterpret_cast<uint8_t*>(&this->Output[0]),
+        &done, this->Output.size()) != LZMA_OK) {
+    this->Error = "lzma_block_buffer_encode failed";
+    return;
+  }
+  this->Output.resize(done);
+  this->UnpaddedSize = lzma_block_unpadded_size(&block);
+}
+
+std::string cmArchiveWriteXZ::GetHeader()
+{
+  uint8_t header[LZMA_STREAM_HEADER_SIZE];
+  if (!this->Index) {
+    this->Error = "lzma_index_init failed";
+  } else if (lzma_stream_header_encode(&this->Flags, header) != LZMA_OK) {
+    this->Error = "lzma_stream_header_encode failed";
+  }
+  return std::string(reinterpret_cast<char*>(header), sizeof(header));
+}
+
+std::string cmArchiveWriteXZ::GetTrailer()
+{
+  lzma_vli const indexSize = lzma_index_size(this->Index);
+  std::vector<uint8_t> trailer(
+    static_cast<size_t>(indexSize + LZMA_STREAM_HEADER_SIZE));
+  size_t done = 0;
+  this->Flags.backward_size = indexSize;
+  if (lzma_index_buffer_encode(this->Index, &trailer[0], &done,
+                               trailer.size()) != LZMA_OK ||
+      lzma_stream_footer_encode(&this->Flags, &trailer[done]) != LZMA_OK) {
+    this->Error = "Cannot encode xz stream index";
+    return std::string();
+  }
+  return std::string(reinterpret_cast<char*>(&trailer[0]), trailer.size());
+}
+
+bool cmArchiveWriteXZ::FinishBlock(Block& block)
+{
+  if (block.Input.empty()) {
+    return true;
+  }
+  if (!this->Index ||
+      lzma_index_append(this->Index, CM_NULLPTR,
+                        static_cast<XZBlock&>(block).UnpaddedSize,
+                        block.Input.size()) != LZMA_OK) {
+    this->Error = "lzma_index_append failed";
+    return false;
+  }
+  return true;
+}
+#endif
+}
+
 struct cmArchiveWrite::Callback
 {
   // archive_write_callback
@@ -63,6 +520,11 @@ struct cmArchiveWrite::Callback
                             const void* b, size_t n)
   {
     cmArchiveWrite* self = static_cast<cmArchiveWrite*>(cd);
+    if (self->Compressor) {
+      return self->Compressor->Write(static_cast<const char*>(b), n)
+        ? static_cast<__LA_SSIZE_T>(n)
+        : static_cast<__LA_SSIZE_T>(-1);
+    }
     if (self->Stream.write(static_cast<const char*>(b),
                            static_cast<std::streamsize>(n))) {
       return static_cast<__LA_SSIZE_T>(n);
@@ -72,13 +534,36 @@ struct cmArchiveWrite::Callback
 };
 
 cmArchiveWrite::cmArchiveWrite(std::ostream& os, Compress c,
-                               std::string const& format)
+                               std::string const& format, unsigned int threads)
   : Stream(os)
+  , Compressor(CM_NULLPTR)
   , Archive(archive_write_new())
   , Disk(archive_read_disk_new())
   , Verbose(false)
+  , Closed(false)
+  , LocaleHeld(false)
   , Format(format)
 {
+  unsigned int const hardware = cmWorkerPool::GetHardwareThreadCount();
+  if (threads == 0) {
+    threads = hardware;
+  }
+  // Each thread keeps several blocks in flight.
+  threads = std::min(threads, 4 * hardware);
+  // Compress blocks of the archive stream on our own worker pool.
+  if (threads > 1) {
+    if (c == CompressGZip) {
+      this->Compressor = new cmArchiveWriteGZip(os, threads);
+#ifdef CM_ARCHIVE_WRITE_BLOCK_XZ
+    } else if (c == CompressXZ) {
+      this->Compressor = new cmArchiveWriteXZ(os, threads);
+#endif
+    }
+    if (this->Compressor) {
+      c = CompressNone;
+    }
+  }
+
   switch (c) {
     case CompressNone:
       if (archive_write_add_filter_none(this->Archive) != ARCHIVE_OK) {
@@ -121,6 +606,13 @@ cmArchiveWrite::cmArchiveWrite(std::ostream& os, Compress c,
         this->Error += cm_archive_error_string(this->Archive);
         return;
       }
+      if (threads > 1) {
+        // Ignore the warning of a libarchive without threaded encoder.
+        std::ostringstream value;
+        value << threads;
+        archive_write_set_filter_option(this->Archive, "xz", "threads",
+                                        value.str().c_str());
+      }
       break;
   };
 #if !defined(_WIN32) || defined(__CYGWIN__)
@@ -157,8 +649,35 @@ cmArchiveWrite::cmArchiveWrite(std::ostream& os, Compress c,
 
 cmArchiveWrite::~cmArchiveWrite()
 {
+  this->Close();
   archive_read_free(this->Disk);
   archive_write_free(this->Archive);
+  delete this->Compressor;
+}
+
+bool cmArchiveWrite::Close()
+{
+  if (this->Closed) {
+    return this->Okay();
+  }
+  this->Closed = true;
+  if (archive_write_close(this->Archive) != ARCHIVE_OK && this->Okay()) {
+    this->Error = "archive_write_close: ";
+    this->Error += cm_archive_error_string(this->Archive);
+  }
+  // An error of our compressor explains a failed write callback best.
+  if (this->Compressor && !this->Compressor->Finish()) {
+    this->Error = this->Compressor->GetError();
+    if (this->Error.empty()) {
+      this->Error = "Cannot write compressed archive data.";
+    }
+  }
+  // Buffered output may fail only now.
+  if (this->Okay() && !this->Stream.flush()) {
+    this->Error = "Cannot write archive data: ";
+    this->Error += cmSystemTools::GetLastSystemError();
+  }
+  return this->Okay();
 }
 
 bool cmArchiveWrite::Add(std::string path, size_t skip, const char* prefix,
@@ -212,9 +731,17 @@ bool cmArchiveWrite::AddFile(const char* file, size_t skip, const char* prefix)
   }
   const char* out = file + skip;
 
+  if (this->LocaleHeld) {
+    return this->AddFileInLocale(file, out, prefix);
+  }
   cmLocaleRAII localeRAII;
   static_cast<void>(localeRAII);
+  return this->AddFileInLocale(file, out, prefix);
+}
 
+bool cmArchiveWrite::AddFileInLocale(const char* file, const char* out,
+                                     const char* prefix)
+{
   // Meta-data.
   std::string dest = prefix ? prefix : "";
   dest += out;
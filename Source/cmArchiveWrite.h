@@ -13,6 +13,8 @@
 #error "cmArchiveWrite not allowed during bootstrap build!"
 #endif
 
+class cmArchiveWriteCompressor;
+
 template <typename T>
 class cmArchiveWriteOptional
 {
@@ -53,9 +55,11 @@ public:
     CompressXZ
   };
 
-  /** Construct with output stream to which to write archive.  */
+  /** Construct with output stream to which to write archive.  GZip and
+      XZ compression use up to the given number of threads; zero selects
+      the number of hardware threads.  */
   cmArchiveWrite(std::ostream& os, Compress c = CompressNone,
-                 std::string const& format = "paxr");
+                 std::string const& format = "paxr", unsigned int threads = 1);
 
   ~cmArchiveWrite();
 
@@ -70,6 +74,14 @@ public:
   bool Add(std::string path, size_t skip = 0, const char* prefix = CM_NULLPTR,
            bool recursive = true);
 
+  /**
+   * Write the end of the archive and of its compressed stream.  The
+   * destructor does this too but cannot report errors, and the last
+   * part of a compressed stream may be large, so call this to know
+   * whether the whole archive was written.  Nothing may be added after.
+   */
+  bool Close();
+
   /** Returns true if there has been no error.  */
   operator safe_bool() const
   {
@@ -88,6 +100,11 @@ public:
 
   void SetMTime(std::string const& t) { this->MTime = t; }
 
+  //! Do not switch the process locale around each added file because
+  //! the caller holds it already.  Switching it is not thread-safe, so
+  //! archives written on several threads at once must not do it.
+  void SetLocaleHeld(bool held) { this->LocaleHeld = held; }
+
   //! Sets the permissions of the added files/folders
   void SetPermissions(int permissions_)
   {
@@ -144,6 +161,8 @@ private:
   bool AddPath(const char* path, size_t skip, const char* prefix,
                bool recursive = true);
   bool AddFile(const char* file, size_t skip, const char* prefix);
+  bool AddFileInLocale(const char* file, const char* out,
+                       const char* prefix);
   bool AddData(const char* file, size_t size);
 
   struct Callback;
@@ -152,9 +171,12 @@ private:
   class Entry;
 
   std::ostream& Stream;
+  cmArchiveWriteCompressor* Compressor;
   struct archive* Archive;
   struct archive* Disk;
   bool Verbose;
+  bool Closed;
+  bool LocaleHeld;
   std::string Format;
   std::string Error;
   std::string MTime;
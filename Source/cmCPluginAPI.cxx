@@ -421,11 +421,13 @@ int CCONV cmExecuteCommand(void* arg, const char* name, int numArgs,
   cmMakefile* mf = static_cast<cmMakefile*>(arg);
   cmListFileFunction lff;
   lff.Name = name;
+  std::vector<cmListFileArgument> lffArgs;
   for (int i = 0; i < numArgs; ++i) {
     // Assume all arguments are quoted.
-    lff.Arguments.push_back(
+    lffArgs.push_back(
       cmListFileArgument(args[i], cmListFileArgument::Quoted, 0));
   }
+  lff.SetArguments(lffArgs);
   cmExecutionStatus status;
   return mf->ExecuteCommand(lff, status);
 }
@@ -253,7 +253,7 @@ cmComputeLinkDepends::Compute()
   // Compute the final set of link entries.
   // Iterate in reverse order so we can keep only the last occurrence
   // of a shared library.
-  std::set<int> emmitted;
+  std::vector<bool> emmitted(this->EntryList.size(), false);
   for (std::vector<int>::const_reverse_iterator
          li = this->FinalLinkOrder.rbegin(),
          le = this->FinalLinkOrder.rend();
@@ -263,7 +263,8 @@ cmComputeLinkDepends::Compute()
     cmGeneratorTarget const* t = e.Target;
     // Entries that we know the linker will re-use do not need to be repeated.
     bool uniquify = t && t->GetType() == cmStateEnums::SHARED_LIBRARY;
-    if (!uniquify || emmitted.insert(i).second) {
+    if (!uniquify || !emmitted[i]) {
+      emmitted[i] = true;
       this->FinalLinkEntries.push_back(e);
     }
   }
@@ -278,14 +279,15 @@ cmComputeLinkDepends::Compute()
   return this->FinalLinkEntries;
 }
 
-std::map<std::string, int>::iterator cmComputeLinkDepends::AllocateLinkEntry(
-  std::string const& item)
+cmComputeLinkDepends::LinkEntryIndexType::iterator
+cmComputeLinkDepends::AllocateLinkEntry(std::string const& item)
 {
-  std::map<std::string, int>::value_type index_entry(
+  LinkEntryIndexType::value_type index_entry(
     item, static_cast<int>(this->EntryList.size()));
-  std::map<std::string, int>::iterator lei =
+  LinkEntryIndexType::iterator lei =
     this->LinkEntryIndex.insert(index_entry).first;
   this->EntryList.push_back(LinkEntry());
+  this->SharedDepFollowed.push_back(false);
   this->InferredDependSets.push_back(CM_NULLPTR);
   this->EntryConstraintGraph.push_back(EdgeList());
   return lei;
@@ -294,7 +296,7 @@ std::map<std::string, int>::iterator cmComputeLinkDepends::AllocateLinkEntry(
 int cmComputeLinkDepends::AddLinkEntry(cmLinkItem const& item)
 {
   // Check if the item entry has already been added.
-  std::map<std::string, int>::iterator lei = this->LinkEntryIndex.find(item);
+  LinkEntryIndexType::iterator lei = this->LinkEntryIndex.find(item);
   if (lei != this->LinkEntryIndex.end()) {
     // Yes.  We do not need to follow the item's dependencies again.
     return lei->second;
@@ -374,7 +376,8 @@ void cmComputeLinkDepends::FollowSharedDeps(int depender_index,
                                             bool follow_interface)
 {
   // Follow dependencies if we have not followed them already.
-  if (this->SharedDepFollowed.insert(depender_index).second) {
+  if (!this->SharedDepFollowed[depender_index]) {
+    this->SharedDepFollowed[depender_index] = true;
     if (follow_interface) {
       this->QueueSharedDependencies(depender_index, iface->Libraries);
     }
@@ -397,8 +400,7 @@ void cmComputeLinkDepends::QueueSharedDependencies(
 void cmComputeLinkDepends::HandleSharedDependency(SharedDepEntry const& dep)
 {
   // Check if the target already has an entry.
-  std::map<std::string, int>::iterator lei =
-    this->LinkEntryIndex.find(dep.Item);
+  LinkEntryIndexType::iterator lei = this->LinkEntryIndex.find(dep.Item);
   if (lei == this->LinkEntryIndex.end()) {
     // Allocate a spot for the item entry.
     lei = this->AllocateLinkEntry(dep.Item);
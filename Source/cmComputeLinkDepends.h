@@ -8,6 +8,7 @@
 #include "cmGraphAdjacencyList.h"
 #include "cmLinkItem.h"
 #include "cmTargetLinkLibraryType.h"
+#include "cm_unordered_map.hxx"
 
 #include <map>
 #include <queue>
@@ -72,8 +73,8 @@ private:
   std::string Config;
   EntryVector FinalLinkEntries;
 
-  std::map<std::string, int>::iterator AllocateLinkEntry(
-    std::string const& item);
+  typedef CM_UNORDERED_MAP<std::string, int> LinkEntryIndexType;
+  LinkEntryIndexType::iterator AllocateLinkEntry(std::string const& item);
   int AddLinkEntry(cmLinkItem const& item);
   void AddVarLinkEntries(int depender_index, const char* value);
   void AddDirectLinkEntries();
@@ -84,7 +85,7 @@ private:
 
   // One entry for each unique item.
   std::vector<LinkEntry> EntryList;
-  std::map<std::string, int> LinkEntryIndex;
+  LinkEntryIndexType LinkEntryIndex;
 
   // BFS of initial dependencies.
   struct BFSEntry
@@ -104,7 +105,7 @@ private:
     int DependerIndex;
   };
   std::queue<SharedDepEntry> SharedDepQueue;
-  std::set<int> SharedDepFollowed;
+  std::vector<bool> SharedDepFollowed;
   void FollowSharedDeps(int depender_index, cmLinkInterface const* iface,
                         bool follow_interface = false);
   void QueueSharedDependencies(int depender_index,
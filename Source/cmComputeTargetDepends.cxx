@@ -96,6 +96,9 @@ transitively on all the static libraries it links.
 cmComputeTargetDepends::cmComputeTargetDepends(cmGlobalGenerator* gg)
 {
   this->GlobalGenerator = gg;
+  this->HadContextSensitiveCondition = false;
+  this->ConfigEvaluations = 0;
+  this->SharedConfigEvaluations = 0;
   cmake* cm = this->GlobalGenerator->GetCMakeInstance();
   this->DebugMode =
     cm->GetState()->GetGlobalPropertyAsBool("GLOBAL_DEPENDS_DEBUG_MODE");
@@ -113,6 +116,9 @@ bool cmComputeTargetDepends::Compute()
   this->CollectTargets();
   this->CollectDepends();
   if (this->DebugMode) {
+    fprintf(stderr, "Target dependencies were evaluated %u times and "
+                    "reused for %u more configurations.\n\n",
+            this->ConfigEvaluations, this->SharedConfigEvaluations);
     this->DisplayGraph(this->InitialGraph, "initial");
   }
 
@@ -206,6 +212,9 @@ void cmComputeTargetDepends::CollectTargetDepends(int depender_index)
     }
     for (std::vector<std::string>::const_iterator it = configs.begin();
          it != configs.end(); ++it) {
+      ++this->ConfigEvaluations;
+      this->HadContextSensitiveCondition = false;
+
       std::vector<cmSourceFile const*> objectFiles;
       depender->GetExternalObjects(objectFiles, *it);
       for (std::vector<cmSourceFile const*>::const_iterator oi =
@@ -229,6 +238,10 @@ void cmComputeTargetDepends::CollectTargetDepends(int depender_index)
       }
 
       cmLinkImplementation const* impl = depender->GetLinkImplementation(*it);
+      if (impl->HadContextSensitiveCondition ||
+          depender->GetHadContextSensitiveSources()) {
+        this->HadContextSensitiveCondition = true;
+      }
 
       // A target should not depend on itself.
       emitted.insert(depender->GetName());
@@ -241,6 +254,14 @@ void cmComputeTargetDepends::CollectTargetDepends(int depender_index)
           this->AddInterfaceDepends(depender_index, *lib, *it, emitted);
         }
       }
+
+      // If nothing evaluated above depends on the configuration then
+      // the remaining configurations would add the same dependencies.
+      if (!this->HadContextSensitiveCondition) {
+        this->SharedConfigEvaluations +=
+          static_cast<unsigned int>(configs.end() - it - 1);
+        break;
+      }
     }
   }
 
@@ -267,6 +288,9 @@ void cmComputeTargetDepends::AddInterfaceDepends(
   cmGeneratorTarget const* depender = this->Targets[depender_index];
   if (cmLinkInterface const* iface =
         dependee->GetLinkInterface(config, depender)) {
+    if (iface->HadContextSensitiveCondition) {
+      this->HadContextSensitiveCondition = true;
+    }
     for (std::vector<cmLinkItem>::const_iterator lib =
            iface->Libraries.begin();
          lib != iface->Libraries.end(); ++lib) {
@@ -276,6 +300,11 @@ void cmComputeTargetDepends::AddInterfaceDepends(
         this->AddInterfaceDepends(depender_index, *lib, config, emitted);
       }
     }
+  } else if (dependee->IsImported() ||
+             dependee->GetPolicyStatusCMP0022() == cmPolicies::OLD ||
+             dependee->GetPolicyStatusCMP0022() == cmPolicies::WARN) {
+    // The link interface may exist in other configurations.
+    this->HadContextSensitiveCondition = true;
   }
 }
 
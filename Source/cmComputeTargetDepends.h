@@ -60,6 +60,15 @@ private:
   bool DebugMode;
   bool NoCycles;
 
+  // Whether the dependencies collected for the current configuration
+  // may differ in other configurations.
+  bool HadContextSensitiveCondition;
+
+  // Number of per-configuration dependency evaluations made and of
+  // those skipped because another configuration's result was shared.
+  unsigned int ConfigEvaluations;
+  unsigned int SharedConfigEvaluations;
+
   // Collect all targets.
   std::vector<cmGeneratorTarget const*> Targets;
   std::map<cmGeneratorTarget const*, int> TargetIndex;
@@ -12,6 +12,7 @@
 
 #include "cmAlgorithms.h"
 #include "cmMakefile.h"
+#include "cmRegexCache.h"
 #include "cmState.h"
 #include "cmSystemTools.h"
 
@@ -538,7 +539,7 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList& newArgs,
         const char* rex = argP2->c_str();
         this->Makefile.ClearMatches();
         cmsys::RegularExpression regEntry;
-        if (!regEntry.compile(rex)) {
+        if (!cmRegexCache::Compile(regEntry, argP2->GetValue())) {
           std::ostringstream error;
           error << "Regular expression \"" << rex << "\" cannot compile";
           errorString = error.str();
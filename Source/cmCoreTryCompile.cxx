@@ -15,6 +15,7 @@
 #include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmOutputConverter.h"
+#include "cmPathCache.h"
 #include "cmPolicies.h"
 #include "cmState.h"
 #include "cmSystemTools.h"
@@ -845,6 +846,7 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     this->FindOutputFile(targetName, targetType);
 
     if ((res == 0) && !copyFile.empty()) {
+      cmPathCache::InvalidatePath(copyFile);
       if (this->OutputFile.empty() ||
           !cmSystemTools::CopyFileAlways(this->OutputFile, copyFile)) {
         std::ostringstream emsg;
@@ -887,6 +889,7 @@ void cmCoreTryCompile::CleanupFiles(const char* binDir)
       binDir);
     return;
   }
+  cmPathCache::InvalidateTree(bdir);
 
   cmsys::Directory dir;
   dir.Load(binDir);
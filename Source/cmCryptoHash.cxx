@@ -7,6 +7,38 @@
 #include "cmsys/FStream.hxx"
 #include <string.h>
 
+#include "cmAlgorithms.h"
+#include "cmWorkerPool.h"
+
+#ifdef CMAKE_USE_LIBUV
+#include "cm_uv.h"
+#endif
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CM_CRYPTO_HASH_USE_MMAP
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__clang__)
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_ia32_sha256rnds2)
+#define CM_CRYPTO_HASH_USE_SHANI
+#endif
+#endif
+#elif defined(__GNUC__) && __GNUC__ >= 5
+#define CM_CRYPTO_HASH_USE_SHANI
+#endif
+#endif
+
+#ifdef CM_CRYPTO_HASH_USE_SHANI
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
 static unsigned int const cmCryptoHashAlgoToId[] = {
   /* clang-format needs this comment to break after the opening brace */
   RHASH_MD5,      //
@@ -21,25 +53,224 @@ static unsigned int const cmCryptoHashAlgoToId[] = {
   RHASH_SHA3_512
 };
 
+#ifdef CMAKE_USE_LIBUV
+// CPack package jobs and HashFiles create hashes on several threads, so
+// the library is initialized exactly once.
+static uv_once_t cmCryptoHash_rhash_library_once = UV_ONCE_INIT;
+#else
 static int cmCryptoHash_rhash_library_initialized;
+#endif
+
+#ifdef CM_CRYPTO_HASH_USE_SHANI
+// Whether the processor has the SHA extensions.
+static bool cmCryptoHash_shani;
+
+static bool cmCryptoHashDetectSHANI()
+{
+  unsigned int a, b, c, d;
+  if (__get_cpuid_max(0, CM_NULLPTR) < 7 || !__get_cpuid(1, &a, &b, &c, &d)) {
+    return false;
+  }
+  // SSSE3 and SSE4.1
+  if (!(c & (1u << 9)) || !(c & (1u << 19))) {
+    return false;
+  }
+  __cpuid_count(7, 0, a, b, c, d);
+  return (b & (1u << 29)) != 0;
+}
+#endif
+
+static void cmCryptoHash_rhash_library_init()
+{
+  rhash_library_init();
+#ifdef CM_CRYPTO_HASH_USE_SHANI
+  cmCryptoHash_shani = cmCryptoHashDetectSHANI();
+#endif
+}
 
 static rhash cmCryptoHash_rhash_init(unsigned int id)
 {
+#ifdef CMAKE_USE_LIBUV
+  uv_once(&cmCryptoHash_rhash_library_once, cmCryptoHash_rhash_library_init);
+#else
+  // Without libuv the worker pool runs everything on this thread.
   if (!cmCryptoHash_rhash_library_initialized) {
     cmCryptoHash_rhash_library_initialized = 1;
-    rhash_library_init();
+    cmCryptoHash_rhash_library_init();
   }
+#endif
   return rhash_init(id);
 }
 
+// SHA-224 and SHA-256 computed with the SHA extensions of x86
+// processors.  The portable implementation of librhash is used elsewhere.
+struct cmCryptoHashSHA256
+{
+  unsigned int Hash[8];
+  unsigned char Message[64];
+  KWIML_INT_uint64_t Length;
+  size_t DigestSize;
+};
+
+#ifdef CM_CRYPTO_HASH_USE_SHANI
+// Constants of the 64 rounds of SHA-224 and SHA-256.
+static unsigned int const cmCryptoHashK256[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+  0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+  0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+  0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+  0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+  0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// Process 64-byte blocks with sha256rnds2, sha256msg1 and sha256msg2.
+// The target attribute keeps the rest of the file at the baseline
+// instruction set.
+__attribute__((target("sha,sse4.1"))) static void cmCryptoHashSHA256Blocks(
+  unsigned int hash[8], unsigned char const* data, size_t blocks)
+{
+  __m128i const mask =
+    _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+  // Arrange the state as ABEF and CDGH.
+  __m128i tmp = _mm_shuffle_epi32(
+    _mm_loadu_si128(reinterpret_cast<__m128i const*>(hash)), 0xB1);
+  __m128i state1 = _mm_shuffle_epi32(
+    _mm_loadu_si128(reinterpret_cast<__m128i const*>(hash + 4)), 0x1B);
+  __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+  state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+  for (; blocks > 0; --blocks, data += 64) {
+    __m128i const abef = state0;
+    __m128i const cdgh = state1;
+    __m128i w[4];
+    for (int i = 0; i < 4; ++i) {
+      w[i] = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16 * i)),
+        mask);
+    }
+    // Each step does four rounds with the message words of w[n % 4] and
+    // computes the words of later rounds in place.
+    for (int n = 0; n < 16; ++n) {
+      __m128i& cur = w[n & 3];
+      __m128i& next = w[(n + 1) & 3];
+      __m128i& prev = w[(n + 3) & 3];
+      __m128i msg = _mm_add_epi32(
+        cur,
+        _mm_loadu_si128(
+          reinterpret_cast<__m128i const*>(cmCryptoHashK256 + 4 * n)));
+      state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+      msg = _mm_shuffle_epi32(msg, 0x0E);
+      state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+      if (n >= 3 && n <= 14) {
+        next = _mm_sha256msg2_epu32(
+          _mm_add_epi32(next, _mm_alignr_epi8(cur, prev, 4)), cur);
+      }
+      if (n >= 1 && n <= 12) {
+        prev = _mm_sha256msg1_epu32(prev, cur);
+      }
+    }
+    state0 = _mm_add_epi32(state0, abef);
+    state1 = _mm_add_epi32(state1, cdgh);
+  }
+
+  // Store the state back as ABCDEFGH.
+  tmp = _mm_shuffle_epi32(state0, 0x1B);
+  state1 = _mm_shuffle_epi32(state1, 0xB1);
+  state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+  state1 = _mm_alignr_epi8(state1, tmp, 8);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(hash), state0);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(hash + 4), state1);
+}
+
+static void cmCryptoHashSHA256Init(cmCryptoHashSHA256* ctx)
+{
+  // Initial values from FIPS 180-4, 5.3.2 and 5.3.3.
+  static unsigned int const h224[8] = { 0xc1059ed8, 0x367cd507, 0x3070dd17,
+                                        0xf70e5939, 0xffc00b31, 0x68581511,
+                                        0x64f98fa7, 0xbefa4fa4 };
+  static unsigned int const h256[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                        0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                        0x1f83d9ab, 0x5be0cd19 };
+  memcpy(ctx->Hash, ctx->DigestSize == 28 ? h224 : h256, sizeof(ctx->Hash));
+  ctx->Length = 0;
+}
+
+static void cmCryptoHashSHA256Update(cmCryptoHashSHA256* ctx,
+                                     unsigned char const* msg, size_t size)
+{
+  size_t index = static_cast<size_t>(ctx->Length & 63);
+  ctx->Length += size;
+  if (index) {
+    size_t const left = 64 - index;
+    memcpy(ctx->Message + index, msg, size < left ? size : left);
+    if (size < left) {
+      return;
+    }
+    cmCryptoHashSHA256Blocks(ctx->Hash, ctx->Message, 1);
+    msg += left;
+    size -= left;
+  }
+  if (size >= 64) {
+    cmCryptoHashSHA256Blocks(ctx->Hash, msg, size / 64);
+    msg += size & ~size_t(63);
+    size &= 63;
+  }
+  if (size) {
+    memcpy(ctx->Message, msg, size);
+  }
+}
+
+static void cmCryptoHashSHA256Final(cmCryptoHashSHA256* ctx,
+                                    unsigned char* result)
+{
+  // Pad with a one bit and zeros up to the big-endian bit length.
+  KWIML_INT_uint64_t const bits = ctx->Length << 3;
+  unsigned char pad[72] = { 0x80 };
+  size_t const index = static_cast<size_t>(ctx->Length & 63);
+  size_t const padSize = (index < 56 ? 56 : 120) - index;
+  for (int i = 0; i < 8; ++i) {
+    pad[padSize + i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+  }
+  cmCryptoHashSHA256Update(ctx, pad, padSize + 8);
+  for (size_t i = 0; i < ctx->DigestSize; ++i) {
+    result[i] =
+      static_cast<unsigned char>(ctx->Hash[i / 4] >> (24 - 8 * (i % 4)));
+  }
+}
+#endif
+
+static cmCryptoHashSHA256* cmCryptoHashSHA256New(cmCryptoHash::Algo algo)
+{
+#ifdef CM_CRYPTO_HASH_USE_SHANI
+  if (cmCryptoHash_shani &&
+      (algo == cmCryptoHash::AlgoSHA224 || algo == cmCryptoHash::AlgoSHA256)) {
+    cmCryptoHashSHA256* ctx = new cmCryptoHashSHA256;
+    ctx->DigestSize = algo == cmCryptoHash::AlgoSHA224 ? 28 : 32;
+    cmCryptoHashSHA256Init(ctx);
+    return ctx;
+  }
+#else
+  static_cast<void>(algo);
+#endif
+  return CM_NULLPTR;
+}
+
 cmCryptoHash::cmCryptoHash(Algo algo)
   : Id(cmCryptoHashAlgoToId[algo])
   , CTX(cmCryptoHash_rhash_init(Id))
+  , SHA256(cmCryptoHashSHA256New(algo))
 {
 }
 
 cmCryptoHash::~cmCryptoHash()
 {
+  delete this->SHA256;
   rhash_free(this->CTX);
 }
 
@@ -120,8 +351,52 @@ std::vector<unsigned char> cmCryptoHash::ByteHashString(
   return this->Finalize();
 }
 
+#ifdef CM_CRYPTO_HASH_USE_MMAP
+// Hash a regular file by mapping it into memory one window at a time.
+// This avoids copying the content through stream buffers.  Returns
+// false if the file could not be mapped.
+static bool cmCryptoHashMappedFile(cmCryptoHash& hash, const std::string& file)
+{
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  // The window size is a multiple of any page size in practice and
+  // keeps the address space needed on 32-bit hosts bounded.
+  static off_t const window = off_t(64) << 20;
+  off_t offset = 0;
+  hash.Initialize();
+  while (offset < st.st_size) {
+    size_t const length = static_cast<size_t>(
+      st.st_size - offset < window ? st.st_size - offset : window);
+    void* data = mmap(CM_NULLPTR, length, PROT_READ, MAP_PRIVATE, fd, offset);
+    if (data == MAP_FAILED) {
+      break;
+    }
+#if defined(POSIX_MADV_SEQUENTIAL)
+    posix_madvise(data, length, POSIX_MADV_SEQUENTIAL);
+#endif
+    hash.Append(data, length);
+    munmap(data, length);
+    offset += static_cast<off_t>(length);
+  }
+  close(fd);
+  return offset == st.st_size;
+}
+#endif
+
 std::vector<unsigned char> cmCryptoHash::ByteHashFile(const std::string& file)
 {
+#ifdef CM_CRYPTO_HASH_USE_MMAP
+  if (cmCryptoHashMappedFile(*this, file)) {
+    return this->Finalize();
+  }
+#endif
   cmsys::ifstream fin(file.c_str(), std::ios::in | std::ios::binary);
   if (fin) {
     this->Initialize();
@@ -164,13 +439,67 @@ std::string cmCryptoHash::HashFile(const std::string& file)
   return ByteHashToString(this->ByteHashFile(file));
 }
 
+namespace {
+class cmCryptoHashFileJob : public cmWorkerPool::Job
+{
+public:
+  cmCryptoHashFileJob(cmCryptoHash::Algo algo, std::string const& file)
+    : Hash(algo)
+    , File(file)
+  {
+  }
+
+  void Process() CM_OVERRIDE { this->Value = this->Hash.HashFile(this->File); }
+
+  cmCryptoHash Hash;
+  std::string const& File;
+  std::string Value;
+};
+}
+
+std::vector<std::string> cmCryptoHash::HashFiles(
+  Algo algo, std::vector<std::string> const& files, unsigned int threads)
+{
+  // Construct the hashes here so that the workers only read files.
+  std::vector<cmCryptoHashFileJob*> jobs;
+  for (std::vector<std::string>::const_iterator fi = files.begin();
+       fi != files.end(); ++fi) {
+    jobs.push_back(new cmCryptoHashFileJob(algo, *fi));
+  }
+  std::vector<cmWorkerPool::Job*> pending(jobs.begin(), jobs.end());
+  cmWorkerPool pool(threads);
+  pool.Process(pending);
+
+  std::vector<std::string> values;
+  values.reserve(jobs.size());
+  for (std::vector<cmCryptoHashFileJob*>::const_iterator ji = jobs.begin();
+       ji != jobs.end(); ++ji) {
+    values.push_back((*ji)->Value);
+  }
+  cmDeleteAll(jobs);
+  return values;
+}
+
 void cmCryptoHash::Initialize()
 {
+#ifdef CM_CRYPTO_HASH_USE_SHANI
+  if (this->SHA256) {
+    cmCryptoHashSHA256Init(this->SHA256);
+    return;
+  }
+#endif
   rhash_reset(this->CTX);
 }
 
 void cmCryptoHash::Append(void const* buf, size_t sz)
 {
+#ifdef CM_CRYPTO_HASH_USE_SHANI
+  if (this->SHA256) {
+    cmCryptoHashSHA256Update(this->SHA256,
+                             static_cast<unsigned char const*>(buf), sz);
+    return;
+  }
+#endif
   rhash_update(this->CTX, buf, sz);
 }
 
@@ -182,6 +511,12 @@ void cmCryptoHash::Append(std::string const& str)
 std::vector<unsigned char> cmCryptoHash::Finalize()
 {
   std::vector<unsigned char> hash(rhash_get_digest_size(this->Id), 0);
+#ifdef CM_CRYPTO_HASH_USE_SHANI
+  if (this->SHA256) {
+    cmCryptoHashSHA256Final(this->SHA256, &hash[0]);
+    return hash;
+  }
+#endif
   rhash_final(this->CTX, &hash[0]);
   return hash;
 }
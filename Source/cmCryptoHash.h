@@ -73,6 +73,15 @@ public:
   ///         An empty string otherwise.
   std::string HashFile(const std::string& file);
 
+  /// @brief Calculates hash strings from the content of several files
+  ///        concurrently
+  /// @arg threads Number of threads, or zero for the hardware threads
+  /// @return The hash string of each file in order, or an empty string
+  ///         for each file that could not be read.
+  static std::vector<std::string> HashFiles(
+    Algo algo, std::vector<std::string> const& files,
+    unsigned int threads = 0);
+
   void Initialize();
   void Append(void const*, size_t);
   void Append(std::string const& str);
@@ -82,6 +91,7 @@ public:
 private:
   unsigned int Id;
   struct rhash_context* CTX;
+  struct cmCryptoHashSHA256* SHA256;
 };
 
 #endif
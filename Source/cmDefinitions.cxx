@@ -3,10 +3,13 @@
 #include "cmDefinitions.h"
 
 #include "cmConfigure.h"
+#include <algorithm>
 #include <assert.h>
 #include <set>
 #include <utility>
 
+#include "cmSystemTools.h"
+
 cmDefinitions::Def cmDefinitions::NoDef;
 
 cmDefinitions::Def const& cmDefinitions::GetInternal(const std::string& key,
@@ -38,6 +41,36 @@ const char* cmDefinitions::Get(const std::string& key, StackIter begin,
   return def.Exists ? def.c_str() : CM_NULLPTR;
 }
 
+static int cmDefinitionsNesting(std::string const& value)
+{
+  // cmSystemTools::ExpandListArgument counts every bracket.
+  return static_cast<int>(std::count(value.begin(), value.end(), '[') -
+                          std::count(value.begin(), value.end(), ']'));
+}
+
+std::vector<std::string> const* cmDefinitions::GetList(const std::string& key,
+                                                       StackIter begin,
+                                                       StackIter end,
+                                                       bool& hasEmpty)
+{
+  Def const& def = cmDefinitions::GetInternal(key, begin, end, false);
+  if (!def.Exists) {
+    return CM_NULLPTR;
+  }
+  if (!def.ListValid) {
+    def.List.clear();
+    if (!def.empty()) {
+      cmSystemTools::ExpandListArgument(def, def.List, true);
+    }
+    def.ListNesting = cmDefinitionsNesting(def);
+    def.ListEmpty = static_cast<std::vector<std::string>::size_type>(
+      std::count(def.List.begin(), def.List.end(), std::string()));
+    def.ListValid = true;
+  }
+  hasEmpty = def.ListEmpty > 0;
+  return &def.List;
+}
+
 void cmDefinitions::Raise(const std::string& key, StackIter begin,
                           StackIter end)
 {
@@ -62,6 +95,40 @@ void cmDefinitions::Set(const std::string& key, const char* value)
   this->Map[key] = def;
 }
 
+bool cmDefinitions::AppendList(const std::string& key,
+                               const std::string& value)
+{
+  MapType::iterator i = this->Map.find(key);
+  if (i == this->Map.end() || !i->second.Exists) {
+    return false;
+  }
+  Def& def = i->second;
+  if (def.empty()) {
+    def.assign(value);
+    def.ListValid = false;
+    def.List.clear();
+    return true;
+  }
+
+  // The elements of the value extend the kept elements unless the
+  // separator would be escaped or nested in square brackets.
+  bool const extend = def.ListValid && def.ListNesting == 0 &&
+    *def.rbegin() != '\\';
+  def += ";";
+  def += value;
+  if (extend) {
+    std::vector<std::string>::size_type const size = def.List.size();
+    cmSystemTools::ExpandListArgument(value, def.List, true);
+    def.ListNesting = cmDefinitionsNesting(value);
+    def.ListEmpty += static_cast<std::vector<std::string>::size_type>(
+      std::count(def.List.begin() + size, def.List.end(), std::string()));
+  } else {
+    def.ListValid = false;
+    def.List.clear();
+  }
+  return true;
+}
+
 std::vector<std::string> cmDefinitions::UnusedKeys() const
 {
   std::vector<std::string> keys;
@@ -26,6 +26,15 @@ public:
   static const char* Get(const std::string& key, StackIter begin,
                          StackIter end);
 
+  /** Get the ;-separated elements of a value, with empty elements, as
+      cmSystemTools::ExpandListArgument splits it, and whether any element
+      is empty.  The elements are kept with the value until it is set
+      again.  */
+  static std::vector<std::string> const* GetList(const std::string& key,
+                                                 StackIter begin,
+                                                 StackIter end,
+                                                 bool& hasEmpty);
+
   static void Raise(const std::string& key, StackIter begin, StackIter end);
 
   static bool HasKey(const std::string& key, StackIter begin, StackIter end);
@@ -33,6 +42,10 @@ public:
   /** Set (or unset if null) a value associated with a key.  */
   void Set(const std::string& key, const char* value);
 
+  /** Append a ;-separated value to a value set in this scope, and extend
+      its kept elements.  Return false if the key is not set here.  */
+  bool AppendList(const std::string& key, const std::string& value);
+
   std::vector<std::string> UnusedKeys() const;
 
   static std::vector<std::string> ClosureKeys(StackIter begin, StackIter end);
@@ -40,7 +53,8 @@ public:
   static cmDefinitions MakeClosure(StackIter begin, StackIter end);
 
 private:
-  // String with existence boolean.
+  // String with existence boolean and the elements of the string as a
+  // list once they are needed.  Copies do not keep the elements.
   struct Def : public std::string
   {
   private:
@@ -51,22 +65,56 @@ private:
       : std_string()
       , Exists(false)
       , Used(false)
+      , ListValid(false)
+      , ListNesting(0)
+      , ListEmpty(0)
     {
     }
     Def(const char* v)
       : std_string(v ? v : "")
       , Exists(v ? true : false)
       , Used(false)
+      , ListValid(false)
+      , ListNesting(0)
+      , ListEmpty(0)
     {
     }
     Def(const std_string& v)
       : std_string(v)
       , Exists(true)
       , Used(false)
+      , ListValid(false)
+      , ListNesting(0)
+      , ListEmpty(0)
+    {
+    }
+    Def(const Def& r)
+      : std_string(r)
+      , Exists(r.Exists)
+      , Used(r.Used)
+      , ListValid(false)
+      , ListNesting(0)
+      , ListEmpty(0)
+    {
+    }
+    Def& operator=(const Def& r)
     {
+      this->std_string::operator=(r);
+      this->Exists = r.Exists;
+      this->Used = r.Used;
+      this->ListValid = false;
+      this->List.clear();
+      this->ListEmpty = 0;
+      return *this;
     }
     bool Exists;
     bool Used;
+    mutable bool ListValid;
+    // Square bracket nesting at the end of the string.
+    mutable int ListNesting;
+    mutable std::vector<std::string> List;
+    // Number of empty elements.
+    mutable std::vector<std::string>::size_type ListEmpty;
   };
   static Def NoDef;
 
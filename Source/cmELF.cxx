@@ -11,6 +11,13 @@
 #include <utility>
 #include <vector>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 // Include the ELF format information system header.
 #if defined(__OpenBSD__)
 #include <elf_abi.h>
@@ -97,6 +104,83 @@ void cmELFByteSwap(T& x)
   cmELFByteSwap(reinterpret_cast<char*>(&x), cmELFByteSwapSize<sizeof(T)>());
 }
 
+#if !defined(_WIN32)
+// Stream buffer reading a file mapped into memory.  Reading a section
+// then copies from the mapping instead of refilling a file buffer on
+// every seek.
+class cmELFMappedBuffer : public std::streambuf
+{
+public:
+  cmELFMappedBuffer(char* data, size_t size)
+  {
+    this->setg(data, data, data + size);
+  }
+
+protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode /*unused*/) CM_OVERRIDE
+  {
+    off_type const size = this->egptr() - this->eback();
+    off_type pos = off;
+    if (dir == std::ios_base::cur) {
+      pos += this->gptr() - this->eback();
+    } else if (dir == std::ios_base::end) {
+      pos += size;
+    }
+    if (pos < 0 || pos > size) {
+      return pos_type(off_type(-1));
+    }
+    this->setg(this->eback(), this->eback() + pos, this->egptr());
+    return pos_type(pos);
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) CM_OVERRIDE
+  {
+    return this->seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+};
+
+// Input stream owning a read-only mapping of a whole file.
+class cmELFMappedStream : public std::istream
+{
+public:
+  cmELFMappedStream(void* data, size_t size)
+    : std::istream(CM_NULLPTR)
+    , Data(data)
+    , Size(size)
+    , Buffer(static_cast<char*>(data), size)
+  {
+    this->init(&this->Buffer);
+  }
+  ~cmELFMappedStream() CM_OVERRIDE { munmap(this->Data, this->Size); }
+
+  // Map the given file, or return null if it cannot be mapped.
+  static cmELFMappedStream* Open(const char* fname)
+  {
+    int fd = open(fname, O_RDONLY);
+    if (fd < 0) {
+      return CM_NULLPTR;
+    }
+    cmELFMappedStream* stream = CM_NULLPTR;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+      size_t const size = static_cast<size_t>(st.st_size);
+      void* data = mmap(CM_NULLPTR, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        stream = new cmELFMappedStream(data, size);
+      }
+    }
+    close(fd);
+    return stream;
+  }
+
+private:
+  void* Data;
+  size_t Size;
+  cmELFMappedBuffer Buffer;
+};
+#endif
+
 class cmELFInternal
 {
 public:
@@ -108,7 +192,7 @@ public:
   };
 
   // Construct and take ownership of the file stream object.
-  cmELFInternal(cmELF* external, CM_AUTO_PTR<cmsys::ifstream>& fin,
+  cmELFInternal(cmELF* external, CM_AUTO_PTR<std::istream>& fin,
                 ByteOrderType order)
     : External(external)
     , Stream(*fin.release())
@@ -231,7 +315,7 @@ public:
   typedef typename Types::tagtype tagtype;
 
   // Construct with a stream and byte swap indicator.
-  cmELFInternalImpl(cmELF* external, CM_AUTO_PTR<cmsys::ifstream>& fin,
+  cmELFInternalImpl(cmELF* external, CM_AUTO_PTR<std::istream>& fin,
                     ByteOrderType order);
 
   // Return the number of sections as specified by the ELF header.
@@ -425,7 +509,7 @@ private:
 
 template <class Types>
 cmELFInternalImpl<Types>::cmELFInternalImpl(cmELF* external,
-                                            CM_AUTO_PTR<cmsys::ifstream>& fin,
+                                            CM_AUTO_PTR<std::istream>& fin,
                                             ByteOrderType order)
   : cmELFInternal(external, fin, order)
 {
@@ -685,8 +769,14 @@ const long cmELF::TagMipsRldMapRel = 0;
 cmELF::cmELF(const char* fname)
   : Internal(CM_NULLPTR)
 {
-  // Try to open the file.
-  CM_AUTO_PTR<cmsys::ifstream> fin(new cmsys::ifstream(fname));
+  // Try to map the file, or else to open it.
+  CM_AUTO_PTR<std::istream> fin;
+#if !defined(_WIN32)
+  fin.reset(cmELFMappedStream::Open(fname));
+#endif
+  if (!fin.get()) {
+    fin.reset(new cmsys::ifstream(fname));
+  }
 
   // Quit now if the file could not be opened.
   if (!fin.get() || !*fin) {
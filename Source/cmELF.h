@@ -22,7 +22,9 @@ class cmELFInternal;
 class cmELF
 {
 public:
-  /** Construct with the name of the ELF input file to parse.  */
+  /** Construct with the name of the ELF input file to parse.  The file
+      is mapped into memory where possible, so one parser may serve
+      several queries and edits of the same file cheaply.  */
   cmELF(const char* fname);
 
   /** Destruct.   */
@@ -6,6 +6,7 @@
 #include <stdio.h>
 
 #include "cmMakefile.h"
+#include "cmPathCache.h"
 #include "cmProcessOutput.h"
 #include "cmSystemTools.h"
 
@@ -236,6 +237,9 @@ bool cmExecProgramCommand::RunCommand(const char* command, std::string& output,
 
   // All output has been read.  Wait for the process to exit.
   cmsysProcess_WaitForExit(cp, CM_NULLPTR);
+
+  // The process may have created or removed any file.
+  cmPathCache::InvalidateFileSystem();
   processOutput.DecodeText(output, output);
 
   // Check the result of running the process.
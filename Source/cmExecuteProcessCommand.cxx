@@ -4,15 +4,18 @@
 
 #include "cmsys/Process.h"
 #include <ctype.h> /* isspace */
+#include <set>
 #include <sstream>
 #include <stdio.h>
 
 #include "cmAlgorithms.h"
+#include "cmExecutionStatus.h"
+#include "cmInstallQueue.h"
 #include "cmMakefile.h"
+#include "cmPathCache.h"
 #include "cmProcessOutput.h"
 #include "cmSystemTools.h"
-
-class cmExecutionStatus;
+#include "cmake.h"
 
 static bool cmExecuteProcessCommandIsWhitespace(char c)
 {
@@ -26,7 +29,7 @@ void cmExecuteProcessCommandAppend(std::vector<char>& output, const char* data,
 
 // cmExecuteProcessCommand
 bool cmExecuteProcessCommand::InitialPass(std::vector<std::string> const& args,
-                                          cmExecutionStatus&)
+                                          cmExecutionStatus& status)
 {
   if (args.empty()) {
     this->SetError("called with incorrect number of arguments");
@@ -188,6 +191,41 @@ bool cmExecuteProcessCommand::InitialPass(std::vector<std::string> const& args,
     }
   }
 
+  // A command run on one file queued for installation, whose result the
+  // script does not use, is queued behind the installation of the file.
+  // A command that may read queued files otherwise waits for them.
+  cmInstallQueue* queue =
+    this->Makefile->GetCMakeInstance()->GetInstallQueue();
+  if (!queue->IsEmpty()) {
+    std::set<std::string> queued;
+    for (std::vector<std::vector<const char*> >::const_iterator ci =
+           cmds.begin();
+         ci != cmds.end(); ++ci) {
+      for (std::vector<const char*>::const_iterator ai = ci->begin();
+           ai != ci->end() - 1; ++ai) {
+        if (queue->IsQueued(*ai)) {
+          queued.insert(cmSystemTools::CollapseFullPath(*ai));
+        }
+      }
+    }
+    if (queued.size() == 1 && cmds.size() == 1 && output_variable.empty() &&
+        error_variable.empty() && result_variable.empty() &&
+        results_variable.empty() && input_file.empty() &&
+        output_file.empty() && error_file.empty() &&
+        working_directory.empty() && timeout < 0 && !output_quiet &&
+        !error_quiet) {
+      std::vector<std::string> command(cmds[0].begin(), cmds[0].end() - 1);
+      queue->QueueCommand(*queued.begin(), command,
+                          this->Makefile->GetBacktrace());
+      return true;
+    }
+    if (!this->Makefile->RunInstallQueue()) {
+      // The error has been reported at the command that queued the file.
+      status.SetNestedError();
+      return false;
+    }
+  }
+
   // Create a process instance.
   cmsysProcess* cp = cmsysProcess_New();
 
@@ -277,6 +315,9 @@ bool cmExecuteProcessCommand::InitialPass(std::vector<std::string> const& args,
 
   // All output has been read.  Wait for the process to exit.
   cmsysProcess_WaitForExit(cp, CM_NULLPTR);
+
+  // The process may have created or removed any file.
+  cmPathCache::InvalidateFileSystem();
   processOutput.DecodeText(tempOutput, tempOutput);
   processOutput.DecodeText(tempError, tempError);
 
@@ -10,6 +10,7 @@
 #include "cmsys/String.hxx"
 #include <algorithm>
 #include <assert.h>
+#include <set>
 #include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
@@ -19,14 +20,20 @@
 #include "cmAlgorithms.h"
 #include "cmCommandArgumentsHelper.h"
 #include "cmCryptoHash.h"
+#include "cmExecutionStatus.h"
+#include "cmFileGlob.h"
 #include "cmFileLockPool.h"
 #include "cmFileTimeComparison.h"
 #include "cmGeneratorExpression.h"
+#include "cmGlobVerificationManager.h"
 #include "cmGlobalGenerator.h"
 #include "cmHexFileConverter.h"
+#include "cmInstallHashCache.h"
+#include "cmInstallQueue.h"
 #include "cmInstallType.h"
 #include "cmListFileCache.h"
 #include "cmMakefile.h"
+#include "cmPathCache.h"
 #include "cmPolicies.h"
 #include "cmSystemTools.h"
 #include "cmTimestamp.h"
@@ -104,7 +111,7 @@ static std::string fix_file_url_windows(const std::string& url)
 
 // cmLibraryCommand
 bool cmFileCommand::InitialPass(std::vector<std::string> const& args,
-                                cmExecutionStatus&)
+                                cmExecutionStatus& status)
 {
   if (args.size() < 2) {
     this->SetError("must be called with at least two arguments.");
@@ -160,6 +167,9 @@ bool cmFileCommand::InitialPass(std::vector<std::string> const& args,
   if (subCommand == "INSTALL") {
     return this->HandleInstallCommand(args);
   }
+  if (subCommand == "INSTALL_QUEUE") {
+    return this->HandleInstallQueueCommand(args, status);
+  }
   if (subCommand == "DIFFERENT") {
     return this->HandleDifferentCommand(args);
   }
@@ -167,7 +177,7 @@ bool cmFileCommand::InitialPass(std::vector<std::string> const& args,
     return this->HandleRPathChangeCommand(args);
   }
   if (subCommand == "RPATH_CHECK") {
-    return this->HandleRPathCheckCommand(args);
+    return this->HandleRPathCheckCommand(args, status);
   }
   if (subCommand == "RPATH_REMOVE") {
     return this->HandleRPathRemoveCommand(args);
@@ -240,6 +250,7 @@ bool cmFileCommand::HandleWriteCommand(std::vector<std::string> const& args,
   // the file is not writable
   cmsys::ofstream file(fileName.c_str(),
                        append ? std::ios::app : std::ios::out);
+  cmPathCache::InvalidatePath(fileName);
   if (!file) {
     std::string error = "failed to open for writing (";
     error += cmSystemTools::GetLastSystemError();
@@ -777,6 +788,7 @@ bool cmFileCommand::HandleGlobCommand(std::vector<std::string> const& args,
     }
   }
 
+  std::string relative;
   std::string output;
   bool first = true;
   for (; i != args.end(); ++i) {
@@ -817,7 +829,8 @@ bool cmFileCommand::HandleGlobCommand(std::vector<std::string> const& args,
         this->SetError("GLOB requires a directory after the RELATIVE tag");
         return false;
       }
-      g.SetRelative(i->c_str());
+      relative = *i;
+      g.SetRelative(relative.c_str());
       ++i;
       if (i == args.end()) {
         this->SetError("GLOB requires a glob expression after the directory");
@@ -825,18 +838,42 @@ bool cmFileCommand::HandleGlobCommand(std::vector<std::string> const& args,
       }
     }
 
-    cmsys::Glob::GlobMessages globMessages;
+    bool configureDepends = false;
+    if (*i == "CONFIGURE_DEPENDS") {
+      cmake::WorkingMode mode =
+        this->Makefile->GetCMakeInstance()->GetWorkingMode();
+      if (mode != cmake::NORMAL_MODE) {
+        this->SetError("CONFIGURE_DEPENDS is not allowed in script mode.");
+        return false;
+      }
+      configureDepends = true;
+      ++i;
+      if (i == args.end()) {
+        this->SetError(
+          "GLOB requires a glob expression after CONFIGURE_DEPENDS");
+        return false;
+      }
+    }
+
+    std::string expr = *i;
     if (!cmsys::SystemTools::FileIsFullPath(i->c_str())) {
-      std::string expr = this->Makefile->GetCurrentSourceDirectory();
+      expr = this->Makefile->GetCurrentSourceDirectory();
       // Handle script mode
       if (!expr.empty()) {
         expr += "/" + *i;
-        g.FindFiles(expr, &globMessages);
       } else {
-        g.FindFiles(*i, &globMessages);
+        expr = *i;
       }
-    } else {
-      g.FindFiles(*i, &globMessages);
+    }
+
+    // Most expressions can be matched against cached directory listings.
+    bool const listDirs = recurse ? g.GetRecurseListDirs() : g.GetListDirs();
+    std::vector<std::string>& files = g.GetFiles();
+    cmsys::Glob::GlobMessages globMessages;
+    if (!cmFileGlob::FindFiles(expr, recurse, listDirs,
+                               g.GetRecurseThroughSymlinks(), relative,
+                               files)) {
+      g.FindFiles(expr, &globMessages);
     }
 
     if (!globMessages.empty()) {
@@ -861,8 +898,14 @@ bool cmFileCommand::HandleGlobCommand(std::vector<std::string> const& args,
     }
 
     std::vector<std::string>::size_type cc;
-    std::vector<std::string>& files = g.GetFiles();
     std::sort(files.begin(), files.end());
+    if (configureDepends) {
+      this->Makefile->GetCMakeInstance()
+        ->GetGlobVerificationManager()
+        ->AddCacheEntry(recurse, listDirs, g.GetRecurseThroughSymlinks(),
+                        relative, expr, files, variable,
+                        this->Makefile->GetBacktrace());
+    }
     for (cc = 0; cc < files.size(); cc++) {
       if (!first) {
         output += ";";
@@ -923,7 +966,9 @@ bool cmFileCommand::HandleMakeDirectoryCommand(
       cmSystemTools::SetFatalErrorOccured();
       return false;
     }
-    if (!cmSystemTools::MakeDirectory(cdir->c_str())) {
+    bool const made = cmSystemTools::MakeDirectory(cdir->c_str());
+    cmPathCache::InvalidatePath(*cdir);
+    if (!made) {
       std::string error = "problem creating directory: " + *cdir;
       this->SetError(error);
       return false;
@@ -986,6 +1031,26 @@ bool cmFileCommand::HandleDifferentCommand(
   return true;
 }
 
+// Get the copy of a file made by a previous installation, if any.
+// CMAKE_INSTALL_REUSE_TREE names a tree being installed and the
+// directory a previous installation of that tree was moved to.
+static std::string cmFileCommandPreviousInstall(cmMakefile* mf,
+                                                std::string const& file)
+{
+  std::vector<std::string> trees;
+  cmSystemTools::ExpandListArgument(
+    mf->GetSafeDefinition("CMAKE_INSTALL_REUSE_TREE"), trees);
+  if (trees.size() != 2) {
+    return std::string();
+  }
+  std::string const& tree = trees[0];
+  if (file.size() <= tree.size() || file[tree.size()] != '/' ||
+      file.compare(0, tree.size(), tree) != 0) {
+    return std::string();
+  }
+  return trees[1] + file.substr(tree.size());
+}
+
 // File installation helper class.
 struct cmFileCopier
 {
@@ -1137,6 +1202,15 @@ protected:
   bool InstallSymlink(const char* fromFile, const char* toFile);
   bool InstallFile(const char* fromFile, const char* toFile,
                    MatchProperties match_properties);
+  virtual bool IsUpToDate(const char* fromFile, const char* toFile)
+  {
+    // If both files exist with the same time do not copy.
+    return !this->FileTimes.FileTimesDiffer(fromFile, toFile);
+  }
+  virtual void RecordCopy(const char*, const char*) {}
+  virtual bool LinkFile(const char*, const char*, mode_t) { return false; }
+  virtual bool ReuseFile(const char*, const char*) { return false; }
+  virtual bool QueueCopy(const char*, const char*, mode_t) { return false; }
   bool InstallDirectory(const char* source, const char* destination,
                         MatchProperties match_properties);
   virtual bool Install(const char* fromFile, const char* toFile);
@@ -1537,6 +1611,9 @@ bool cmFileCopier::InstallSymlink(const char* fromFile, const char* toFile)
   this->ReportCopy(toFile, TypeLink, copy);
 
   if (copy) {
+    // Anything below the symlink may now resolve elsewhere.
+    cmPathCache::InvalidateTree(toFile);
+
     // Remove the destination file so we can always create the symlink.
     cmSystemTools::RemoveFile(toFile);
 
@@ -1561,23 +1638,43 @@ bool cmFileCopier::InstallFile(const char* fromFile, const char* toFile,
 {
   // Determine whether we will copy the file.
   bool copy = true;
-  if (!this->Always) {
-    // If both files exist with the same time do not copy.
-    if (!this->FileTimes.FileTimesDiffer(fromFile, toFile)) {
-      copy = false;
-    }
+  if (!this->Always && this->IsUpToDate(fromFile, toFile)) {
+    copy = false;
   }
 
   // Inform the user about this file installation.
   this->ReportCopy(toFile, TypeFile, copy);
 
+  // Get the permissions of the destination file.
+  mode_t permissions =
+    (match_properties.Permissions ? match_properties.Permissions
+                                  : this->FilePermissions);
+  if (!permissions) {
+    // No permissions were explicitly provided but the user requested
+    // that the source file permissions be used.
+    cmSystemTools::GetPermissions(fromFile, permissions);
+  }
+
   // Copy the file.
-  if (copy && !cmSystemTools::CopyAFile(fromFile, toFile, true)) {
-    std::ostringstream e;
-    e << this->Name << " cannot copy file \"" << fromFile << "\" to \""
-      << toFile << "\".";
-    this->FileCommand->SetError(e.str());
-    return false;
+  if (copy) {
+    cmPathCache::InvalidatePath(toFile);
+    if (this->LinkFile(fromFile, toFile, permissions)) {
+      // The link already has the time and permissions of the source.
+      this->RecordCopy(fromFile, toFile);
+      return true;
+    }
+    if (!this->ReuseFile(fromFile, toFile)) {
+      if (this->QueueCopy(fromFile, toFile, permissions)) {
+        return true;
+      }
+      if (!cmSystemTools::CopyAFile(fromFile, toFile, true)) {
+        std::ostringstream e;
+        e << this->Name << " cannot copy file \"" << fromFile << "\" to \""
+          << toFile << "\".";
+        this->FileCommand->SetError(e.str());
+        return false;
+      }
+    }
   }
 
   // Set the file modification time of the destination file.
@@ -1598,15 +1695,13 @@ bool cmFileCopier::InstallFile(const char* fromFile, const char* toFile,
   }
 
   // Set permissions of the destination file.
-  mode_t permissions =
-    (match_properties.Permissions ? match_properties.Permissions
-                                  : this->FilePermissions);
-  if (!permissions) {
-    // No permissions were explicitly provided but the user requested
-    // that the source file permissions be used.
-    cmSystemTools::GetPermissions(fromFile, permissions);
+  if (!this->SetPermissions(toFile, permissions)) {
+    return false;
   }
-  return this->SetPermissions(toFile, permissions);
+  if (copy) {
+    this->RecordCopy(fromFile, toFile);
+  }
+  return true;
 }
 
 bool cmFileCopier::InstallDirectory(const char* source,
@@ -1618,6 +1713,7 @@ bool cmFileCopier::InstallDirectory(const char* source,
                    !cmSystemTools::FileIsDirectory(destination));
 
   // Make sure the destination directory exists.
+  cmPathCache::InvalidatePath(destination);
   if (!cmSystemTools::MakeDirectory(destination)) {
     std::ostringstream e;
     e << this->Name << " cannot make directory \"" << destination
@@ -1699,6 +1795,8 @@ struct cmFileInstaller : public cmFileCopier
     , MessageLazy(false)
     , MessageNever(false)
     , DestDirLength(0)
+    , HardLink(false)
+    , HashCache(CM_NULLPTR)
   {
     // Installation does not use source permissions by default.
     this->UseSourcePermissions = false;
@@ -1707,6 +1805,19 @@ struct cmFileInstaller : public cmFileCopier
     if (cmSystemTools::GetEnv("CMAKE_INSTALL_ALWAYS", install_always)) {
       this->Always = cmSystemTools::IsOn(install_always.c_str());
     }
+    // Check whether files may be installed as hard links to the source.
+    std::string hard_link =
+      this->Makefile->GetSafeDefinition("CMAKE_INSTALL_HARDLINK");
+    if (hard_link.empty()) {
+      cmSystemTools::GetEnv("CMAKE_INSTALL_HARDLINK", hard_link);
+    }
+    this->HardLink = cmSystemTools::IsOn(hard_link.c_str());
+    // Check whether to compare content hashes of changed files.
+    cmInstallHashCache* hashCache =
+      this->Makefile->GetCMakeInstance()->GetInstallHashCache();
+    if (!this->Always && hashCache->Enable(this->Makefile)) {
+      this->HashCache = hashCache;
+    }
     // Get the current manifest.
     this->Manifest =
       this->Makefile->GetSafeDefinition("CMAKE_INSTALL_MANIFEST_FILES");
@@ -1726,6 +1837,8 @@ protected:
   bool MessageNever;
   int DestDirLength;
   std::string Rename;
+  bool HardLink;
+  cmInstallHashCache* HashCache;
 
   std::string Manifest;
   void ManifestAppend(std::string const& file)
@@ -1741,6 +1854,93 @@ protected:
     return this->Rename.empty() ? fromName : this->Rename;
   }
 
+  bool IsUpToDate(const char* fromFile, const char* toFile) CM_OVERRIDE
+  {
+    if (this->cmFileCopier::IsUpToDate(fromFile, toFile)) {
+      return true;
+    }
+    // A source with a new time may still have the content installed.
+    return this->HashCache &&
+      this->HashCache->IsUpToDate(fromFile, toFile);
+  }
+
+  void RecordCopy(const char* fromFile, const char* toFile) CM_OVERRIDE
+  {
+    if (this->HashCache) {
+      this->HashCache->Record(fromFile, toFile,
+                              cmInstallHashCache::ComputeHash(fromFile));
+    }
+  }
+
+  bool LinkFile(const char* fromFile, const char* toFile,
+                mode_t permissions) CM_OVERRIDE
+  {
+    // Targets are edited in place after installation, which would change
+    // the build tree through a link.
+    if (!this->HardLink ||
+        (this->InstallType != cmInstallType_FILES &&
+         this->InstallType != cmInstallType_PROGRAMS &&
+         this->InstallType != cmInstallType_DIRECTORY)) {
+      return false;
+    }
+#ifdef WIN32
+    // The permissions are recorded next to the file when cross compiling.
+    if (this->Makefile->IsOn("CMAKE_CROSSCOMPILING")) {
+      return false;
+    }
+#endif
+    // The link shares the permissions of the source.
+    mode_t sourcePermissions = 0;
+    if (!cmSystemTools::GetPermissions(fromFile, sourcePermissions) ||
+        (permissions && (sourcePermissions & 07777) !=
+           (permissions & 07777))) {
+      return false;
+    }
+    cmSystemTools::RemoveFile(toFile);
+    return cmSystemTools::CreateLink(fromFile, toFile);
+  }
+
+  bool ReuseFile(const char* fromFile, const char* toFile) CM_OVERRIDE
+  {
+    if (this->Always) {
+      return false;
+    }
+    std::string const previous =
+      cmFileCommandPreviousInstall(this->Makefile, toFile);
+    // The previous copy is still up to date if it has the time and size
+    // it was installed with.  RPATH_CHECK removed it if its RPATH is not
+    // the one this installation will give the file.
+    if (previous.empty() || cmSystemTools::FileIsSymlink(previous) ||
+        this->FileTimes.FileTimesDiffer(fromFile, previous.c_str()) ||
+        cmSystemTools::FileLength(fromFile) !=
+          cmSystemTools::FileLength(previous)) {
+      return false;
+    }
+    cmSystemTools::RemoveFile(toFile);
+    return cmSystemTools::CreateLink(previous, toFile) ||
+      cmSystemTools::CloneFileContent(previous, toFile);
+  }
+
+  bool QueueCopy(const char* fromFile, const char* toFile,
+                 mode_t permissions) CM_OVERRIDE
+  {
+    cmInstallQueue* queue =
+      this->Makefile->GetCMakeInstance()->GetInstallQueue();
+    if (!queue->IsActive()) {
+      return false;
+    }
+#ifdef WIN32
+    // The permissions are recorded next to the file when cross compiling.
+    if (this->Makefile->IsOn("CMAKE_CROSSCOMPILING")) {
+      return false;
+    }
+#endif
+    queue->QueueCopy(fromFile, toFile, permissions, !this->Always,
+                     this->HashCache != CM_NULLPTR,
+                     this->Makefile->GetBacktrace());
+    return true;
+  }
+
   void ReportCopy(const char* toFile, Type type, bool copy) CM_OVERRIDE
   {
     if (!this->MessageNever && (copy || !this->MessageLazy)) {
@@ -2022,6 +2222,7 @@ bool cmFileInstaller::HandleInstallDestination()
 
   if (this->InstallType != cmInstallType_DIRECTORY) {
     if (!cmSystemTools::FileExists(destination.c_str())) {
+      cmPathCache::InvalidatePath(destination);
       if (!cmSystemTools::MakeDirectory(destination.c_str())) {
         std::string errstring = "cannot create directory: " + destination +
           ". Maybe need administrative privileges.";
@@ -2043,7 +2244,7 @@ bool cmFileCommand::HandleRPathChangeCommand(
   std::vector<std::string> const& args)
 {
   // Evaluate arguments.
-  const char* file = CM_NULLPTR;
+  std::vector<std::string> files;
   const char* oldRPath = CM_NULLPTR;
   const char* newRPath = CM_NULLPTR;
   enum Doing
@@ -2062,8 +2263,7 @@ bool cmFileCommand::HandleRPathChangeCommand(
     } else if (args[i] == "FILE") {
       doing = DoingFile;
     } else if (doing == DoingFile) {
-      file = args[i].c_str();
-      doing = DoingNone;
+      files.push_back(args[i]);
     } else if (doing == DoingOld) {
       oldRPath = args[i].c_str();
       doing = DoingNone;
@@ -2077,7 +2277,7 @@ bool cmFileCommand::HandleRPathChangeCommand(
       return false;
     }
   }
-  if (!file) {
+  if (files.empty()) {
     this->SetError("RPATH_CHANGE not given FILE option.");
     return false;
   }
@@ -2089,51 +2289,14 @@ bool cmFileCommand::HandleRPathChangeCommand(
     this->SetError("RPATH_CHANGE not given NEW_RPATH option.");
     return false;
   }
-  if (!cmSystemTools::FileExists(file, true)) {
-    std::ostringstream e;
-    e << "RPATH_CHANGE given FILE \"" << file << "\" that does not exist.";
-    this->SetError(e.str());
-    return false;
-  }
-  bool success = true;
-  cmSystemToolsFileTime* ft = cmSystemTools::FileTimeNew();
-  bool have_ft = cmSystemTools::FileTimeGet(file, ft);
-  std::string emsg;
-  bool changed;
-  if (!cmSystemTools::ChangeRPath(file, oldRPath, newRPath, &emsg, &changed)) {
-    std::ostringstream e;
-    /* clang-format off */
-    e << "RPATH_CHANGE could not write new RPATH:\n"
-      << "  " << newRPath << "\n"
-      << "to the file:\n"
-      << "  " << file << "\n"
-      << emsg;
-    /* clang-format on */
-    this->SetError(e.str());
-    success = false;
-  }
-  if (success) {
-    if (changed) {
-      std::string message = "Set runtime path of \"";
-      message += file;
-      message += "\" to \"";
-      message += newRPath;
-      message += "\"";
-      this->Makefile->DisplayStatus(message.c_str(), -1);
-    }
-    if (have_ft) {
-      cmSystemTools::FileTimeSet(file, ft);
-    }
-  }
-  cmSystemTools::FileTimeDelete(ft);
-  return success;
+  return this->EditRPaths("RPATH_CHANGE", files, false, oldRPath, newRPath);
 }
 
 bool cmFileCommand::HandleRPathRemoveCommand(
   std::vector<std::string> const& args)
 {
   // Evaluate arguments.
-  const char* file = CM_NULLPTR;
+  std::vector<std::string> files;
   enum Doing
   {
     DoingNone,
@@ -2144,8 +2307,7 @@ bool cmFileCommand::HandleRPathRemoveCommand(
     if (args[i] == "FILE") {
       doing = DoingFile;
     } else if (doing == DoingFile) {
-      file = args[i].c_str();
-      doing = DoingNone;
+      files.push_back(args[i]);
     } else {
       std::ostringstream e;
       e << "RPATH_REMOVE given unknown argument " << args[i];
@@ -2153,48 +2315,63 @@ bool cmFileCommand::HandleRPathRemoveCommand(
       return false;
     }
   }
-  if (!file) {
+  if (files.empty()) {
     this->SetError("RPATH_REMOVE not given FILE option.");
     return false;
   }
-  if (!cmSystemTools::FileExists(file, true)) {
-    std::ostringstream e;
-    e << "RPATH_REMOVE given FILE \"" << file << "\" that does not exist.";
-    this->SetError(e.str());
-    return false;
-  }
-  bool success = true;
-  cmSystemToolsFileTime* ft = cmSystemTools::FileTimeNew();
-  bool have_ft = cmSystemTools::FileTimeGet(file, ft);
-  std::string emsg;
-  bool removed;
-  if (!cmSystemTools::RemoveRPath(file, &emsg, &removed)) {
-    std::ostringstream e;
-    /* clang-format off */
-    e << "RPATH_REMOVE could not remove RPATH from file:\n"
-      << "  " << file << "\n"
-      << emsg;
-    /* clang-format on */
-    this->SetError(e.str());
-    success = false;
-  }
-  if (success) {
-    if (removed) {
-      std::string message = "Removed runtime path from \"";
-      message += file;
-      message += "\"";
-      this->Makefile->DisplayStatus(message.c_str(), -1);
+  return this->EditRPaths("RPATH_REMOVE", files, true, "", "");
+}
+
+bool cmFileCommand::EditRPaths(const char* command,
+                               std::vector<std::string> const& files,
+                               bool remove, std::string const& oldRPath,
+                               std::string const& newRPath)
+{
+  // Edits of queued files run after their copies.  Edit the other files
+  // together, parsing each once, on several threads.
+  cmInstallQueue* queue =
+    this->Makefile->GetCMakeInstance()->GetInstallQueue();
+  std::set<std::string> seen;
+  std::vector<std::string> edit;
+  for (std::vector<std::string>::const_iterator fi = files.begin();
+       fi != files.end(); ++fi) {
+    std::string const& file = *fi;
+    if (!seen.insert(cmSystemTools::CollapseFullPath(file)).second) {
+      // A file listed again is edited once.
+      continue;
     }
-    if (have_ft) {
-      cmSystemTools::FileTimeSet(file, ft);
+    if (queue->IsQueued(file)) {
+      if (remove) {
+        queue->QueueRPathRemove(file, this->Makefile->GetBacktrace());
+      } else {
+        queue->QueueRPathChange(file, oldRPath, newRPath,
+                                this->Makefile->GetBacktrace());
+      }
+    } else if (cmSystemTools::FileExists(file, true)) {
+      edit.push_back(file);
+    } else {
+      std::ostringstream e;
+      e << command << " given FILE \"" << file << "\" that does not exist.";
+      this->SetError(e.str());
+      return false;
     }
   }
-  cmSystemTools::FileTimeDelete(ft);
+  std::vector<std::string> messages;
+  std::string error;
+  bool success = cmInstallQueue::EditRPaths(edit, remove, oldRPath, newRPath,
+                                            0, messages, error);
+  for (std::vector<std::string>::const_iterator mi = messages.begin();
+       mi != messages.end(); ++mi) {
+    this->Makefile->DisplayStatus(mi->c_str(), -1);
+  }
+  if (!success) {
+    this->SetError(error);
+  }
   return success;
 }
 
 bool cmFileCommand::HandleRPathCheckCommand(
-  std::vector<std::string> const& args)
+  std::vector<std::string> const& args, cmExecutionStatus& status)
 {
   // Evaluate arguments.
   const char* file = CM_NULLPTR;
@@ -2233,12 +2410,33 @@ bool cmFileCommand::HandleRPathCheckCommand(
     return false;
   }
 
+  // Install scripts check each file before installing it.  Only run the
+  // install queue if it may change this file, so that the files of
+  // several targets can be queued together.
+  cmInstallQueue* queue =
+    this->Makefile->GetCMakeInstance()->GetInstallQueue();
+  if (queue->IsQueued(file) && !this->Makefile->RunInstallQueue()) {
+    // The error has been reported at the command that queued the file.
+    status.SetNestedError();
+    return false;
+  }
+
   // If the file exists but does not have the desired RPath then
   // delete it.  This is used during installation to re-install a file
   // if its RPath will change.
   if (cmSystemTools::FileExists(file, true) &&
       !cmSystemTools::CheckRPath(file, rpath)) {
     cmSystemTools::RemoveFile(file);
+    cmPathCache::InvalidatePath(file);
+  }
+
+  // Do not let the installation reuse a copy with the wrong RPath either.
+  std::string const previous =
+    cmFileCommandPreviousInstall(this->Makefile, file);
+  if (!previous.empty() && cmSystemTools::FileExists(previous, true) &&
+      !cmSystemTools::CheckRPath(previous, rpath)) {
+    cmSystemTools::RemoveFile(previous);
+    cmPathCache::InvalidatePath(previous);
   }
 
   return true;
@@ -2312,6 +2510,39 @@ bool cmFileCommand::HandleInstallCommand(std::vector<std::string> const& args)
   return installer.Run(args);
 }
 
+bool cmFileCommand::HandleInstallQueueCommand(
+  std::vector<std::string> const& args, cmExecutionStatus& status)
+{
+  cmInstallQueue* queue =
+    this->Makefile->GetCMakeInstance()->GetInstallQueue();
+  std::string const& mode = args[1];
+  if (mode == "BEGIN" && args.size() == 2) {
+    queue->Begin(this->Makefile);
+    return true;
+  }
+  if ((mode == "END" || mode == "RUN") && args.size() == 2) {
+    if (mode == "END" && !queue->IsOpen()) {
+      this->SetError("END given without a preceding BEGIN.");
+      return false;
+    }
+    if (!(mode == "END" ? queue->End(this->Makefile)
+                        : this->Makefile->RunInstallQueue())) {
+      // The error has been reported at the command that queued the file.
+      status.SetNestedError();
+      return false;
+    }
+    return true;
+  }
+  if (mode == "IS_QUEUED" && args.size() == 4) {
+    this->Makefile->AddDefinition(args[3],
+                                  queue->IsQueued(args[2]) ? "1" : "0");
+    return true;
+  }
+  this->SetError("INSTALL_QUEUE must be called with BEGIN, END, RUN or "
+                 "IS_QUEUED <file> <variable>.");
+  return false;
+}
+
 bool cmFileCommand::HandleRelativePathCommand(
   std::vector<std::string> const& args)
 {
@@ -2363,7 +2594,11 @@ bool cmFileCommand::HandleRename(std::vector<std::string> const& args)
     newname += "/" + args[2];
   }
 
-  if (!cmSystemTools::RenameFile(oldname.c_str(), newname.c_str())) {
+  bool const renamed =
+    cmSystemTools::RenameFile(oldname.c_str(), newname.c_str());
+  cmPathCache::InvalidateTree(oldname);
+  cmPathCache::InvalidateTree(newname);
+  if (!renamed) {
     std::string err = cmSystemTools::GetLastSystemError();
     std::ostringstream e;
     /* clang-format off */
@@ -2400,6 +2635,7 @@ bool cmFileCommand::HandleRemove(std::vector<std::string> const& args,
     } else {
       cmSystemTools::RemoveFile(fileName);
     }
+    cmPathCache::InvalidateTree(fileName);
   }
   return true;
 }
@@ -2778,6 +3014,7 @@ bool cmFileCommand::HandleDownloadCommand(std::vector<std::string> const& args)
   }
 
   cmsys::ofstream fout(file.c_str(), std::ios::binary);
+  cmPathCache::InvalidatePath(file);
   if (!fout) {
     this->SetError("DOWNLOAD cannot open file for write.");
     return false;
@@ -3362,6 +3599,7 @@ bool cmFileCommand::HandleLockCommand(std::vector<std::string> const& args)
     return false;
   }
   fclose(file);
+  cmPathCache::InvalidatePath(path);
 
   // Actual lock/unlock
   cmFileLockPool& lockPool =
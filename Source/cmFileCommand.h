@@ -46,12 +46,18 @@ protected:
                               bool nativePath);
   bool HandleReadElfCommand(std::vector<std::string> const& args);
   bool HandleRPathChangeCommand(std::vector<std::string> const& args);
-  bool HandleRPathCheckCommand(std::vector<std::string> const& args);
+  bool HandleRPathCheckCommand(std::vector<std::string> const& args,
+                               cmExecutionStatus& status);
   bool HandleRPathRemoveCommand(std::vector<std::string> const& args);
+  bool EditRPaths(const char* command, std::vector<std::string> const& files,
+                  bool remove, std::string const& oldRPath,
+                  std::string const& newRPath);
   bool HandleDifferentCommand(std::vector<std::string> const& args);
 
   bool HandleCopyCommand(std::vector<std::string> const& args);
   bool HandleInstallCommand(std::vector<std::string> const& args);
+  bool HandleInstallQueueCommand(std::vector<std::string> const& args,
+                                 cmExecutionStatus& status);
   bool HandleDownloadCommand(std::vector<std::string> const& args);
   bool HandleUploadCommand(std::vector<std::string> const& args);
 
@@ -0,0 +1,146 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmFileGlob.h"
+
+#include "cmAlgorithms.h"
+#include "cmPathCache.h"
+#include "cmSystemTools.h"
+#include "cmWorkerPool.h"
+#include "cmsys/Glob.hxx"
+#include "cmsys/RegularExpression.hxx"
+#include "cmsys/SystemTools.hxx"
+
+namespace {
+class cmFileGlobJob : public cmWorkerPool::Job
+{
+public:
+  cmFileGlobJob(std::string const& dir, cmsys::RegularExpression const& regex,
+                bool recurse, bool listDirs)
+    : Dir(dir)
+    , Regex(regex)
+    , Recurse(recurse)
+    , ListDirs(listDirs)
+  {
+  }
+
+  void Process() CM_OVERRIDE;
+
+  std::string Dir;
+  cmsys::RegularExpression Regex;
+  bool Recurse;
+  bool ListDirs;
+  std::vector<std::string> Files;
+  std::vector<std::string> Directories;
+};
+
+void cmFileGlobJob::Process()
+{
+  // This follows Glob::RecurseDirectory and Glob::ProcessDirectory.
+  std::vector<cmPathCache::DirectoryEntry> entries;
+  if (!cmPathCache::ListDirectory(this->Dir, entries)) {
+    return;
+  }
+  for (std::vector<cmPathCache::DirectoryEntry>::const_iterator ei =
+         entries.begin();
+       ei != entries.end(); ++ei) {
+    std::string const path = this->Dir + "/" + ei->Name;
+    if (this->Recurse) {
+      if (ei->Type == cmPathCache::EntryDirectory) {
+        if (this->ListDirs) {
+          this->Files.push_back(path);
+        }
+        this->Directories.push_back(path);
+        continue;
+      }
+    } else if (!this->ListDirs) {
+      if (ei->Type == cmPathCache::EntryDirectory ||
+          (ei->Type == cmPathCache::EntrySymlink &&
+           cmSystemTools::FileIsDirectory(path))) {
+        continue;
+      }
+    }
+#if defined(_WIN32) || defined(__APPLE__) || defined(__CYGWIN__)
+    // Glob matches lower case names on these platforms.
+    if (this->Regex.find(cmSystemTools::LowerCase(ei->Name))) {
+#else
+    if (this->Regex.find(ei->Name)) {
+#endif
+      this->Files.push_back(path);
+    }
+  }
+}
+}
+
+bool cmFileGlob::FindFiles(std::string const& expr, bool recurse,
+                           bool listDirs, bool followSymlinks,
+                           std::string const& relative,
+                           std::vector<std::string>& files)
+{
+  if (recurse && followSymlinks) {
+    return false;
+  }
+  if (!cmSystemTools::FileIsFullPath(expr.c_str())) {
+    return false;
+  }
+
+  // Split the expression where Glob::FindFiles starts matching.
+  std::string::size_type lastSlash = 0;
+  for (std::string::size_type cc = 1; cc < expr.size(); ++cc) {
+    if (expr[cc - 1] == '\\') {
+      continue;
+    }
+    if (expr[cc] == '/') {
+      lastSlash = cc;
+    } else if (expr[cc] == '[' || expr[cc] == '?' || expr[cc] == '*') {
+      break;
+    }
+  }
+  if (lastSlash == 0) {
+    return false;
+  }
+  std::string const dir = expr.substr(0, lastSlash);
+  std::string const pattern = expr.substr(lastSlash + 1);
+  if (pattern.empty() || pattern.find('/') != std::string::npos) {
+    return false;
+  }
+  // Listings are invalidated by normalized path.
+  if (cmPathCache::CollapseFullPath(dir) != dir) {
+    return false;
+  }
+
+  cmsys::RegularExpression const regex(
+    cmsys::Glob::PatternToRegex(pattern));
+  std::vector<std::string> found;
+  std::vector<std::string> level(1, dir);
+  cmWorkerPool pool;
+  while (!level.empty()) {
+    std::vector<cmFileGlobJob*> jobs;
+    for (std::vector<std::string>::const_iterator di = level.begin();
+         di != level.end(); ++di) {
+      jobs.push_back(new cmFileGlobJob(*di, regex, recurse, listDirs));
+    }
+    std::vector<cmWorkerPool::Job*> pending(jobs.begin(), jobs.end());
+    pool.Process(pending);
+
+    level.clear();
+    for (std::vector<cmFileGlobJob*>::const_iterator ji = jobs.begin();
+         ji != jobs.end(); ++ji) {
+      found.insert(found.end(), (*ji)->Files.begin(), (*ji)->Files.end());
+      level.insert(level.end(), (*ji)->Directories.begin(),
+                   (*ji)->Directories.end());
+    }
+    cmDeleteAll(jobs);
+  }
+
+  if (relative.empty()) {
+    files.swap(found);
+  } else {
+    files.clear();
+    files.reserve(found.size());
+    for (std::vector<std::string>::const_iterator fi = found.begin();
+         fi != found.end(); ++fi) {
+      files.push_back(cmsys::SystemTools::RelativePath(relative, *fi));
+    }
+  }
+  return true;
+}
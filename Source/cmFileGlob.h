@@ -0,0 +1,36 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmFileGlob_h
+#define cmFileGlob_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <vector>
+
+/** \class cmFileGlob
+ * \brief Find files for file(GLOB) and file(GLOB_RECURSE) from cached
+ * directory listings.
+ *
+ * This handles full-path expressions with wildcards only in the last
+ * component, as nearly all globs in projects are, when no symbolic link
+ * to a directory is to be followed.  The listings come from cmPathCache,
+ * so the globs of one configure read each directory once, and they tell
+ * the entry types so matching needs no stat.  The directories of each
+ * level of a recursive walk are read on several threads.  Commands that
+ * create or remove files invalidate the listings they touch, so a glob
+ * sees the files written by earlier commands.
+ */
+class cmFileGlob
+{
+public:
+  /** Find the files cmsys::Glob would find for the expression with the
+      given settings, in no particular order.  Return false if the
+      expression or settings are not handled here.  */
+  static bool FindFiles(std::string const& expr, bool recurse,
+                        bool listDirs, bool followSymlinks,
+                        std::string const& relative,
+                        std::vector<std::string>& files);
+};
+
+#endif
@@ -97,7 +97,7 @@ bool cmForEachFunctionBlocker::ShouldRemove(const cmListFileFunction& lff,
 {
   if (!cmSystemTools::Strucmp(lff.Name.c_str(), "endforeach")) {
     std::vector<std::string> expandedArguments;
-    mf.ExpandArguments(lff.Arguments, expandedArguments);
+    mf.ExpandArguments(lff.GetArguments(), expandedArguments);
     // if the endforeach has arguments then make sure
     // they match the begin foreach arguments
     if ((expandedArguments.empty() ||
@@ -3,20 +3,199 @@
 #include "cmGeneratedFileStream.h"
 
 #include <stdio.h>
+#include <streambuf>
+#include <string.h>
+#include <vector>
 
+#include "cmPathCache.h"
 #include "cmSystemTools.h"
+#include "cm_kwiml.h"
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 #include "cm_codecvt.hxx"
 #include "cm_zlib.h"
 #endif
 
+/** \class cmGeneratedFileStreamCompareBuffer
+ * \brief Stream buffer for copy-if-different output.
+ *
+ * Content is buffered in memory and compared chunk by chunk with the
+ * existing destination file.  As long as it matches nothing is written.
+ * At the first difference the matching prefix is copied from the
+ * destination into the temporary file and all further content goes
+ * there.  An unchanged file therefore costs a single read and no write.
+ */
+class cmGeneratedFileStreamCompareBuffer : public std::streambuf
+{
+public:
+  enum Result
+  {
+    Unchanged,
+    Changed,
+    Failed
+  };
+
+  cmGeneratedFileStreamCompareBuffer(std::string const& name,
+                                     std::string const& tempName)
+    : Name(name)
+    , TempName(tempName)
+    , Buffer(1 << 20)
+    , Old(CM_NULLPTR)
+    , Temp(CM_NULLPTR)
+    , Started(false)
+    , Matching(false)
+    , Error(false)
+    , Matched(0)
+  {
+    this->setp(&this->Buffer[0], &this->Buffer[0] + this->Buffer.size());
+  }
+
+  ~cmGeneratedFileStreamCompareBuffer() CM_OVERRIDE
+  {
+    if (this->Old) {
+      fclose(this->Old);
+    }
+    if (this->Temp) {
+      fclose(this->Temp);
+    }
+  }
+
+  // Flush buffered content and decide whether the destination has to be
+  // replaced.  With forceWrite the temporary file is always written.
+  Result Finish(bool forceWrite)
+  {
+    this->FlushBuffer();
+    this->Start();
+    if (this->Matching && !forceWrite && !this->Error) {
+      if (fgetc(this->Old) == EOF && !ferror(this->Old)) {
+        return Unchanged;
+      }
+    }
+    if (!this->Temp) {
+      this->Diverge();
+    }
+    if (this->Temp) {
+      if (fclose(this->Temp) != 0) {
+        this->Error = true;
+      }
+      this->Temp = CM_NULLPTR;
+    }
+    return this->Error ? Failed : Changed;
+  }
+
+protected:
+  int_type overflow(int_type c) CM_OVERRIDE
+  {
+    if (!this->FlushBuffer()) {
+      return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *this->pptr() = traits_type::to_char_type(c);
+      this->pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  int sync() CM_OVERRIDE { return this->FlushBuffer() ? 0 : -1; }
+
+private:
+  bool FlushBuffer()
+  {
+    char* data = this->pbase();
+    size_t const size = static_cast<size_t>(this->pptr() - data);
+    this->setp(&this->Buffer[0], &this->Buffer[0] + this->Buffer.size());
+    return size == 0 || this->Consume(data, size);
+  }
+
+  // Open the destination only once content arrives in case the
+  // stream was renamed after construction.
+  void Start()
+  {
+    if (!this->Started) {
+      this->Started = true;
+      this->Old = cmsys::SystemTools::Fopen(this->Name, "rb");
+      this->Matching = this->Old != CM_NULLPTR;
+    }
+  }
+
+  bool Consume(char const* data, size_t size)
+  {
+    if (this->Error) {
+      return false;
+    }
+    this->Start();
+    if (this->Matching) {
+      this->OldChunk.resize(size);
+      if (fread(&this->OldChunk[0], 1, size, this->Old) == size &&
+          memcmp(&this->OldChunk[0], data, size) == 0) {
+        this->Matched += size;
+        return true;
+      }
+      if (!this->Diverge()) {
+        return false;
+      }
+    }
+    if (!this->Temp && !this->Diverge()) {
+      return false;
+    }
+    if (fwrite(data, 1, size, this->Temp) != size) {
+      this->Error = true;
+    }
+    return !this->Error;
+  }
+
+  // Start writing the temporary file with the content matched so far.
+  bool Diverge()
+  {
+    this->Matching = false;
+    this->Temp = cmsys::SystemTools::Fopen(this->TempName, "wb");
+    if (!this->Temp) {
+      this->Error = true;
+      return false;
+    }
+    if (this->Old) {
+      if (fseek(this->Old, 0, SEEK_SET) != 0) {
+        this->Error = true;
+      }
+      // The pending content may live in Buffer so copy through OldChunk.
+      KWIML_INT_uint64_t remaining = this->Matched;
+      size_t const chunkSize = 1 << 16;
+      this->OldChunk.resize(chunkSize);
+      char* chunk = &this->OldChunk[0];
+      while (remaining > 0 && !this->Error) {
+        size_t n = remaining < chunkSize ? static_cast<size_t>(remaining)
+                                         : chunkSize;
+        if (fread(chunk, 1, n, this->Old) != n ||
+            fwrite(chunk, 1, n, this->Temp) != n) {
+          this->Error = true;
+        }
+        remaining -= n;
+      }
+      fclose(this->Old);
+      this->Old = CM_NULLPTR;
+    }
+    return !this->Error;
+  }
+
+  std::string const& Name;
+  std::string const& TempName;
+  std::vector<char> Buffer;
+  std::vector<char> OldChunk;
+  FILE* Old;
+  FILE* Temp;
+  bool Started;
+  bool Matching;
+  bool Error;
+  KWIML_INT_uint64_t Matched;
+};
+
 cmGeneratedFileStream::cmGeneratedFileStream(Encoding encoding)
   : cmGeneratedFileStreamBase()
   , Stream()
 {
 #ifdef CMAKE_BUILD_WITH_CMAKE
   if (encoding != codecvt::None) {
+    this->Encoded = true;
     imbue(std::locale(getloc(), new codecvt(encoding)));
   }
 #else
@@ -37,6 +216,7 @@ cmGeneratedFileStream::cmGeneratedFileStream(const char* name, bool quiet,
   }
 #ifdef CMAKE_BUILD_WITH_CMAKE
   if (encoding != codecvt::None) {
+    this->Encoded = true;
     imbue(std::locale(getloc(), new codecvt(encoding)));
   }
 #else
@@ -82,6 +262,12 @@ bool cmGeneratedFileStream::Close()
   // Save whether the temporary output file is valid before closing.
   this->Okay = !this->fail();
 
+  // Detach the comparing buffer before the base finishes it.  The file
+  // buffer it replaced was closed already so the stream is marked failed.
+  if (this->CompareBuffer) {
+    this->std::ostream::rdbuf(this->Stream::rdbuf());
+  }
+
   // Close the temporary output file.
   this->Stream::close();
 
@@ -92,6 +278,21 @@ bool cmGeneratedFileStream::Close()
 void cmGeneratedFileStream::SetCopyIfDifferent(bool copy_if_different)
 {
   this->CopyIfDifferent = copy_if_different;
+
+#if !defined(_WIN32)
+  // If nothing has been written yet, replace the temporary file by a
+  // buffer comparing the content against the destination as it comes.
+  // The kwsys streams on Windows manage their own buffer so keep the
+  // temporary file there.
+  if (copy_if_different && !this->CompareBuffer && !this->Compress &&
+      !this->Encoded && this->is_open() && this->tellp() == 0) {
+    this->Stream::rdbuf()->close();
+    cmSystemTools::RemoveFile(this->TempName);
+    this->CompareBuffer =
+      new cmGeneratedFileStreamCompareBuffer(this->Name, this->TempName);
+    this->std::ostream::rdbuf(this->CompareBuffer);
+  }
+#endif
 }
 
 void cmGeneratedFileStream::SetCompression(bool compression)
@@ -111,6 +312,8 @@ cmGeneratedFileStreamBase::cmGeneratedFileStreamBase()
   , Okay(false)
   , Compress(false)
   , CompressExtraExtension(true)
+  , Encoded(false)
+  , CompareBuffer(CM_NULLPTR)
 {
 }
 
@@ -121,6 +324,8 @@ cmGeneratedFileStreamBase::cmGeneratedFileStreamBase(const char* name)
   , Okay(false)
   , Compress(false)
   , CompressExtraExtension(true)
+  , Encoded(false)
+  , CompareBuffer(CM_NULLPTR)
 {
   this->Open(name);
 }
@@ -159,10 +364,32 @@ bool cmGeneratedFileStreamBase::Close()
     resname += ".gz";
   }
 
+  // Finish the comparison made while the content was written.  The
+  // temporary file exists only if the content differs.
+  bool compared = false;
+  if (this->CompareBuffer) {
+    if (this->Okay) {
+      switch (this->CompareBuffer->Finish(this->Compress)) {
+        case cmGeneratedFileStreamCompareBuffer::Unchanged:
+          this->Okay = false;
+          break;
+        case cmGeneratedFileStreamCompareBuffer::Changed:
+          compared = !this->Compress;
+          break;
+        case cmGeneratedFileStreamCompareBuffer::Failed:
+          cmSystemTools::Error("Cannot write file: ", this->TempName.c_str());
+          this->Okay = false;
+          break;
+      }
+    }
+    delete this->CompareBuffer;
+    this->CompareBuffer = CM_NULLPTR;
+  }
+
   // Only consider replacing the destination file if no error
   // occurred.
   if (!this->Name.empty() && this->Okay &&
-      (!this->CopyIfDifferent ||
+      (!this->CopyIfDifferent || compared ||
        cmSystemTools::FilesDiffer(this->TempName, resname))) {
     // The destination is to be replaced.  Rename the temporary to the
     // destination atomically.
@@ -175,6 +402,7 @@ bool cmGeneratedFileStreamBase::Close()
     } else {
       this->RenameFile(this->TempName.c_str(), resname.c_str());
     }
+    cmPathCache::InvalidatePath(resname);
 
     replaced = true;
   }
@@ -9,6 +9,8 @@
 #include "cmsys/FStream.hxx"
 #include <string>
 
+class cmGeneratedFileStreamCompareBuffer;
+
 // This is the first base class of cmGeneratedFileStream.  It will be
 // created before and destroyed after the ofstream portion and can
 // therefore be used to manage the temporary file.
@@ -55,6 +57,14 @@ protected:
 
   // Whether the destination file is compressed
   bool CompressExtraExtension;
+
+  // Whether the content is converted to a non-default encoding.
+  bool Encoded;
+
+  // Buffer comparing copy-if-different output against the destination
+  // while it is written.  The temporary file is created only if the
+  // content differs.
+  cmGeneratedFileStreamCompareBuffer* CompareBuffer;
 };
 
 /** \class cmGeneratedFileStream
@@ -12,6 +12,7 @@
 #include "cmListFileCache.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
+#include "cmPathCache.h"
 #include "cmSourceFile.h"
 #include "cmSystemTools.h"
 #include "cm_auto_ptr.hxx"
@@ -85,6 +86,7 @@ void cmGeneratorExpressionEvaluationFile::Generate(
   this->Files.push_back(outputFileName);
   outputFiles[outputFileName] = outputContent;
 
+  cmPathCache::InvalidatePath(outputFileName);
   cmGeneratedFileStream fout(outputFileName.c_str());
   fout.SetCopyIfDifferent(true);
   fout << outputContent;
@@ -452,6 +452,37 @@ void cmGeneratorTarget::ComputeObjectMapping()
   }
 }
 
+bool cmGeneratorTarget::GetObjectSourcesToName(
+  std::vector<cmSourceFile const*>& data) const
+{
+  if (!this->Objects.empty()) {
+    return false;
+  }
+
+  // ComputeObjectMapping names the sources of the first configuration
+  // that has any.
+  std::vector<std::string> configs;
+  this->Makefile->GetConfigurations(configs);
+  if (configs.empty()) {
+    configs.push_back("");
+  }
+  for (std::vector<std::string>::const_iterator ci = configs.begin();
+       ci != configs.end(); ++ci) {
+    std::string const& config = *ci;
+    IMPLEMENT_VISIT(SourceKindObjectSource);
+    if (!data.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void cmGeneratorTarget::SetObjectNames(
+  std::map<cmSourceFile const*, std::string>& objects)
+{
+  this->Objects.swap(objects);
+}
+
 const char* cmGeneratorTarget::GetFeature(const std::string& feature,
                                           const std::string& config) const
 {
@@ -546,12 +577,10 @@ const std::string& cmGeneratorTarget::GetObjectName(cmSourceFile const* file)
 
 const char* cmGeneratorTarget::GetCustomObjectExtension() const
 {
-  static std::string extension;
   const bool has_ptx_extension =
     this->GetPropertyAsBool("CUDA_PTX_COMPILATION");
   if (has_ptx_extension) {
-    extension = ".ptx";
-    return extension.c_str();
+    return ".ptx";
   }
   return CM_NULLPTR;
 }
@@ -2959,7 +2988,17 @@ std::string cmGeneratorTarget::GetFullPath(const std::string& config,
   if (this->IsImported()) {
     return this->Target->ImportedGetFullPath(config, artifact);
   }
-  return this->NormalGetFullPath(config, artifact, realname);
+
+  // The full path is needed once for every target that links to this
+  // one, so compute it only once per configuration.
+  FullPathKey key(OutputNameKey(config, artifact), realname);
+  FullPathMapType::iterator i = this->FullPathMap.find(key);
+  if (i == this->FullPathMap.end()) {
+    FullPathMapType::value_type entry(
+      key, this->NormalGetFullPath(config, artifact, realname));
+    i = this->FullPathMap.insert(entry).first;
+  }
+  return i->second;
 }
 
 std::string cmGeneratorTarget::NormalGetFullPath(
@@ -4288,7 +4327,8 @@ void cmGeneratorTarget::LookupLinkItems(std::vector<std::string> const& names,
 void cmGeneratorTarget::ExpandLinkItems(
   std::string const& prop, std::string const& value, std::string const& config,
   cmGeneratorTarget const* headTarget, bool usage_requirements_only,
-  std::vector<cmLinkItem>& items, bool& hadHeadSensitiveCondition) const
+  std::vector<cmLinkItem>& items, bool& hadHeadSensitiveCondition,
+  bool& hadContextSensitiveCondition) const
 {
   cmGeneratorExpression ge;
   cmGeneratorExpressionDAGChecker dagChecker(this->GetName(), prop, CM_NULLPTR,
@@ -4306,6 +4346,7 @@ void cmGeneratorTarget::ExpandLinkItems(
                                     libs);
   this->LookupLinkItems(libs, items);
   hadHeadSensitiveCondition = cge->GetHadHeadSensitiveCondition();
+  hadContextSensitiveCondition = cge->GetHadContextSensitiveCondition();
 }
 
 cmLinkInterface const* cmGeneratorTarget::GetLinkInterface(
@@ -4761,7 +4802,12 @@ void cmGeneratorTarget::ComputeLinkInterfaceLibraries(
     // The interface libraries have been explicitly set.
     this->ExpandLinkItems(linkIfaceProp, explicitLibraries, config, headTarget,
                           usage_requirements_only, iface.Libraries,
-                          iface.HadHeadSensitiveCondition);
+                          iface.HadHeadSensitiveCondition,
+                          iface.HadContextSensitiveCondition);
+    // The old interface properties have per-configuration variants.
+    if (linkIfaceProp != "INTERFACE_LINK_LIBRARIES") {
+      iface.HadContextSensitiveCondition = true;
+    }
   } else if (this->GetPolicyStatusCMP0022() == cmPolicies::WARN ||
              this->GetPolicyStatusCMP0022() == cmPolicies::OLD)
   // If CMP0022 is NEW then the plain tll signature sets the
@@ -4774,6 +4820,18 @@ void cmGeneratorTarget::ComputeLinkInterfaceLibraries(
       this->GetLinkImplementationLibrariesInternal(config, headTarget);
     iface.Libraries.insert(iface.Libraries.end(), impl->Libraries.begin(),
                            impl->Libraries.end());
+    iface.HadContextSensitiveCondition = impl->HadContextSensitiveCondition;
+    // The old interface properties were looked up for this configuration
+    // only, and may be set for others.
+    if (!linkIfaceProp.empty()) {
+      static std::string const oldProp = "LINK_INTERFACE_LIBRARIES";
+      cmPropertyMap const& props = this->Target->GetProperties();
+      cmPropertyMap::const_iterator pi = props.lower_bound(oldProp);
+      if (pi != props.end() &&
+          pi->first.compare(0, oldProp.size(), oldProp) == 0) {
+        iface.HadContextSensitiveCondition = true;
+      }
+    }
     if (this->GetPolicyStatusCMP0022() == cmPolicies::WARN &&
         !this->PolicyWarnedCMP0022 && !usage_requirements_only) {
       // Compare the link implementation fallback link interface to the
@@ -4782,9 +4840,11 @@ void cmGeneratorTarget::ComputeLinkInterfaceLibraries(
       static const std::string newProp = "INTERFACE_LINK_LIBRARIES";
       if (const char* newExplicitLibraries = this->GetProperty(newProp)) {
         bool hadHeadSensitiveConditionDummy = false;
+        bool hadContextSensitiveConditionDummy = false;
         this->ExpandLinkItems(newProp, newExplicitLibraries, config,
                               headTarget, usage_requirements_only, ifaceLibs,
-                              hadHeadSensitiveConditionDummy);
+                              hadHeadSensitiveConditionDummy,
+                              hadContextSensitiveConditionDummy);
       }
       if (ifaceLibs != iface.Libraries) {
         std::string oldLibraries = cmJoin(impl->Libraries, ";");
@@ -4846,7 +4906,19 @@ const cmLinkInterface* cmGeneratorTarget::GetImportLinkInterface(
     cmSystemTools::ExpandListArgument(info->Languages, iface.Languages);
     this->ExpandLinkItems(info->LibrariesProp, info->Libraries, config,
                           headTarget, usage_requirements_only, iface.Libraries,
-                          iface.HadHeadSensitiveCondition);
+                          iface.HadHeadSensitiveCondition,
+                          iface.HadContextSensitiveCondition);
+    // The old imported interface properties have per-configuration
+    // variants.
+    if (info->LibrariesProp != "INTERFACE_LINK_LIBRARIES") {
+      static std::string const oldProp = "IMPORTED_LINK_INTERFACE_LIBRARIES";
+      cmPropertyMap const& props = this->Target->GetProperties();
+      cmPropertyMap::const_iterator pi = props.lower_bound(oldProp);
+      if (pi != props.end() &&
+          pi->first.compare(0, oldProp.size(), oldProp) == 0) {
+        iface.HadContextSensitiveCondition = true;
+      }
+    }
     std::vector<std::string> deps;
     cmSystemTools::ExpandListArgument(info->SharedDeps, deps);
     this->LookupLinkItems(deps, iface.SharedDeps);
@@ -5331,6 +5403,9 @@ void cmGeneratorTarget::ComputeLinkImplementationLibraries(
     if (cge->GetHadHeadSensitiveCondition()) {
       impl.HadHeadSensitiveCondition = true;
     }
+    if (cge->GetHadContextSensitiveCondition()) {
+      impl.HadContextSensitiveCondition = true;
+    }
 
     for (std::vector<std::string>::const_iterator li = llibs.begin();
          li != llibs.end(); ++li) {
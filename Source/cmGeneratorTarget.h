@@ -142,6 +142,14 @@ public:
                       const std::string& config) const;
   void GetExternalObjects(std::vector<cmSourceFile const*>&,
                           const std::string& config) const;
+
+  /** Whether the sources may differ between configurations.  Known
+      once the sources of one configuration have been computed.  */
+  bool GetHadContextSensitiveSources() const
+  {
+    return this->LinkImplementationLanguageIsContextDependent;
+  }
+
   void GetHeaderSources(std::vector<cmSourceFile const*>&,
                         const std::string& config) const;
   void GetExtraSources(std::vector<cmSourceFile const*>&,
@@ -167,6 +175,13 @@ public:
 
   void ComputeObjectMapping();
 
+  /** Get the sources whose object file names ComputeObjectMapping would
+      compute.  Returns false if the names are already known.  */
+  bool GetObjectSourcesToName(std::vector<cmSourceFile const*>& data) const;
+
+  /** Store object file names computed ahead of time.  */
+  void SetObjectNames(std::map<cmSourceFile const*, std::string>& objects);
+
   const char* GetFeature(const std::string& feature,
                          const std::string& config) const;
 
@@ -784,7 +799,8 @@ private:
                        const cmGeneratorTarget* headTarget,
                        bool usage_requirements_only,
                        std::vector<cmLinkItem>& items,
-                       bool& hadHeadSensitiveCondition) const;
+                       bool& hadHeadSensitiveCondition,
+                       bool& hadContextSensitiveCondition) const;
   void LookupLinkItems(std::vector<std::string> const& names,
                        std::vector<cmLinkItem>& items) const;
 
@@ -816,6 +832,9 @@ private:
   typedef std::pair<std::string, cmStateEnums::ArtifactType> OutputNameKey;
   typedef std::map<OutputNameKey, std::string> OutputNameMapType;
   mutable OutputNameMapType OutputNameMap;
+  typedef std::pair<OutputNameKey, bool> FullPathKey;
+  typedef std::map<FullPathKey, std::string> FullPathMapType;
+  mutable FullPathMapType FullPathMap;
   mutable std::set<cmLinkItem> UtilityItems;
   cmPolicies::PolicyMap PolicyMap;
   mutable bool PolicyWarnedCMP0022;
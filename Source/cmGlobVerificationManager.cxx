@@ -0,0 +1,140 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmGlobVerificationManager.h"
+
+#include <ostream>
+
+#include "cmGeneratedFileStream.h"
+#include "cmOutputConverter.h"
+#include "cmPathCache.h"
+#include "cmSystemTools.h"
+#include "cmVersion.h"
+#include "cmsys/FStream.hxx"
+
+cmGlobVerificationManager::cmGlobVerificationManager()
+{
+}
+
+bool cmGlobVerificationManager::CacheEntryKey::operator<(
+  CacheEntryKey const& r) const
+{
+  if (this->Recurse != r.Recurse) {
+    return this->Recurse < r.Recurse;
+  }
+  if (this->ListDirectories != r.ListDirectories) {
+    return this->ListDirectories < r.ListDirectories;
+  }
+  if (this->FollowSymlinks != r.FollowSymlinks) {
+    return this->FollowSymlinks < r.FollowSymlinks;
+  }
+  if (this->Relative != r.Relative) {
+    return this->Relative < r.Relative;
+  }
+  return this->Expression < r.Expression;
+}
+
+void cmGlobVerificationManager::CacheEntryKey::PrintGlobCommand(
+  std::ostream& out, std::string const& cmdVar) const
+{
+  out << "file(GLOB" << (this->Recurse ? "_RECURSE " : " ") << cmdVar
+      << " LIST_DIRECTORIES "
+      << (this->ListDirectories ? "true" : "false");
+  if (this->Recurse && this->FollowSymlinks) {
+    out << " FOLLOW_SYMLINKS";
+  }
+  if (!this->Relative.empty()) {
+    out << " RELATIVE "
+        << cmOutputConverter::EscapeForCMake(this->Relative);
+  }
+  out << " " << cmOutputConverter::EscapeForCMake(this->Expression) << ")";
+}
+
+void cmGlobVerificationManager::AddCacheEntry(
+  bool recurse, bool listDirectories, bool followSymlinks,
+  std::string const& relative, std::string const& expression,
+  std::vector<std::string> const& files, std::string const& variable,
+  cmListFileBacktrace const& bt)
+{
+  CacheEntryKey key;
+  key.Recurse = recurse;
+  key.ListDirectories = listDirectories;
+  key.FollowSymlinks = followSymlinks;
+  key.Relative = relative;
+  key.Expression = expression;
+  CacheEntryValue& value = this->Cache[key];
+  // A later glob of the same expression sees the newer state of the
+  // file system, which the build will also see.
+  value.Files = files;
+  value.Backtraces.push_back(std::make_pair(variable, bt));
+}
+
+void cmGlobVerificationManager::Reset()
+{
+  this->Cache.clear();
+  this->VerifyScript.clear();
+  this->VerifyStamp.clear();
+}
+
+bool cmGlobVerificationManager::SaveVerificationScript(std::string const& path)
+{
+  this->VerifyScript.clear();
+  this->VerifyStamp.clear();
+  if (this->Cache.empty()) {
+    return true;
+  }
+
+  std::string const script = path + "/VerifyGlobs.cmake";
+  std::string const stamp = path + "/cmake.verify_globs";
+  cmGeneratedFileStream fout(script.c_str());
+  fout.SetCopyIfDifferent(true);
+  fout << "# CMAKE generated file: DO NOT EDIT!\n"
+       << "# Generated by CMake Version " << cmVersion::GetMajorVersion()
+       << "." << cmVersion::GetMinorVersion() << "\n"
+       << "\n"
+       << "cmake_policy(SET CMP0009 NEW)\n";
+
+  for (CacheEntryMap::const_iterator ci = this->Cache.begin();
+       ci != this->Cache.end(); ++ci) {
+    CacheEntryKey const& key = ci->first;
+    CacheEntryValue const& value = ci->second;
+
+    fout << "\n";
+    for (std::vector<std::pair<std::string, cmListFileBacktrace> >::
+           const_iterator bi = value.Backtraces.begin();
+         bi != value.Backtraces.end(); ++bi) {
+      fout << "# " << bi->first;
+      bi->second.PrintTitle(fout);
+      fout << "\n";
+    }
+    key.PrintGlobCommand(fout, "NEW_GLOB");
+    fout << "\nset(OLD_GLOB\n";
+    for (std::vector<std::string>::const_iterator fi = value.Files.begin();
+         fi != value.Files.end(); ++fi) {
+      fout << "  " << cmOutputConverter::EscapeForCMake(*fi) << "\n";
+    }
+    fout << "  )\n"
+         << "if(NOT \"${NEW_GLOB}\" STREQUAL \"${OLD_GLOB}\")\n"
+         << "  message(STATUS \"Glob result changed: \" "
+         << cmOutputConverter::EscapeForCMake(key.Expression) << ")\n"
+         << "  file(WRITE " << cmOutputConverter::EscapeForCMake(stamp)
+         << " \"\")\n"
+         << "  return()\n"
+         << "endif()\n";
+  }
+  if (!fout.Close()) {
+    return false;
+  }
+
+  // The build system depends on the stamp, so it must not be newer than
+  // the files generated after it.
+  cmsys::ofstream sout(stamp.c_str());
+  if (!sout) {
+    return false;
+  }
+  sout.close();
+  cmPathCache::InvalidatePath(stamp);
+
+  this->VerifyScript = script;
+  this->VerifyStamp = stamp;
+  return true;
+}
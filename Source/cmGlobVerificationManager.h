@@ -0,0 +1,76 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmGlobVerificationManager_h
+#define cmGlobVerificationManager_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cmListFileCache.h"
+
+/** \class cmGlobVerificationManager
+ * \brief Globs whose results the build system re-checks.
+ *
+ * file(GLOB) and file(GLOB_RECURSE) record each expression given after
+ * CONFIGURE_DEPENDS with its result.  The generators that support it run
+ * the script written by SaveVerificationScript() on every build.  It
+ * globs again and, if any result changed, touches a stamp file that the
+ * build system depends on, so that CMake re-runs.
+ */
+class cmGlobVerificationManager
+{
+  CM_DISABLE_COPY(cmGlobVerificationManager)
+
+public:
+  cmGlobVerificationManager();
+
+  /** Record a glob and its sorted result.  */
+  void AddCacheEntry(bool recurse, bool listDirectories, bool followSymlinks,
+                     std::string const& relative,
+                     std::string const& expression,
+                     std::vector<std::string> const& files,
+                     std::string const& variable,
+                     cmListFileBacktrace const& bt);
+
+  /** Forget the recorded globs before configuring again.  */
+  void Reset();
+
+  /** Write the verification script and the stamp file into the given
+      CMakeFiles directory if any glob was recorded.  */
+  bool SaveVerificationScript(std::string const& path);
+
+  /** Get the script and stamp file, or empty strings if no glob was
+      recorded.  */
+  std::string const& GetVerifyScript() const { return this->VerifyScript; }
+  std::string const& GetVerifyStamp() const { return this->VerifyStamp; }
+
+private:
+  struct CacheEntryKey
+  {
+    bool Recurse;
+    bool ListDirectories;
+    bool FollowSymlinks;
+    std::string Relative;
+    std::string Expression;
+    bool operator<(CacheEntryKey const& r) const;
+    void PrintGlobCommand(std::ostream& out, std::string const& cmdVar) const;
+  };
+
+  struct CacheEntryValue
+  {
+    std::vector<std::string> Files;
+    std::vector<std::pair<std::string, cmListFileBacktrace> > Backtraces;
+  };
+
+  typedef std::map<CacheEntryKey, CacheEntryValue> CacheEntryMap;
+  CacheEntryMap Cache;
+  std::string VerifyScript;
+  std::string VerifyStamp;
+};
+
+#endif
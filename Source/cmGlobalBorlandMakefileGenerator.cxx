@@ -18,6 +18,7 @@ cmGlobalBorlandMakefileGenerator::cmGlobalBorlandMakefileGenerator(cmake* cm)
   this->UseLinkScript = false;
   cm->GetState()->SetWindowsShell(true);
   this->IncludeDirective = "!include";
+  this->OptionalIncludeDirective = "";
   this->DefineWindowsNULL = true;
   this->PassMakeflags = true;
   this->UnixCD = false;
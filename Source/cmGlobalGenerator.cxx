@@ -39,6 +39,7 @@
 #include "cmStateDirectory.h"
 #include "cmStateTypes.h"
 #include "cmVersion.h"
+#include "cmWorkerPool.h"
 #include "cmWorkingDirectory.h"
 #include "cmake.h"
 
@@ -1323,6 +1324,14 @@ bool cmGlobalGenerator::Compute()
     return false;
   }
 
+  if (!this->ComputeFocusTargets()) {
+    return false;
+  }
+
+  if (this->NamesObjectsBySourcePath()) {
+    this->ComputeTargetObjectNames();
+  }
+
   for (i = 0; i < this->LocalGenerators.size(); ++i) {
     this->LocalGenerators[i]->ComputeHomeRelativeOutputPath();
   }
@@ -1330,6 +1339,108 @@ bool cmGlobalGenerator::Compute()
   return true;
 }
 
+namespace {
+class cmGlobalGeneratorObjectNamesJob : public cmWorkerPool::Job
+{
+public:
+  cmGlobalGeneratorObjectNamesJob(cmGeneratorTarget* gt)
+    : Target(gt)
+    , CustomExtension(gt->GetCustomObjectExtension())
+  {
+  }
+
+  void Process() CM_OVERRIDE
+  {
+    cmLocalGenerator const* lg = this->Target->GetLocalGenerator();
+    this->Names.resize(this->Sources.size());
+    for (size_t i = 0; i < this->Sources.size(); ++i) {
+      this->Names[i] = lg->ComputeObjectFileName(
+        *this->Sources[i], this->ReplaceExtension[i], CM_NULLPTR,
+        this->CustomExtension);
+    }
+  }
+
+  cmGeneratorTarget* Target;
+  char const* CustomExtension;
+  std::vector<cmSourceFile const*> Sources;
+  std::vector<bool> ReplaceExtension;
+  std::vector<std::string> Names;
+};
+}
+
+void cmGlobalGenerator::ComputeTargetObjectNames()
+{
+  // Collect the sources to name and everything that needs the
+  // makefiles.  Object sources of other targets referenced by
+  // $<TARGET_OBJECTS> may already be named while doing so.
+  std::vector<cmGlobalGeneratorObjectNamesJob*> jobs;
+  for (unsigned int i = 0; i < this->LocalGenerators.size(); ++i) {
+    cmLocalGenerator* lg = this->LocalGenerators[i];
+    std::map<std::string, bool> replaceExtension;
+    std::vector<cmGeneratorTarget*> const& targets =
+      lg->GetGeneratorTargets();
+    for (std::vector<cmGeneratorTarget*>::const_iterator ti = targets.begin();
+         ti != targets.end(); ++ti) {
+      cmGeneratorTarget* gt = *ti;
+      if (gt->GetType() == cmStateEnums::INTERFACE_LIBRARY ||
+          !this->IsTargetInFocus(gt)) {
+        continue;
+      }
+      std::vector<cmSourceFile const*> sources;
+      if (!gt->GetObjectSourcesToName(sources)) {
+        continue;
+      }
+      cmGlobalGeneratorObjectNamesJob* job =
+        new cmGlobalGeneratorObjectNamesJob(gt);
+      job->Sources.swap(sources);
+      for (std::vector<cmSourceFile const*>::const_iterator si =
+             job->Sources.begin();
+           si != job->Sources.end(); ++si) {
+        std::string const lang = (*si)->GetLanguage();
+        std::map<std::string, bool>::iterator ri =
+          replaceExtension.find(lang);
+        if (ri == replaceExtension.end()) {
+          ri = replaceExtension
+                 .insert(std::make_pair(
+                   lang, lg->ReplaceObjectFileExtension(**si)))
+                 .first;
+        }
+        job->ReplaceExtension.push_back(ri->second);
+      }
+      jobs.push_back(job);
+    }
+  }
+
+  // Compute the names concurrently.
+  unsigned long threads = 0;
+  if (const char* value =
+        this->LocalGenerators[0]->GetMakefile()->GetDefinition(
+          "CMAKE_GENERATE_THREADS")) {
+    if (!cmSystemTools::StringToULong(value, &threads)) {
+      threads = 0;
+    }
+  }
+  cmWorkerPool pool(static_cast<unsigned int>(threads));
+  std::vector<cmWorkerPool::Job*> const poolJobs(jobs.begin(), jobs.end());
+  pool.Process(poolJobs);
+
+  // Make the names safe and unique in a deterministic order.
+  for (std::vector<cmGlobalGeneratorObjectNamesJob*>::const_iterator ji =
+         jobs.begin();
+       ji != jobs.end(); ++ji) {
+    cmGlobalGeneratorObjectNamesJob* job = *ji;
+    cmGeneratorTarget* gt = job->Target;
+    std::map<cmSourceFile const*, std::string> objects;
+    for (size_t i = 0; i < job->Sources.size(); ++i) {
+      objects[job->Sources[i]] =
+        gt->LocalGenerator->CreateSafeUniqueObjectFileName(
+          job->Names[i], gt->ObjectDirectory);
+    }
+    gt->SetObjectNames(objects);
+  }
+  cmDeleteAll(jobs);
+}
+
 void cmGlobalGenerator::Generate()
 {
   // Create a map from local generator to the complete set of targets
@@ -1427,6 +1538,64 @@ bool cmGlobalGenerator::ComputeTargetDepends()
   return true;
 }
 
+bool cmGlobalGenerator::ComputeFocusTargets()
+{
+  this->FocusTargets.clear();
+  const char* var = this->GetFocusTargetsVariable();
+  if (!var) {
+    return true;
+  }
+  cmMakefile* mf = this->LocalGenerators[0]->GetMakefile();
+  std::vector<std::string> names;
+  cmSystemTools::ExpandListArgument(mf->GetSafeDefinition(var), names);
+  if (names.empty()) {
+    return true;
+  }
+
+  std::vector<cmGeneratorTarget const*> queue;
+  for (std::vector<std::string>::const_iterator ni = names.begin();
+       ni != names.end(); ++ni) {
+    cmGeneratorTarget const* gt = this->FindGeneratorTarget(*ni);
+    if (!gt || gt->IsImported()) {
+      std::ostringstream e;
+      e << "The " << var << " variable names target \"" << *ni
+        << "\" which does not exist in the project.";
+      mf->IssueMessage(cmake::FATAL_ERROR, e.str());
+      return false;
+    }
+    queue.push_back(gt);
+  }
+
+  // Targets like install and rebuild_cache are always available.
+  for (unsigned int i = 0; i < this->LocalGenerators.size(); ++i) {
+    std::vector<cmGeneratorTarget*> const& targets =
+      this->LocalGenerators[i]->GetGeneratorTargets();
+    for (std::vector<cmGeneratorTarget*>::const_iterator ti = targets.begin();
+         ti != targets.end(); ++ti) {
+      if ((*ti)->GetType() == cmStateEnums::GLOBAL_TARGET) {
+        queue.push_back(*ti);
+      }
+    }
+  }
+
+  // Add everything the targets depend on.
+  while (!queue.empty()) {
+    cmGeneratorTarget const* gt = queue.back();
+    queue.pop_back();
+    if (this->FocusTargets.insert(gt).second) {
+      TargetDependSet const& deps = this->GetTargetDirectDepends(gt);
+      queue.insert(queue.end(), deps.begin(), deps.end());
+    }
+  }
+  return true;
+}
+
+bool cmGlobalGenerator::IsTargetInFocus(cmGeneratorTarget const* target) const
+{
+  return this->FocusTargets.empty() ||
+    this->FocusTargets.find(target) != this->FocusTargets.end();
+}
+
 std::vector<const cmGeneratorTarget*>
 cmGlobalGenerator::CreateQtAutoGeneratorsTargets()
 {
@@ -1620,6 +1789,7 @@ void cmGlobalGenerator::ClearGeneratorMembers()
 
   this->ExportSets.clear();
   this->TargetDependencies.clear();
+  this->FocusTargets.clear();
   this->TargetSearchIndex.clear();
   this->GeneratorTargetSearchIndex.clear();
   this->MakefileSearchIndex.clear();
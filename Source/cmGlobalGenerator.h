@@ -316,6 +316,11 @@ public:
   TargetDependSet const& GetTargetDirectDepends(
     const cmGeneratorTarget* target);
 
+  /** Return whether build rules are generated for the given target.
+      This is false only for targets outside the transitive dependencies
+      of the targets a generator has been asked to focus on.  */
+  bool IsTargetInFocus(cmGeneratorTarget const* target) const;
+
   const std::map<std::string, std::vector<cmLocalGenerator*> >& GetProjectMap()
     const
   {
@@ -420,6 +425,23 @@ protected:
 
   virtual bool ComputeTargetDepends();
 
+  /** Return whether the local generators name every object file by
+      cmLocalGenerator::GetObjectFileNameWithoutTarget, so that the
+      names can be computed ahead of generation.  */
+  virtual bool NamesObjectsBySourcePath() const { return false; }
+
+  /** Compute the object file names of all targets, concurrently where
+      possible.  */
+  void ComputeTargetObjectNames();
+
+  /** Return the name of a variable listing the targets to generate
+      build rules for, if the generator supports restricting them.  */
+  virtual const char* GetFocusTargetsVariable() const { return CM_NULLPTR; }
+
+  /** Compute the targets to generate build rules for from the targets
+      listed by GetFocusTargetsVariable().  */
+  bool ComputeFocusTargets();
+
   virtual bool CheckALLOW_DUPLICATE_CUSTOM_TARGETS() const;
 
   std::vector<const cmGeneratorTarget*> CreateQtAutoGeneratorsTargets();
@@ -546,6 +568,9 @@ private:
   typedef std::map<cmGeneratorTarget const*, TargetDependSet> TargetDependMap;
   TargetDependMap TargetDependencies;
 
+  // Targets with build rules when the generator focuses on some targets.
+  std::set<cmGeneratorTarget const*> FocusTargets;
+
   friend class cmake;
   void CreateGeneratorTargets(
     TargetTypes targetTypes, cmMakefile* mf, cmLocalGenerator* lg,
@@ -16,6 +16,7 @@ cmGlobalJOMMakefileGenerator::cmGlobalJOMMakefileGenerator(cmake* cm)
   this->UseLinkScript = false;
   cm->GetState()->SetWindowsShell(true);
   cm->GetState()->SetNMake(true);
+  this->OptionalIncludeDirective = "";
   this->DefineWindowsNULL = true;
   this->PassMakeflags = true;
   this->UnixCD = false;
@@ -19,6 +19,7 @@
 #include "cmGeneratedFileStream.h"
 #include "cmGeneratorExpressionEvaluationFile.h"
 #include "cmGeneratorTarget.h"
+#include "cmGlobVerificationManager.h"
 #include "cmLocalGenerator.h"
 #include "cmLocalNinjaGenerator.h"
 #include "cmMakefile.h"
@@ -459,6 +460,14 @@ void cmGlobalNinjaGenerator::WriteInclude(std::ostream& os,
   os << "include " << filename << "\n";
 }
 
+void cmGlobalNinjaGenerator::WriteSubninja(std::ostream& os,
+                                           const std::string& filename,
+                                           const std::string& comment)
+{
+  cmGlobalNinjaGenerator::WriteComment(os, comment);
+  os << "subninja " << filename << "\n";
+}
+
 void cmGlobalNinjaGenerator::WriteDefault(std::ostream& os,
                                           const cmNinjaDeps& targets,
                                           const std::string& comment)
@@ -477,6 +486,8 @@ cmGlobalNinjaGenerator::cmGlobalNinjaGenerator(cmake* cm)
   , BuildFileStream(CM_NULLPTR)
   , RulesFileStream(CM_NULLPTR)
   , CompileCommandsStream(CM_NULLPTR)
+  , SubninjaPerDirectory(false)
+  , TopBuildFileStream(CM_NULLPTR)
   , Rules()
   , AllDependencies()
   , UsingGCCOnWindows(false)
@@ -552,12 +563,18 @@ void cmGlobalNinjaGenerator::Generate()
     (this->PolicyCMP0058 == cmPolicies::OLD ||
      this->PolicyCMP0058 == cmPolicies::WARN);
 
+  this->SubninjaPerDirectory =
+    this->LocalGenerators[0]->GetMakefile()->IsOn(
+      "CMAKE_NINJA_SUBNINJA_PER_DIRECTORY");
+  this->SubninjaFiles.clear();
+
   this->cmGlobalGenerator::Generate();
 
   this->WriteAssumedSourceDependencies();
   this->WriteTargetAliases(*this->BuildFileStream);
   this->WriteFolderTargets(*this->BuildFileStream);
   this->WriteUnknownExplicitDependencies(*this->BuildFileStream);
+  this->WriteSubninjas(*this->BuildFileStream);
   this->WriteBuiltinTargets(*this->BuildFileStream);
 
   if (cmSystemTools::GetErrorOccuredFlag()) {
@@ -811,6 +828,49 @@ void cmGlobalNinjaGenerator::CloseBuildFileStream()
   }
 }
 
+void cmGlobalNinjaGenerator::OpenDirectoryBuildFileStream(
+  cmLocalGenerator* lg)
+{
+  if (!this->SubninjaPerDirectory || this->TopBuildFileStream) {
+    return;
+  }
+
+  std::string buildFilePath = lg->GetCurrentBinaryDirectory();
+  buildFilePath += cmake::GetCMakeFilesDirectory();
+  buildFilePath += "/";
+  buildFilePath += cmGlobalNinjaGenerator::NINJA_BUILD_FILE;
+  cmSystemTools::MakeDirectory(
+    cmSystemTools::GetFilenamePath(buildFilePath).c_str());
+
+  cmGeneratedFileStream* fout = new cmGeneratedFileStream(
+    buildFilePath.c_str(), false, this->GetMakefileEncoding());
+  // Leave the file untouched if its content did not change so that
+  // regenerating after a local edit rewrites only the affected pieces.
+  fout->SetCopyIfDifferent(true);
+
+  this->WriteDisclaimer(*fout);
+  *fout << "# This file contains the build statements of the directory\n"
+        << "# " << lg->GetCurrentBinaryDirectory() << "\n"
+        << "# and is included by the top-level build file.\n\n";
+
+  this->TopBuildFileStream = this->BuildFileStream;
+  this->BuildFileStream = fout;
+  this->SubninjaFiles.push_back(this->ConvertToNinjaPath(buildFilePath));
+}
+
+void cmGlobalNinjaGenerator::CloseDirectoryBuildFileStream()
+{
+  if (!this->TopBuildFileStream) {
+    return;
+  }
+  if (cmSystemTools::GetErrorOccuredFlag()) {
+    this->BuildFileStream->setstate(std::ios::failbit);
+  }
+  delete this->BuildFileStream;
+  this->BuildFileStream = this->TopBuildFileStream;
+  this->TopBuildFileStream = CM_NULLPTR;
+}
+
 void cmGlobalNinjaGenerator::OpenRulesFileStream()
 {
   // Compute Ninja's build file path.
@@ -1149,7 +1209,8 @@ void cmGlobalNinjaGenerator::WriteFolderTargets(std::ostream& os)
            type == cmStateEnums::MODULE_LIBRARY ||
            type == cmStateEnums::OBJECT_LIBRARY ||
            type == cmStateEnums::UTILITY) &&
-          !gt->GetPropertyAsBool("EXCLUDE_FROM_ALL")) {
+          !gt->GetPropertyAsBool("EXCLUDE_FROM_ALL") &&
+          this->IsTargetInFocus(gt)) {
         targetsPerFolder[currentBinaryFolder].push_back(gt->GetName());
       }
     }
@@ -1324,6 +1385,21 @@ void cmGlobalNinjaGenerator::WriteUnknownExplicitDependencies(std::ostream& os)
   }
 }
 
+void cmGlobalNinjaGenerator::WriteSubninjas(std::ostream& os)
+{
+  if (this->SubninjaFiles.empty()) {
+    return;
+  }
+
+  cmGlobalNinjaGenerator::WriteDivider(os);
+  os << "# Build statements of each directory.\n\n";
+  for (cmNinjaDeps::const_iterator i = this->SubninjaFiles.begin();
+       i != this->SubninjaFiles.end(); ++i) {
+    WriteSubninja(os, EncodeIdent(EncodePath(*i), os));
+  }
+  os << "\n";
+}
+
 void cmGlobalNinjaGenerator::WriteBuiltinTargets(std::ostream& os)
 {
   // Write headers.
@@ -1395,12 +1471,55 @@ void cmGlobalNinjaGenerator::WriteTargetRebuildManifest(std::ostream& os)
     variables["pool"] = "console";
   }
 
-  std::string const ninjaBuildFile = this->NinjaOutputPath(NINJA_BUILD_FILE);
+  // The globs given CONFIGURE_DEPENDS touch a stamp if their result
+  // changed.  They are checked on every run, before the manifest.
+  cmGlobVerificationManager* globs =
+    this->GetCMakeInstance()->GetGlobVerificationManager();
+  cmNinjaDeps rerunDeps = implicitDeps;
+  if (!globs->GetVerifyScript().empty()) {
+    std::ostringstream verifyCmd;
+    verifyCmd << lg->ConvertToOutputFormat(cmSystemTools::GetCMakeCommand(),
+                                           cmOutputConverter::SHELL)
+              << " -P "
+              << lg->ConvertToOutputFormat(globs->GetVerifyScript(),
+                                           cmOutputConverter::SHELL);
+    WriteRule(*this->RulesFileStream, "VERIFY_GLOBS", verifyCmd.str(),
+              "Re-checking globbed directories...",
+              "Rule for re-checking globbed directories.",
+              /*depfile=*/"",
+              /*deptype=*/"",
+              /*rspfile=*/"",
+              /*rspcontent*/ "",
+              /*restat=*/"1",
+              /*generator=*/true);
+
+    std::string const verifyStamp =
+      this->ConvertToNinjaPath(globs->GetVerifyStamp());
+    std::string const verifyForce = verifyStamp + "_force";
+    this->WriteBuild(os, "Re-check the globs given CONFIGURE_DEPENDS.",
+                     "VERIFY_GLOBS",
+                     /*outputs=*/cmNinjaDeps(1, verifyStamp),
+                     /*implicitOuts=*/cmNinjaDeps(),
+                     /*explicitDeps=*/cmNinjaDeps(),
+                     /*implicitDeps=*/cmNinjaDeps(1, verifyForce),
+                     /*orderOnlyDeps=*/cmNinjaDeps(), variables);
+    this->WritePhonyBuild(os, "Never up to date, so the globs are always "
+                              "re-checked.",
+                          cmNinjaDeps(1, verifyForce), cmNinjaDeps());
+    rerunDeps.push_back(verifyStamp);
+  }
+
+  // The per-directory build files are written by the same run, so ninja
+  // must regenerate them as well when they are missing or out of date.
+  cmNinjaDeps outputs(1, this->NinjaOutputPath(NINJA_BUILD_FILE));
+  cmNinjaDeps implicitOuts;
+  cmNinjaDeps& subninjaOuts =
+    this->SupportsImplicitOuts() ? implicitOuts : outputs;
+  subninjaOuts.insert(subninjaOuts.end(), this->SubninjaFiles.begin(),
+                      this->SubninjaFiles.end());
   this->WriteBuild(os, "Re-run CMake if any of its inputs changed.",
-                   "RERUN_CMAKE",
-                   /*outputs=*/cmNinjaDeps(1, ninjaBuildFile),
-                   /*implicitOuts=*/cmNinjaDeps(),
-                   /*explicitDeps=*/cmNinjaDeps(), implicitDeps,
+                   "RERUN_CMAKE", outputs, implicitOuts,
+                   /*explicitDeps=*/cmNinjaDeps(), rerunDeps,
                    /*orderOnlyDeps=*/cmNinjaDeps(), variables);
 
   this->WritePhonyBuild(os, "A missing CMake input file is not an error.",
@@ -166,6 +166,13 @@ public:
   static void WriteInclude(std::ostream& os, const std::string& filename,
                            const std::string& comment = "");
 
+  /**
+   * Write a subninja statement including @a filename in a new scope with
+   * an optional @a comment to the @a os stream.
+   */
+  static void WriteSubninja(std::ostream& os, const std::string& filename,
+                            const std::string& comment = "");
+
   /**
    * Write a default target statement specifying @a targets as
    * the default targets.
@@ -248,6 +255,14 @@ public:
     return this->RulesFileStream;
   }
 
+  /**
+   * Redirect the build statements of the directory of @a lg to a build
+   * file of its own if CMAKE_NINJA_SUBNINJA_PER_DIRECTORY is enabled.
+   * The top-level build file includes it with a subninja statement.
+   */
+  void OpenDirectoryBuildFileStream(cmLocalGenerator* lg);
+  void CloseDirectoryBuildFileStream();
+
   std::string ConvertToNinjaPath(const std::string& path) const;
 
   struct MapToNinjaPathImpl
@@ -341,6 +356,12 @@ public:
   void AddTargetAlias(const std::string& alias, cmGeneratorTarget* target);
 
   void ComputeTargetObjectDirectory(cmGeneratorTarget* gt) const CM_OVERRIDE;
+  bool NamesObjectsBySourcePath() const CM_OVERRIDE { return true; }
+
+  const char* GetFocusTargetsVariable() const CM_OVERRIDE
+  {
+    return "CMAKE_NINJA_FOCUS_TARGETS";
+  }
 
   // Ninja generator uses 'deps' and 'msvc_deps_prefix' introduced in 1.3
   static std::string RequiredNinjaVersion() { return "1.3"; }
@@ -392,6 +413,8 @@ private:
   void WriteFolderTargets(std::ostream& os);
   void WriteUnknownExplicitDependencies(std::ostream& os);
 
+  void WriteSubninjas(std::ostream& os);
+
   void WriteBuiltinTargets(std::ostream& os);
   void WriteTargetAll(std::ostream& os);
   void WriteTargetRebuildManifest(std::ostream& os);
@@ -412,6 +435,13 @@ private:
   cmGeneratedFileStream* RulesFileStream;
   cmGeneratedFileStream* CompileCommandsStream;
 
+  /// Whether each directory gets a build file of its own.
+  bool SubninjaPerDirectory;
+  /// The top-level build file while a directory build file is open.
+  cmGeneratedFileStream* TopBuildFileStream;
+  /// The directory build files included by the top-level build file.
+  cmNinjaDeps SubninjaFiles;
+
   /// The type used to store the set of rules added to the generated build
   /// system.
   typedef std::set<std::string> RulesSetType;
@@ -11,6 +11,7 @@
 #include "cmDocumentationEntry.h"
 #include "cmGeneratedFileStream.h"
 #include "cmGeneratorTarget.h"
+#include "cmGlobVerificationManager.h"
 #include "cmGlobalGenerator.h"
 #include "cmLocalGenerator.h"
 #include "cmLocalUnixMakefileGenerator3.h"
@@ -41,6 +42,7 @@ cmGlobalUnixMakefileGenerator3::cmGlobalUnixMakefileGenerator3(cmake* cm)
   this->CommandDatabase = CM_NULLPTR;
 
   this->IncludeDirective = "include";
+  this->OptionalIncludeDirective = "-include";
   this->DefineWindowsNULL = false;
   this->PassMakeflags = false;
   this->UnixCD = true;
@@ -311,6 +313,11 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
   lg = static_cast<cmLocalUnixMakefileGenerator3*>(this->LocalGenerators[0]);
 
   std::string currentBinDir = lg->GetCurrentBinaryDirectory();
+  cmGlobVerificationManager* globs =
+    this->GetCMakeInstance()->GetGlobVerificationManager();
+  if (!globs->GetVerifyStamp().empty()) {
+    lfiles.push_back(globs->GetVerifyStamp());
+  }
   // Save the list to the cmake file.
   cmakefileStream
     << "# The top level Makefile was generated from the following files:\n"
@@ -323,6 +330,15 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
   }
   cmakefileStream << "  )\n\n";
 
+  // The check of the build system runs the glob verification first.
+  if (!globs->GetVerifyScript().empty()) {
+    cmakefileStream << "# The globs given CONFIGURE_DEPENDS are checked by:\n"
+                    << "set(CMAKE_MAKEFILE_VERIFY_GLOBS \""
+                    << lg->ConvertToRelativePath(currentBinDir,
+                                                 globs->GetVerifyScript())
+                    << "\")\n\n";
+  }
+
   // Build the path to the cache check file.
   std::string check = this->GetCMakeInstance()->GetHomeOutputDirectory();
   check += cmake::GetCMakeFilesDirectory();
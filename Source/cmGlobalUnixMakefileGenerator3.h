@@ -152,8 +152,11 @@ public:
   bool IsIPOSupported() const CM_OVERRIDE { return true; }
 
   void ComputeTargetObjectDirectory(cmGeneratorTarget* gt) const CM_OVERRIDE;
+  bool NamesObjectsBySourcePath() const CM_OVERRIDE { return true; }
 
   std::string IncludeDirective;
+  // Include a file only if it exists, or empty if the tool cannot.
+  std::string OptionalIncludeDirective;
   bool DefineWindowsNULL;
   bool PassMakeflags;
   bool UnixCD;
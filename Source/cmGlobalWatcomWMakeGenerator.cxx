@@ -22,6 +22,7 @@ cmGlobalWatcomWMakeGenerator::cmGlobalWatcomWMakeGenerator(cmake* cm)
 #endif
   cm->GetState()->SetWatcomWMake(true);
   this->IncludeDirective = "!include";
+  this->OptionalIncludeDirective = "";
   this->DefineWindowsNULL = true;
   this->UnixCD = false;
   this->MakeSilentFlag = "-h";
@@ -99,7 +99,7 @@ bool cmIfFunctionBlocker::IsFunctionBlocked(const cmListFileFunction& lff,
             std::string errorString;
 
             std::vector<cmExpandedCommandArgument> expandedArguments;
-            mf.ExpandArguments(this->Functions[c].Arguments,
+            mf.ExpandArguments(this->Functions[c].GetArguments(),
                                expandedArguments);
 
             cmake::MessageType messType;
@@ -168,7 +168,7 @@ bool cmIfFunctionBlocker::ShouldRemove(const cmListFileFunction& lff,
   if (!cmSystemTools::Strucmp(lff.Name.c_str(), "endif")) {
     // if the endif has arguments, then make sure
     // they match the arguments of the matching if
-    if (lff.Arguments.empty() || lff.Arguments == this->Args) {
+    if (lff.GetArguments().empty() || lff.GetArguments() == this->Args) {
       return true;
     }
   }
@@ -0,0 +1,230 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmInstallHashCache.h"
+
+#include "cmsys/FStream.hxx"
+#include <sstream>
+#include <utility>
+
+#include "cmMakefile.h"
+#include "cmSystemTools.h"
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#include "cmCryptoHash.h"
+#include "cmFileLock.h"
+#include "cmFileLockResult.h"
+#endif
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+#include "cm_sys_stat.h"
+#else
+#include "cmsys/Encoding.hxx"
+#include <windows.h>
+#endif
+
+// Get the modification time of a file in units of 1ns, or -1.  Sources
+// rewritten within a second must not look unchanged.
+static long long cmInstallHashCacheModifiedTime(std::string const& file)
+{
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  struct stat st;
+  if (::stat(file.c_str(), &st) != 0) {
+    return -1;
+  }
+  long long const bil = 1000000000;
+#if CMake_STAT_HAS_ST_MTIM
+  return st.st_mtim.tv_sec * bil + st.st_mtim.tv_nsec;
+#elif CMake_STAT_HAS_ST_MTIMESPEC
+  return st.st_mtimespec.tv_sec * bil + st.st_mtimespec.tv_nsec;
+#else
+  return st.st_mtime * bil;
+#endif
+#else
+  WIN32_FILE_ATTRIBUTE_DATA fdata;
+  if (!GetFileAttributesExW(cmsys::Encoding::ToWide(file).c_str(),
+                            GetFileExInfoStandard, &fdata)) {
+    return -1;
+  }
+  // Times are integers in units of 100ns.
+  LARGE_INTEGER t;
+  t.LowPart = fdata.ftLastWriteTime.dwLowDateTime;
+  t.HighPart = fdata.ftLastWriteTime.dwHighDateTime;
+  return t.QuadPart * 100;
+#endif
+}
+
+cmInstallHashCache::cmInstallHashCache()
+{
+}
+
+bool cmInstallHashCache::Enable(cmMakefile* mf)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  std::string check = mf->GetSafeDefinition("CMAKE_INSTALL_HASH_CHECK");
+  if (check.empty()) {
+    cmSystemTools::GetEnv("CMAKE_INSTALL_HASH_CHECK", check);
+  }
+  std::string const dir = mf->GetSafeDefinition("CMAKE_BINARY_DIR");
+  if (!cmSystemTools::IsOn(check.c_str()) || dir.empty()) {
+    return false;
+  }
+  std::string const file = dir + "/install_manifest_hashes.txt";
+  if (file != this->File) {
+    this->Save();
+    this->Load(file);
+  }
+  return true;
+#else
+  static_cast<void>(mf);
+  return false;
+#endif
+}
+
+bool cmInstallHashCache::IsUpToDate(std::string const& fromFile,
+                                    std::string const& toFile)
+{
+  EntryMap::iterator i = this->Entries.find(toFile);
+  if (i == this->Entries.end()) {
+    return false;
+  }
+  Entry& entry = i->second;
+
+  // The installed file must be the one recorded.
+  if (!cmSystemTools::FileExists(toFile, true) ||
+      cmSystemTools::FileLength(toFile) != entry.ToSize ||
+      cmInstallHashCacheModifiedTime(toFile) != entry.ToTime) {
+    return false;
+  }
+
+  // The source must still have the recorded content.  Read it only if
+  // its time changed since the hash was computed.
+  if (cmSystemTools::FileLength(fromFile) != entry.FromSize) {
+    return false;
+  }
+  long long const fromTime = cmInstallHashCacheModifiedTime(fromFile);
+  if (fromTime != entry.FromTime) {
+    if (this->ComputeHash(fromFile) != entry.Hash) {
+      return false;
+    }
+    entry.FromTime = fromTime;
+    this->Changed.insert(toFile);
+  }
+  return true;
+}
+
+void cmInstallHashCache::Record(std::string const& fromFile,
+                                std::string const& toFile,
+                                std::string const& hash)
+{
+  this->Changed.insert(toFile);
+  Entry entry;
+  entry.Hash = hash;
+  if (entry.Hash.empty()) {
+    this->Entries.erase(toFile);
+    return;
+  }
+  // The installed file is in place.  Its time may be rounded from the
+  // time of the source.
+  entry.FromSize = cmSystemTools::FileLength(fromFile);
+  entry.FromTime = cmInstallHashCacheModifiedTime(fromFile);
+  entry.ToSize = cmSystemTools::FileLength(toFile);
+  entry.ToTime = cmInstallHashCacheModifiedTime(toFile);
+  this->Entries[toFile] = entry;
+}
+
+bool cmInstallHashCache::Save()
+{
+  if (this->Changed.empty() || this->File.empty()) {
+    return true;
+  }
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Other processes, such as parallel CPack generators, may install
+  // into the same build tree.  Merge our changes into the entries they
+  // saved and replace the file at once.
+  std::string const lockFile = this->File + ".lock";
+  {
+    // The file to lock must exist.
+    cmsys::ofstream touch(lockFile.c_str(), std::ios::app);
+  }
+  cmFileLock lock;
+  if (!lock.Lock(lockFile, static_cast<unsigned long>(-1)).IsOk()) {
+    return false;
+  }
+  EntryMap entries;
+  ReadEntries(this->File, entries);
+  for (std::set<std::string>::const_iterator i = this->Changed.begin();
+       i != this->Changed.end(); ++i) {
+    EntryMap::const_iterator e = this->Entries.find(*i);
+    if (e != this->Entries.end()) {
+      entries[*i] = e->second;
+    } else {
+      entries.erase(*i);
+    }
+  }
+
+  std::string const tempFile = this->File + ".tmp";
+  {
+    cmsys::ofstream fout(tempFile.c_str());
+    if (!fout) {
+      return false;
+    }
+    fout << "# Content hashes of installed files, used with "
+            "CMAKE_INSTALL_HASH_CHECK.\n";
+    for (EntryMap::const_iterator i = entries.begin(); i != entries.end();
+         ++i) {
+      Entry const& entry = i->second;
+      fout << entry.Hash << ' ' << entry.FromSize << ' ' << entry.FromTime
+           << ' ' << entry.ToSize << ' ' << entry.ToTime << ' ' << i->first
+           << '\n';
+    }
+    if (!fout) {
+      return false;
+    }
+  }
+  if (!cmSystemTools::RenameFile(tempFile.c_str(), this->File.c_str())) {
+    return false;
+  }
+  this->Changed.clear();
+  return true;
+#else
+  return false;
+#endif
+}
+
+void cmInstallHashCache::Load(std::string const& file)
+{
+  this->File = file;
+  this->Entries.clear();
+  this->Changed.clear();
+  ReadEntries(file, this->Entries);
+}
+
+void cmInstallHashCache::ReadEntries(std::string const& file,
+                                     EntryMap& entries)
+{
+  cmsys::ifstream fin(file.c_str());
+  std::string line;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream in(line);
+    Entry entry;
+    std::string toFile;
+    if (in >> entry.Hash >> entry.FromSize >> entry.FromTime >>
+        entry.ToSize >> entry.ToTime &&
+        in.get() == ' ' && std::getline(in, toFile) && !toFile.empty()) {
+      entries[toFile] = entry;
+    }
+  }
+}
+
+std::string cmInstallHashCache::ComputeHash(std::string const& file)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  return cmSystemTools::ComputeFileHash(file, cmCryptoHash::AlgoSHA256);
+#else
+  static_cast<void>(file);
+  return std::string();
+#endif
+}
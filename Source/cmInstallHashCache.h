@@ -0,0 +1,69 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmInstallHashCache_h
+#define cmInstallHashCache_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <map>
+#include <set>
+#include <string>
+
+class cmMakefile;
+
+/** \class cmInstallHashCache
+ * \brief Content hashes of installed files.
+ *
+ * With CMAKE_INSTALL_HASH_CHECK on, file(INSTALL) records the hash of
+ * each file it installs, with the sizes and modification times of the
+ * source and the installed copy, in install_manifest_hashes.txt next
+ * to the install manifest.  A file whose source has a new time is then
+ * up to date if the source still has the recorded hash and the copy was
+ * not modified since, which needs to read only the source.
+ */
+class cmInstallHashCache
+{
+  CM_DISABLE_COPY(cmInstallHashCache)
+
+public:
+  cmInstallHashCache();
+
+  /** Whether file(INSTALL) in the given makefile checks content.  If so,
+      load the cache of its build tree unless already loaded.  */
+  bool Enable(cmMakefile* mf);
+
+  /** Whether the installed file still has the content of the source.  */
+  bool IsUpToDate(std::string const& fromFile, std::string const& toFile);
+
+  /** Record that a file was installed with its source's time, given
+      the hash of the source from ComputeHash().  */
+  void Record(std::string const& fromFile, std::string const& toFile,
+              std::string const& hash);
+
+  /** Compute the hash of a file as recorded, or an empty string.  This
+      may be called on any thread.  */
+  static std::string ComputeHash(std::string const& file);
+
+  /** Merge the changed entries into the cache on disk, if any.  */
+  bool Save();
+
+private:
+  struct Entry
+  {
+    std::string Hash;
+    unsigned long FromSize;
+    long long FromTime;
+    unsigned long ToSize;
+    long long ToTime;
+  };
+  typedef std::map<std::string, Entry> EntryMap;
+
+  void Load(std::string const& file);
+  static void ReadEntries(std::string const& file, EntryMap& entries);
+
+  std::string File;
+  EntryMap Entries;
+  std::set<std::string> Changed;
+};
+
+#endif
@@ -0,0 +1,570 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmInstallQueue.h"
+
+#include "cmsys/Process.h"
+#include <algorithm>
+#include <set>
+#include <sstream>
+
+#include "cmAlgorithms.h"
+#include "cmInstallHashCache.h"
+#include "cmMakefile.h"
+#include "cmPathCache.h"
+#include "cmProcessOutput.h"
+#include "cmSystemTools.h"
+#include "cmWorkerPool.h"
+#include "cm_sys_stat.h"
+#include "cmake.h"
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+static mode_t mode_owner_write = S_IWRITE;
+#else
+static mode_t mode_owner_write = S_IWUSR;
+#endif
+
+struct cmInstallQueueAction
+{
+  enum ActionType
+  {
+    ActionCopy,
+    ActionRPathChange,
+    ActionRPathRemove,
+    ActionCommand
+  };
+
+  cmInstallQueueAction(ActionType type, cmListFileBacktrace const& backtrace)
+    : Type(type)
+    , Backtrace(backtrace)
+    , Permissions(0)
+    , CopyTime(false)
+    , RecordHash(false)
+  {
+  }
+
+  ActionType Type;
+  cmListFileBacktrace Backtrace;
+  std::string FromFile;
+  mode_t Permissions;
+  bool CopyTime;
+  bool RecordHash;
+  std::string OldRPath;
+  std::string NewRPath;
+  std::vector<std::string> Command;
+};
+
+/** \class cmInstallQueueFile
+ * \brief The actions queued on one installed file.
+ *
+ * The worker threads run the actions up to the first command.  Commands
+ * are run from the thread running the queue because kwsys processes may
+ * not be created concurrently, and the actions after them run there too.
+ */
+class cmInstallQueueFile : public cmWorkerPool::Job
+{
+public:
+  cmInstallQueueFile(std::string const& file)
+    : File(file)
+    , Next(0)
+    , Failed(false)
+    , Child(CM_NULLPTR)
+  {
+  }
+  ~cmInstallQueueFile() CM_OVERRIDE { cmsysProcess_Delete(this->Child); }
+
+  void Process() CM_OVERRIDE { this->RunActions(); }
+
+  /** Run actions up to the next command and start it.  Return false if
+      no command is running.  */
+  bool StartCommand();
+
+  /** Wait at most the given time for the running command.  Return true
+      once it is done.  */
+  bool WaitForCommand(double timeout);
+
+  std::string File;
+  std::vector<cmInstallQueueAction> Actions;
+  size_t Next;
+  // The source and its hash if the copy is to be recorded.
+  std::string CopiedFrom;
+  std::string CopiedHash;
+  std::vector<std::string> Messages;
+  bool Failed;
+  std::string Error;
+  cmListFileBacktrace ErrorBacktrace;
+
+private:
+  void RunActions();
+  bool RunCopy(cmInstallQueueAction const& action);
+
+  cmsysProcess* Child;
+  cmProcessOutput Decoder;
+  std::string Output;
+};
+
+void cmInstallQueueFile::RunActions()
+{
+  for (; this->Next < this->Actions.size() && !this->Failed; ++this->Next) {
+    cmInstallQueueAction const& action = this->Actions[this->Next];
+    std::string message;
+    switch (action.Type) {
+      case cmInstallQueueAction::ActionCopy:
+        this->Failed = !this->RunCopy(action);
+        break;
+      case cmInstallQueueAction::ActionRPathChange:
+        this->Failed =
+          !cmInstallQueue::ChangeRPath(this->File, action.OldRPath,
+                                       action.NewRPath, message, this->Error);
+        break;
+      case cmInstallQueueAction::ActionRPathRemove:
+        this->Failed =
+          !cmInstallQueue::RemoveRPath(this->File, message, this->Error);
+        break;
+      case cmInstallQueueAction::ActionCommand:
+        return;
+    }
+    if (this->Failed) {
+      this->ErrorBacktrace = action.Backtrace;
+    } else if (!message.empty()) {
+      this->Messages.push_back(message);
+    }
+  }
+}
+
+bool cmInstallQueueFile::RunCopy(cmInstallQueueAction const& action)
+{
+  const char* fromFile = action.FromFile.c_str();
+  const char* toFile = this->File.c_str();
+  std::ostringstream e;
+  if (!cmSystemTools::CopyAFile(fromFile, toFile, true)) {
+    e << "INSTALL cannot copy file \"" << fromFile << "\" to \"" << toFile
+      << "\".";
+    this->Error = e.str();
+    return false;
+  }
+  if (action.CopyTime) {
+    // Add write permission so we can set the file time.
+    mode_t perm = 0;
+    if (cmSystemTools::GetPermissions(toFile, perm)) {
+      cmSystemTools::SetPermissions(toFile, perm | mode_owner_write);
+    }
+    if (!cmSystemTools::CopyFileTime(fromFile, toFile)) {
+      e << "INSTALL cannot set modification time on \"" << toFile << "\"";
+      this->Error = e.str();
+      return false;
+    }
+  }
+  if (action.Permissions &&
+      !cmSystemTools::SetPermissions(toFile, action.Permissions)) {
+    e << "INSTALL cannot set permissions on \"" << toFile << "\"";
+    this->Error = e.str();
+    return false;
+  }
+  if (action.RecordHash) {
+    this->CopiedFrom = action.FromFile;
+    this->CopiedHash = cmInstallHashCache::ComputeHash(action.FromFile);
+  }
+  return true;
+}
+
+bool cmInstallQueueFile::StartCommand()
+{
+  this->RunActions();
+  if (this->Failed || this->Next == this->Actions.size()) {
+    return false;
+  }
+  std::vector<std::string> const& command = this->Actions[this->Next].Command;
+  std::vector<const char*> argv;
+  for (std::vector<std::string>::const_iterator ai = command.begin();
+       ai != command.end(); ++ai) {
+    argv.push_back(ai->c_str());
+  }
+  argv.push_back(CM_NULLPTR);
+  this->Child = cmsysProcess_New();
+  cmsysProcess_SetCommand(this->Child, &*argv.begin());
+  cmsysProcess_SetOption(this->Child, cmsysProcess_Option_HideWindow, 1);
+  cmsysProcess_SetOption(this->Child, cmsysProcess_Option_MergeOutput, 1);
+  cmsysProcess_Execute(this->Child);
+  return true;
+}
+
+bool cmInstallQueueFile::WaitForCommand(double timeout)
+{
+  char* data;
+  int length;
+  int pipe;
+  std::string strdata;
+  while ((pipe = cmsysProcess_WaitForData(this->Child, &data, &length,
+                                          &timeout)) ==
+         cmsysProcess_Pipe_STDOUT) {
+    this->Decoder.DecodeText(data, length, strdata);
+    this->Output += strdata;
+  }
+  if (pipe == cmsysProcess_Pipe_Timeout) {
+    return false;
+  }
+  this->Decoder.DecodeText(std::string(), strdata);
+  this->Output += strdata;
+  cmsysProcess_WaitForExit(this->Child, CM_NULLPTR);
+  if (cmsysProcess_GetState(this->Child) == cmsysProcess_State_Error) {
+    this->Output += cmsysProcess_GetErrorString(this->Child);
+    this->Output += "\n";
+  }
+  cmsysProcess_Delete(this->Child);
+  this->Child = CM_NULLPTR;
+
+  // Show the output in one piece, not mixed with that of other commands.
+  if (!this->Output.empty()) {
+    cmSystemTools::Stdout(this->Output.c_str(), this->Output.size());
+    this->Output.clear();
+  }
+  ++this->Next;
+  return true;
+}
+
+namespace {
+class cmInstallQueueRPathJob : public cmWorkerPool::Job
+{
+public:
+  cmInstallQueueRPathJob(std::string const& file, bool remove,
+                         std::string const& oldRPath,
+                         std::string const& newRPath)
+    : File(file)
+    , Remove(remove)
+    , OldRPath(oldRPath)
+    , NewRPath(newRPath)
+    , Success(false)
+  {
+  }
+
+  void Process() CM_OVERRIDE
+  {
+    this->Success = this->Remove
+      ? cmInstallQueue::RemoveRPath(this->File, this->Message, this->Error)
+      : cmInstallQueue::ChangeRPath(this->File, this->OldRPath,
+                                    this->NewRPath, this->Message,
+                                    this->Error);
+  }
+
+  std::string const& File;
+  bool const Remove;
+  std::string const& OldRPath;
+  std::string const& NewRPath;
+  bool Success;
+  std::string Message;
+  std::string Error;
+};
+}
+
+cmInstallQueue::cmInstallQueue()
+  : Depth(0)
+  , Threads(1)
+{
+}
+
+cmInstallQueue::~cmInstallQueue()
+{
+  cmDeleteAll(this->Files);
+}
+
+unsigned int cmInstallQueue::GetParallelLevel(cmMakefile* mf)
+{
+  std::string const level =
+    mf->GetSafeDefinition("CMAKE_INSTALL_PARALLEL_LEVEL");
+  unsigned long threads;
+  if (level.empty() ||
+      level.find_first_not_of("0123456789") != std::string::npos ||
+      !cmSystemTools::StringToULong(level.c_str(), &threads)) {
+    return 1;
+  }
+  unsigned int const hardware = cmWorkerPool::GetHardwareThreadCount();
+  if (threads == 0) {
+    return hardware;
+  }
+  // Copies mostly wait for the disk, so use more threads than there are
+  // processors, but not arbitrarily many.
+  return static_cast<unsigned int>(
+    std::min(threads, static_cast<unsigned long>(hardware) * 4));
+}
+
+void cmInstallQueue::Begin(cmMakefile* mf)
+{
+  if (this->Depth++ == 0) {
+    this->Threads = cmInstallQueue::GetParallelLevel(mf);
+  }
+}
+
+bool cmInstallQueue::End(cmMakefile* mf)
+{
+  if (--this->Depth > 0) {
+    return true;
+  }
+  bool const result = this->Run(mf);
+  this->Threads = 1;
+  return result;
+}
+
+void cmInstallQueue::Discard()
+{
+  cmDeleteAll(this->Files);
+  this->Files.clear();
+  this->FileMap.clear();
+  this->Depth = 0;
+  this->Threads = 1;
+}
+
+bool cmInstallQueue::IsQueued(std::string const& file) const
+{
+  return !this->Files.empty() &&
+    this->FileMap.find(cmSystemTools::CollapseFullPath(file)) !=
+    this->FileMap.end();
+}
+
+cmInstallQueueFile* cmInstallQueue::GetFile(std::string const& file)
+{
+  std::string const path = cmSystemTools::CollapseFullPath(file);
+  std::map<std::string, cmInstallQueueFile*>::iterator i =
+    this->FileMap.find(path);
+  if (i != this->FileMap.end()) {
+    return i->second;
+  }
+  cmInstallQueueFile* queued = new cmInstallQueueFile(path);
+  this->Files.push_back(queued);
+  this->FileMap[path] = queued;
+  return queued;
+}
+
+void cmInstallQueue::QueueCopy(std::string const& fromFile,
+                               std::string const& toFile, mode_t permissions,
+                               bool copyTime, bool recordHash,
+                               cmListFileBacktrace const& backtrace)
+{
+  cmInstallQueueAction action(cmInstallQueueAction::ActionCopy, backtrace);
+  action.FromFile = fromFile;
+  action.Permissions = permissions;
+  action.CopyTime = copyTime;
+  action.RecordHash = recordHash;
+  this->GetFile(toFile)->Actions.push_back(action);
+}
+
+void cmInstallQueue::QueueRPathChange(std::string const& file,
+                                      std::string const& oldRPath,
+                                      std::string const& newRPath,
+                                      cmListFileBacktrace const& backtrace)
+{
+  cmInstallQueueAction action(cmInstallQueueAction::ActionRPathChange,
+                              backtrace);
+  action.OldRPath = oldRPath;
+  action.NewRPath = newRPath;
+  this->GetFile(file)->Actions.push_back(action);
+}
+
+void cmInstallQueue::QueueRPathRemove(std::string const& file,
+                                      cmListFileBacktrace const& backtrace)
+{
+  this->GetFile(file)->Actions.push_back(
+    cmInstallQueueAction(cmInstallQueueAction::ActionRPathRemove, backtrace));
+}
+
+void cmInstallQueue::QueueCommand(std::string const& file,
+                                  std::vector<std::string> const& command,
+                                  cmListFileBacktrace const& backtrace)
+{
+  cmInstallQueueAction action(cmInstallQueueAction::ActionCommand,
+                              backtrace);
+  action.Command = command;
+  this->GetFile(file)->Actions.push_back(action);
+}
+
+bool cmInstallQueue::Run(cmMakefile* mf)
+{
+  if (this->Files.empty()) {
+    return true;
+  }
+  std::vector<cmWorkerPool::Job*> jobs(this->Files.begin(),
+                                       this->Files.end());
+  cmWorkerPool pool(this->Threads);
+  pool.Process(jobs);
+  this->RunCommands(pool.GetThreadCount());
+
+  cmInstallHashCache* hashCache =
+    mf->GetCMakeInstance()->GetInstallHashCache();
+  bool result = true;
+  for (std::vector<cmInstallQueueFile*>::const_iterator fi =
+         this->Files.begin();
+       fi != this->Files.end(); ++fi) {
+    cmInstallQueueFile const* file = *fi;
+    if (!file->CopiedFrom.empty()) {
+      hashCache->Record(file->CopiedFrom, file->File, file->CopiedHash);
+    }
+    for (std::vector<std::string>::const_iterator mi =
+           file->Messages.begin();
+         mi != file->Messages.end(); ++mi) {
+      mf->DisplayStatus(mi->c_str(), -1);
+    }
+    if (file->Failed && result) {
+      // Only the first error is shown, as the script would have stopped
+      // there without the queue.
+      mf->GetCMakeInstance()->IssueMessage(
+        cmake::FATAL_ERROR, "file " + file->Error, file->ErrorBacktrace);
+      if (mf->GetCMakeInstance()->GetWorkingMode() != cmake::NORMAL_MODE) {
+        cmSystemTools::SetFatalErrorOccured();
+      }
+      result = false;
+    }
+    cmPathCache::InvalidatePath(file->File);
+  }
+  cmDeleteAll(this->Files);
+  this->Files.clear();
+  this->FileMap.clear();
+  return result;
+}
+
+void cmInstallQueue::RunCommands(unsigned int threads)
+{
+  std::vector<cmInstallQueueFile*> running;
+  std::vector<cmInstallQueueFile*>::const_iterator next = this->Files.begin();
+  while (next != this->Files.end() || !running.empty()) {
+    while (running.size() < threads && next != this->Files.end()) {
+      if ((*next)->StartCommand()) {
+        running.push_back(*next);
+      }
+      ++next;
+    }
+    if (running.empty()) {
+      continue;
+    }
+
+    // Share a tenth of a second between the running commands.
+    double const timeout = 0.1 / static_cast<double>(running.size());
+    for (size_t r = 0; r < running.size();) {
+      if (!running[r]->WaitForCommand(timeout) ||
+          running[r]->StartCommand()) {
+        ++r;
+      } else {
+        running.erase(running.begin() + r);
+      }
+    }
+  }
+}
+
+bool cmInstallQueue::ChangeRPath(std::string const& file,
+                                 std::string const& oldRPath,
+                                 std::string const& newRPath,
+                                 std::string& message, std::string& error)
+{
+  bool success = true;
+  cmSystemToolsFileTime* ft = cmSystemTools::FileTimeNew();
+  bool have_ft = cmSystemTools::FileTimeGet(file.c_str(), ft);
+  std::string emsg;
+  bool changed;
+  if (!cmSystemTools::ChangeRPath(file, oldRPath, newRPath, &emsg, &changed)) {
+    std::ostringstream e;
+    /* clang-format off */
+    e << "RPATH_CHANGE could not write new RPATH:\n"
+      << "  " << newRPath << "\n"
+      << "to the file:\n"
+      << "  " << file << "\n"
+      << emsg;
+    /* clang-format on */
+    error = e.str();
+    success = false;
+  }
+  if (success) {
+    if (changed) {
+      message = "Set runtime path of \"";
+      message += file;
+      message += "\" to \"";
+      message += newRPath;
+      message += "\"";
+    }
+    if (have_ft) {
+      cmSystemTools::FileTimeSet(file.c_str(), ft);
+    }
+  }
+  cmSystemTools::FileTimeDelete(ft);
+  return success;
+}
+
+bool cmInstallQueue::RemoveRPath(std::string const& file, std::string& message,
+                                 std::string& error)
+{
+  bool success = true;
+  cmSystemToolsFileTime* ft = cmSystemTools::FileTimeNew();
+  bool have_ft = cmSystemTools::FileTimeGet(file.c_str(), ft);
+  std::string emsg;
+  bool removed;
+  if (!cmSystemTools::RemoveRPath(file, &emsg, &removed)) {
+    std::ostringstream e;
+    /* clang-format off */
+    e << "RPATH_REMOVE could not remove RPATH from file:\n"
+      << "  " << file << "\n"
+      << emsg;
+    /* clang-format on */
+    error = e.str();
+    success = false;
+  }
+  if (success) {
+    if (removed) {
+      message = "Removed runtime path from \"";
+      message += file;
+      message += "\"";
+    }
+    if (have_ft) {
+      cmSystemTools::FileTimeSet(file.c_str(), ft);
+    }
+  }
+  cmSystemTools::FileTimeDelete(ft);
+  return success;
+}
+
+// Identify a file by its device and inode, which hard links and symbolic
+// links share, or by its full path where that is not available.
+static std::string cmInstallQueueFileId(std::string const& file)
+{
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  struct stat st;
+  if (stat(file.c_str(), &st) == 0) {
+    std::ostringstream id;
+    id << st.st_dev << ':' << st.st_ino;
+    return id.str();
+  }
+#endif
+  return cmSystemTools::CollapseFullPath(file);
+}
+
+bool cmInstallQueue::EditRPaths(std::vector<std::string> const& files,
+                                bool remove, std::string const& oldRPath,
+                                std::string const& newRPath,
+                                unsigned int threads,
+                                std::vector<std::string>& messages,
+                                std::string& error)
+{
+  // Edit each file once.  Two jobs on the same file would race.
+  std::set<std::string> seen;
+  std::vector<cmInstallQueueRPathJob*> jobs;
+  for (std::vector<std::string>::const_iterator fi = files.begin();
+       fi != files.end(); ++fi) {
+    if (seen.insert(cmInstallQueueFileId(*fi)).second) {
+      jobs.push_back(
+        new cmInstallQueueRPathJob(*fi, remove, oldRPath, newRPath));
+    }
+  }
+  std::vector<cmWorkerPool::Job*> pending(jobs.begin(), jobs.end());
+  cmWorkerPool pool(threads);
+  pool.Process(pending);
+
+  bool success = true;
+  for (std::vector<cmInstallQueueRPathJob*>::const_iterator ji = jobs.begin();
+       ji != jobs.end(); ++ji) {
+    if (!(*ji)->Message.empty()) {
+      messages.push_back((*ji)->Message);
+    }
+    if (!(*ji)->Success && success) {
+      error = (*ji)->Error;
+      success = false;
+    }
+  }
+  cmDeleteAll(jobs);
+  return success;
+}
@@ -0,0 +1,120 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmInstallQueue_h
+#define cmInstallQueue_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cmListFileCache.h"
+#include "cm_sys_stat.h"
+
+class cmInstallQueueFile;
+class cmMakefile;
+
+/** \class cmInstallQueue
+ * \brief Install files on several threads.
+ *
+ * Install scripts generated with CMAKE_INSTALL_PARALLEL_LEVEL set call
+ * file(INSTALL_QUEUE BEGIN) before their rules and file(INSTALL_QUEUE END)
+ * after them.  In between, if the level is greater than one, file(INSTALL)
+ * queues the copies of regular files here instead of making them, and
+ * the RPATH edits and commands the script then runs on a queued file are
+ * queued behind its copy.  The outermost END runs the queue, processing
+ * the files concurrently and the actions on each file in order.  Each
+ * action keeps the backtrace of the command that queued it, where its
+ * error is shown.
+ */
+class cmInstallQueue
+{
+  CM_DISABLE_COPY(cmInstallQueue)
+
+public:
+  cmInstallQueue();
+  ~cmInstallQueue();
+
+  /** Get the number of threads on which to install files for the given
+      makefile, or 1 to install them immediately.  */
+  static unsigned int GetParallelLevel(cmMakefile* mf);
+
+  /** Start queueing files, or nest in the queueing already started.  */
+  void Begin(cmMakefile* mf);
+
+  /** End what Begin() started.  The outermost call runs the queue and
+      returns its result.  */
+  bool End(cmMakefile* mf);
+
+  /** Drop the queued actions and stop queueing, after an error.  */
+  void Discard();
+
+  bool IsOpen() const { return this->Depth > 0; }
+
+  /** Whether file(INSTALL) queues its copies.  */
+  bool IsActive() const { return this->Depth > 0 && this->Threads > 1; }
+
+  bool IsEmpty() const { return this->Files.empty(); }
+
+  /** Whether actions on the given file are waiting to run.  */
+  bool IsQueued(std::string const& file) const;
+
+  /** Queue copying a file, setting its permissions (unless zero) and,
+      if requested, the modification time of the source.  If requested,
+      Run() records the copy in the install hash cache once it is made.  */
+  void QueueCopy(std::string const& fromFile, std::string const& toFile,
+                 mode_t permissions, bool copyTime, bool recordHash,
+                 cmListFileBacktrace const& backtrace);
+
+  /** Queue file(RPATH_CHANGE) or file(RPATH_REMOVE) on a queued file.  */
+  void QueueRPathChange(std::string const& file, std::string const& oldRPath,
+                        std::string const& newRPath,
+                        cmListFileBacktrace const& backtrace);
+  void QueueRPathRemove(std::string const& file,
+                        cmListFileBacktrace const& backtrace);
+
+  /** Queue running a command on a queued file.  Its output is shown and
+      its result ignored, as execute_process() does without options.  */
+  void QueueCommand(std::string const& file,
+                    std::vector<std::string> const& command,
+                    cmListFileBacktrace const& backtrace);
+
+  /** Run all queued actions and show their messages in the order the
+      files were queued.  If an action fails the later actions on its
+      file are skipped.  Return false after reporting the first error at
+      the command that queued the failed action.  */
+  bool Run(cmMakefile* mf);
+
+  /** Edit the RPATH of a file like file(RPATH_CHANGE) and file(RPATH_REMOVE)
+      do, keeping its modification time.  Set the message to show if the
+      file changed.  */
+  static bool ChangeRPath(std::string const& file, std::string const& oldRPath,
+                          std::string const& newRPath, std::string& message,
+                          std::string& error);
+  static bool RemoveRPath(std::string const& file, std::string& message,
+                          std::string& error);
+
+  /** Change the RPATH of several files, or remove it if requested, on up
+      to the given number of threads (zero for the hardware threads).
+      Each file is parsed and edited once, even if listed several times
+      under different names or through links (on Windows, only names
+      that resolve to the same full path are recognized).  Append the messages in file order and
+      return the first error.  */
+  static bool EditRPaths(std::vector<std::string> const& files, bool remove,
+                         std::string const& oldRPath,
+                         std::string const& newRPath, unsigned int threads,
+                         std::vector<std::string>& messages,
+                         std::string& error);
+
+private:
+  cmInstallQueueFile* GetFile(std::string const& file);
+  void RunCommands(unsigned int threads);
+
+  std::vector<cmInstallQueueFile*> Files;
+  std::map<std::string, cmInstallQueueFile*> FileMap;
+  unsigned int Depth;
+  unsigned int Threads;
+};
+
+#endif
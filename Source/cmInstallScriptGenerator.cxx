@@ -2,6 +2,8 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmInstallScriptGenerator.h"
 
+#include "cmLocalGenerator.h"
+#include "cmMakefile.h"
 #include "cmScriptGenerator.h"
 
 #include <ostream>
@@ -15,6 +17,7 @@ cmInstallScriptGenerator::cmInstallScriptGenerator(const char* script,
                        MessageDefault, exclude_from_all)
   , Script(script)
   , Code(code)
+  , RunInstallQueue(false)
 {
 }
 
@@ -22,6 +25,13 @@ cmInstallScriptGenerator::~cmInstallScriptGenerator()
 {
 }
 
+void cmInstallScriptGenerator::Compute(cmLocalGenerator* lg)
+{
+  // The script may read the files queued for installation before it.
+  this->RunInstallQueue =
+    lg->GetMakefile()->IsSet("CMAKE_INSTALL_PARALLEL_LEVEL");
+}
+
 void cmInstallScriptGenerator::GenerateScript(std::ostream& os)
 {
   Indent indent;
@@ -29,6 +39,9 @@ void cmInstallScriptGenerator::GenerateScript(std::ostream& os)
     this->CreateComponentTest(this->Component.c_str(), this->ExcludeFromAll);
   os << indent << "if(" << component_test << ")\n";
 
+  if (this->RunInstallQueue) {
+    os << indent.Next() << "file(INSTALL_QUEUE RUN)\n";
+  }
   if (this->Code) {
     os << indent.Next() << this->Script << "\n";
   } else {
@@ -20,10 +20,13 @@ public:
                            const char* component, bool exclude_from_all);
   ~cmInstallScriptGenerator() CM_OVERRIDE;
 
+  void Compute(cmLocalGenerator* lg) CM_OVERRIDE;
+
 protected:
   void GenerateScript(std::ostream& os) CM_OVERRIDE;
   std::string Script;
   bool Code;
+  bool RunInstallQueue;
 };
 
 #endif
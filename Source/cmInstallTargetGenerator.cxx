@@ -453,7 +453,24 @@ void cmInstallTargetGenerator::AddTweak(std::ostream& os, Indent indent,
   (this->*tweak)(tw, indent.Next(), config, file);
   std::string tws = tw.str();
   if (!tws.empty()) {
-    os << indent << "if(EXISTS \"" << file << "\" AND\n"
+    bool const queued =
+      tweak == &cmInstallTargetGenerator::PostReplacementTweaks &&
+      this->Target->Target->GetMakefile()->IsSet(
+        "CMAKE_INSTALL_PARALLEL_LEVEL");
+    if (queued) {
+      // The file may be queued for installation, and its tweaks with it.
+      os << indent << "file(INSTALL_QUEUE IS_QUEUED \"" << file
+         << "\" CMAKE_INSTALL_FILE_QUEUED)\n";
+    }
+    os << indent << "if(";
+    if (tweak == &cmInstallTargetGenerator::PreReplacementTweaks) {
+      // The RPATH check must also see a copy an incremental installation
+      // would reuse, before this one exists.
+      os << "CMAKE_INSTALL_REUSE_TREE OR\n" << indent << "   ";
+    } else if (queued) {
+      os << "CMAKE_INSTALL_FILE_QUEUED OR\n" << indent << "   ";
+    }
+    os << "EXISTS \"" << file << "\" AND\n"
        << indent << "   NOT IS_SYMLINK \"" << file << "\")\n";
     os << tws;
     os << indent << "endif()\n";
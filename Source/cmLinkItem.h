@@ -59,18 +59,34 @@ public:
     dependencies needed by the object files of the target.  */
 struct cmLinkImplementationLibraries
 {
+  cmLinkImplementationLibraries()
+    : HadContextSensitiveCondition(false)
+  {
+  }
+
   // Libraries linked directly in this configuration.
   std::vector<cmLinkImplItem> Libraries;
 
   // Libraries linked directly in other configurations.
   // Needed only for OLD behavior of CMP0003.
   std::vector<cmLinkItem> WrongConfigLibraries;
+
+  // Whether Libraries may differ in other configurations.
+  bool HadContextSensitiveCondition;
 };
 
 struct cmLinkInterfaceLibraries
 {
+  cmLinkInterfaceLibraries()
+    : HadContextSensitiveCondition(false)
+  {
+  }
+
   // Libraries listed in the interface.
   std::vector<cmLinkItem> Libraries;
+
+  // Whether Libraries may differ in other configurations.
+  bool HadContextSensitiveCondition;
 };
 
 struct cmLinkInterface : public cmLinkInterfaceLibraries
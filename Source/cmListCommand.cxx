@@ -13,6 +13,7 @@
 #include "cmAlgorithms.h"
 #include "cmMakefile.h"
 #include "cmPolicies.h"
+#include "cmRegexCache.h"
 #include "cmSystemTools.h"
 #include "cmake.h"
 
@@ -81,18 +82,42 @@ bool cmListCommand::GetListString(std::string& listString,
 bool cmListCommand::GetList(std::vector<std::string>& list,
                             const std::string& var)
 {
-  std::string listString;
-  if (!this->GetListString(listString, var)) {
+  std::vector<std::string> const* elements;
+  if (!this->GetListElements(elements, list, var)) {
     return false;
   }
-  // if the size of the list
-  if (listString.empty()) {
-    return true;
+  if (elements != &list) {
+    list = *elements;
+  }
+  return true;
+}
+
+bool cmListCommand::GetListElements(std::vector<std::string> const*& elements,
+                                    std::vector<std::string>& storage,
+                                    const std::string& var)
+{
+  // do not copy the value, loops may read a long list many times
+  const char* listString = this->Makefile->GetDefinition(var);
+  if (!listString) {
+    return false;
+  }
+  // a normal variable keeps its elements, so they are not split again
+  bool hasEmpty = false;
+  elements = this->Makefile->GetDefinitionList(var, hasEmpty);
+  if (!elements) {
+    elements = &storage;
+    // if the size of the list
+    if (!*listString) {
+      return true;
+    }
+    // expand the variable into a list
+    cmSystemTools::ExpandListArgument(listString, storage, true);
+    hasEmpty =
+      std::find(storage.begin(), storage.end(), std::string()) !=
+      storage.end();
   }
-  // expand the variable into a list
-  cmSystemTools::ExpandListArgument(listString, list, true);
   // if no empty elements then just return
-  if (std::find(list.begin(), list.end(), std::string()) == list.end()) {
+  if (!hasEmpty) {
     return true;
   }
   // if we have empty elements we need to check policy CMP0007
@@ -102,8 +127,9 @@ bool cmListCommand::GetList(std::vector<std::string>& list,
       // OLD behavior is to allow compatibility, so recall
       // ExpandListArgument without the true which will remove
       // empty values
-      list.clear();
-      cmSystemTools::ExpandListArgument(listString, list);
+      storage.clear();
+      cmSystemTools::ExpandListArgument(listString, storage);
+      elements = &storage;
       std::string warn = cmPolicies::GetPolicyWarning(cmPolicies::CMP0007);
       warn += " List has value = [";
       warn += listString;
@@ -115,8 +141,9 @@ bool cmListCommand::GetList(std::vector<std::string>& list,
       // OLD behavior is to allow compatibility, so recall
       // ExpandListArgument without the true which will remove
       // empty values
-      list.clear();
-      cmSystemTools::ExpandListArgument(listString, list);
+      storage.clear();
+      cmSystemTools::ExpandListArgument(listString, storage);
+      elements = &storage;
       return true;
     case cmPolicies::NEW:
       return true;
@@ -139,12 +166,13 @@ bool cmListCommand::HandleLengthCommand(std::vector<std::string> const& args)
 
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
-  std::vector<std::string> varArgsExpanded;
+  std::vector<std::string> varArgsStorage;
+  std::vector<std::string> const* varArgsExpanded = &varArgsStorage;
   // do not check the return value here
   // if the list var is not found varArgsExpanded will have size 0
   // and we will return 0
-  this->GetList(varArgsExpanded, listName);
-  size_t length = varArgsExpanded.size();
+  this->GetListElements(varArgsExpanded, varArgsStorage, listName);
+  size_t length = varArgsExpanded->size();
   char buffer[1024];
   sprintf(buffer, "%d", static_cast<int>(length));
 
@@ -162,13 +190,14 @@ bool cmListCommand::HandleGetCommand(std::vector<std::string> const& args)
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
   // expand the variable
-  std::vector<std::string> varArgsExpanded;
-  if (!this->GetList(varArgsExpanded, listName)) {
+  std::vector<std::string> varArgsStorage;
+  std::vector<std::string> const* varArgsExpanded;
+  if (!this->GetListElements(varArgsExpanded, varArgsStorage, listName)) {
     this->Makefile->AddDefinition(variableName, "NOTFOUND");
     return true;
   }
   // FIXME: Add policy to make non-existing lists an error like empty lists.
-  if (varArgsExpanded.empty()) {
+  if (varArgsExpanded->empty()) {
     this->SetError("GET given empty list");
     return false;
   }
@@ -176,7 +205,7 @@ bool cmListCommand::HandleGetCommand(std::vector<std::string> const& args)
   std::string value;
   size_t cc;
   const char* sep = "";
-  size_t nitem = varArgsExpanded.size();
+  size_t nitem = varArgsExpanded->size();
   for (cc = 2; cc < args.size() - 1; cc++) {
     int item = atoi(args[cc].c_str());
     value += sep;
@@ -191,7 +220,7 @@ bool cmListCommand::HandleGetCommand(std::vector<std::string> const& args)
       this->SetError(str.str());
       return false;
     }
-    value += varArgsExpanded[item];
+    value += (*varArgsExpanded)[item];
   }
 
   this->Makefile->AddDefinition(variableName, value.c_str());
@@ -208,14 +237,19 @@ bool cmListCommand::HandleAppendCommand(std::vector<std::string> const& args)
   }
 
   const std::string& listName = args[1];
-  // expand the variable
-  std::string listString;
-  this->GetListString(listString, listName);
+  std::string const value = cmJoin(cmMakeRange(args).advance(2), ";");
+  // append in place to a variable of this scope so a loop appending to
+  // a long list does not copy it each time
+  const char* listValue = this->Makefile->GetDefinition(listName);
+  if (listValue && this->Makefile->AppendListDefinition(listName, value)) {
+    return true;
+  }
 
-  if (!listString.empty() && !args.empty()) {
+  std::string listString = listValue ? listValue : "";
+  if (!listString.empty()) {
     listString += ";";
   }
-  listString += cmJoin(cmMakeRange(args).advance(2), ";");
+  listString += value;
 
   this->Makefile->AddDefinition(listName, listString.c_str());
   return true;
@@ -231,17 +265,18 @@ bool cmListCommand::HandleFindCommand(std::vector<std::string> const& args)
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
   // expand the variable
-  std::vector<std::string> varArgsExpanded;
-  if (!this->GetList(varArgsExpanded, listName)) {
+  std::vector<std::string> varArgsStorage;
+  std::vector<std::string> const* varArgsExpanded;
+  if (!this->GetListElements(varArgsExpanded, varArgsStorage, listName)) {
     this->Makefile->AddDefinition(variableName, "-1");
     return true;
   }
 
-  std::vector<std::string>::iterator it =
-    std::find(varArgsExpanded.begin(), varArgsExpanded.end(), args[2]);
-  if (it != varArgsExpanded.end()) {
+  std::vector<std::string>::const_iterator it =
+    std::find(varArgsExpanded->begin(), varArgsExpanded->end(), args[2]);
+  if (it != varArgsExpanded->end()) {
     std::ostringstream indexStream;
-    indexStream << std::distance(varArgsExpanded.begin(), it);
+    indexStream << std::distance(varArgsExpanded->begin(), it);
     this->Makefile->AddDefinition(variableName, indexStream.str().c_str());
     return true;
   }
@@ -524,8 +559,8 @@ bool cmListCommand::FilterRegex(std::vector<std::string> const& args,
                                 std::vector<std::string>& varArgsExpanded)
 {
   const std::string& pattern = args[4];
-  cmsys::RegularExpression regex(pattern);
-  if (!regex.is_valid()) {
+  cmsys::RegularExpression regex;
+  if (!cmRegexCache::Compile(regex, pattern)) {
     std::string error = "sub-command FILTER, mode REGEX ";
     error += "failed to compile regex \"";
     error += pattern;
@@ -48,6 +48,11 @@ protected:
                    std::vector<std::string>& varArgsExpanded);
 
   bool GetList(std::vector<std::string>& list, const std::string& var);
+  // Get the elements without copying them from the variable if possible.
+  // Otherwise they are stored in 'storage'.
+  bool GetListElements(std::vector<std::string> const*& elements,
+                       std::vector<std::string>& storage,
+                       const std::string& var);
   bool GetListString(std::string& listString, const std::string& var);
 };
 
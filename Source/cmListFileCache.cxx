@@ -10,9 +10,16 @@
 #include "cmake.h"
 
 #include "cmConfigure.h"
+#include "cm_unordered_map.hxx"
 #include <algorithm>
+#include <map>
 #include <assert.h>
 #include <sstream>
+#include <time.h>
+
+#ifdef CMAKE_USE_LIBUV
+#include "cm_uv.h"
+#endif
 
 struct cmListFileParser
 {
@@ -31,6 +38,8 @@ struct cmListFileParser
   const char* FileName;
   cmListFileLexer* Lexer;
   cmListFileFunction Function;
+  std::vector<cmListFileArgument> FunctionArguments;
+  bool IssuedWarning;
   enum
   {
     SeparationOkay,
@@ -48,6 +57,7 @@ cmListFileParser::cmListFileParser(cmListFile* lf,
   , Messenger(messenger)
   , FileName(filename)
   , Lexer(cmListFileLexer_New())
+  , IssuedWarning(false)
 {
 }
 
@@ -133,6 +143,30 @@ bool cmListFileParser::ParseFile()
   return true;
 }
 
+namespace {
+struct cmListFileCacheEntry
+{
+  cmListFileCacheEntry()
+    : ModifiedTime(0)
+    , Length(0)
+    , Parsed(false)
+  {
+  }
+  long ModifiedTime;
+  unsigned long Length;
+  bool Parsed;
+  std::vector<cmListFileFunction> Functions;
+};
+typedef CM_UNORDERED_MAP<std::string, cmListFileCacheEntry>
+  cmListFileCacheMap;
+}
+
+static cmListFileCacheMap& cmListFileCacheGetMap()
+{
+  static cmListFileCacheMap map;
+  return map;
+}
+
 bool cmListFile::ParseFile(const char* filename, cmMessenger* messenger,
                            cmListFileBacktrace const& lfbt)
 {
@@ -141,11 +175,42 @@ bool cmListFile::ParseFile(const char* filename, cmMessenger* messenger,
     return false;
   }
 
+  // Modules are included from many directories.  Reuse the functions of
+  // a file that was parsed before if it has not changed since.
+  long const modifiedTime = cmSystemTools::ModifiedTime(filename);
+  unsigned long const length = cmSystemTools::FileLength(filename);
+  cmListFileCacheEntry& entry = cmListFileCacheGetMap()[filename];
+  bool const unchanged =
+    entry.ModifiedTime == modifiedTime && entry.Length == length;
+  if (unchanged && entry.Parsed) {
+    this->Functions = entry.Functions;
+    return true;
+  }
+
   bool parseError = false;
+  bool issuedWarning = false;
 
   {
     cmListFileParser parser(this, lfbt, messenger, filename);
     parseError = !parser.ParseFile();
+    issuedWarning = parser.IssuedWarning;
+  }
+
+  // Keep the functions once a file is read for the second time so that
+  // files read only once do not stay in memory.  Files with diagnostics
+  // are parsed again to repeat them.  A file modified within the last
+  // seconds may be rewritten without changing its time stamp.
+  if (parseError || issuedWarning ||
+      modifiedTime + 2 >= static_cast<long>(time(CM_NULLPTR))) {
+    entry = cmListFileCacheEntry();
+  } else if (unchanged) {
+    entry.Functions = this->Functions;
+    entry.Parsed = true;
+  } else {
+    entry.ModifiedTime = modifiedTime;
+    entry.Length = length;
+    entry.Parsed = false;
+    entry.Functions.clear();
   }
 
   return !parseError;
@@ -157,6 +222,7 @@ bool cmListFileParser::ParseFunction(const char* name, long line)
   this->Function = cmListFileFunction();
   this->Function.Name = name;
   this->Function.Line = line;
+  this->FunctionArguments.clear();
 
   // Command name has already been parsed.  Read the left paren.
   cmListFileLexer_Token* token;
@@ -200,6 +266,7 @@ bool cmListFileParser::ParseFunction(const char* name, long line)
       }
     } else if (token->type == cmListFileLexer_Token_ParenRight) {
       if (parenDepth == 0) {
+        this->Function.SetArguments(this->FunctionArguments);
         return true;
       }
       parenDepth--;
@@ -254,7 +321,7 @@ bool cmListFileParser::AddArgument(cmListFileLexer_Token* token,
                                    cmListFileArgument::Delimiter delim)
 {
   cmListFileArgument a(token->text, delim, token->line);
-  this->Function.Arguments.push_back(a);
+  this->FunctionArguments.push_back(a);
   if (this->Separation == SeparationOkay) {
     return true;
   }
@@ -276,94 +343,267 @@ bool cmListFileParser::AddArgument(cmListFileLexer_Token* token,
     return false;
   }
   this->Messenger->IssueMessage(cmake::AUTHOR_WARNING, m.str(), lfbt);
+  this->IssuedWarning = true;
   return true;
 }
 
-struct cmListFileBacktrace::Entry : public cmListFileContext
+struct cmListFileFunction::Storage
+{
+  std::vector<cmListFileArgument> Arguments;
+  unsigned int RefCount;
+};
+
+cmListFileFunction::cmListFileFunction()
+  : Args(CM_NULLPTR)
+{
+}
+
+cmListFileFunction::cmListFileFunction(cmListFileFunction const& r)
+  : cmCommandContext(r)
+  , Args(r.Args)
+{
+  if (this->Args) {
+    ++this->Args->RefCount;
+  }
+}
+
+cmListFileFunction& cmListFileFunction::operator=(cmListFileFunction const& r)
 {
-  Entry(cmListFileContext const& lfc, Entry* up)
-    : cmListFileContext(lfc)
-    , Up(up)
-    , RefCount(0)
+  cmListFileFunction tmp(r);
+  this->Name.swap(tmp.Name);
+  std::swap(this->Line, tmp.Line);
+  std::swap(this->Args, tmp.Args);
+  return *this;
+}
+
+cmListFileFunction::~cmListFileFunction()
+{
+  if (this->Args && --this->Args->RefCount == 0) {
+    delete this->Args;
+  }
+}
+
+std::vector<cmListFileArgument> const& cmListFileFunction::GetArguments()
+  const
+{
+  static std::vector<cmListFileArgument> const empty;
+  return this->Args ? this->Args->Arguments : empty;
+}
+
+void cmListFileFunction::SetArguments(std::vector<cmListFileArgument>& args)
+{
+  Storage* storage = CM_NULLPTR;
+  if (!args.empty()) {
+    storage = new Storage;
+    storage->Arguments.swap(args);
+    storage->RefCount = 1;
+  }
+  if (this->Args && --this->Args->RefCount == 0) {
+    delete this->Args;
+  }
+  this->Args = storage;
+}
+
+namespace {
+// A frame of a backtrace.  Root frames are their own parent and carry
+// only the bottom snapshot.  Other frames refer to their file and
+// command names by index into a table of unique strings.
+struct cmListFileBacktraceFrame
+{
+  unsigned int Parent;
+  unsigned int Bottom;
+  unsigned int FilePath;
+  unsigned int Name;
+  long Line;
+};
+}
+
+// The frames of the backtraces whose bottoms belong to one cmState.
+class cmListFileBacktraceStorage
+{
+  CM_DISABLE_COPY(cmListFileBacktraceStorage)
+
+public:
+  cmListFileBacktraceStorage()
+  {
+#ifdef CMAKE_USE_LIBUV
+    uv_mutex_init(&this->Mutex);
+#endif
+    // Frame 0 is the frame of default-constructed backtraces.
+    cmListFileBacktraceFrame none = { 0, 0, 0, 0, 0 };
+    this->Frames.push_back(none);
+    this->Bottoms.push_back(cmStateSnapshot());
+    this->Strings.push_back(std::string());
+    this->StringIds[std::string()] = 0;
+  }
+  ~cmListFileBacktraceStorage()
+  {
+#ifdef CMAKE_USE_LIBUV
+    uv_mutex_destroy(&this->Mutex);
+#endif
+  }
+
+  void Lock()
   {
-    if (this->Up) {
-      this->Up->Ref();
+#ifdef CMAKE_USE_LIBUV
+    uv_mutex_lock(&this->Mutex);
+#endif
+  }
+  void Unlock()
+  {
+#ifdef CMAKE_USE_LIBUV
+    uv_mutex_unlock(&this->Mutex);
+#endif
+  }
+
+  unsigned int AddRoot(cmStateSnapshot const& bottom)
+  {
+    // Backtraces of the same directory share their root.
+    unsigned int const id = static_cast<unsigned int>(this->Frames.size());
+    std::pair<RootMap::iterator, bool> ins =
+      this->RootIds.insert(RootMap::value_type(bottom, id));
+    if (ins.second) {
+      cmListFileBacktraceFrame frame = { id, 0, 0, 0, 0 };
+      frame.Bottom = static_cast<unsigned int>(this->Bottoms.size());
+      this->Bottoms.push_back(bottom);
+      this->Frames.push_back(frame);
     }
+    return ins.first->second;
   }
-  ~Entry()
+
+  unsigned int AddFrame(unsigned int parent, cmListFileContext const& lfc)
   {
-    if (this->Up) {
-      this->Up->Unref();
+    cmListFileBacktraceFrame frame;
+    frame.Parent = parent;
+    frame.Bottom = this->Frames[parent].Bottom;
+    frame.FilePath = this->Intern(lfc.FilePath);
+    frame.Name = this->Intern(lfc.Name);
+    frame.Line = lfc.Line;
+
+    // Frames are equal if all their fields are equal.
+    std::string key(reinterpret_cast<const char*>(&frame.Parent),
+                    sizeof(frame.Parent));
+    key.append(reinterpret_cast<const char*>(&frame.FilePath),
+               sizeof(frame.FilePath));
+    key.append(reinterpret_cast<const char*>(&frame.Name), sizeof(frame.Name));
+    key.append(reinterpret_cast<const char*>(&frame.Line), sizeof(frame.Line));
+    std::pair<IdMap::iterator, bool> ins = this->FrameIds.insert(
+      IdMap::value_type(key, static_cast<unsigned int>(this->Frames.size())));
+    if (ins.second) {
+      this->Frames.push_back(frame);
     }
+    return ins.first->second;
+  }
+
+  bool IsRoot(unsigned int id) const
+  {
+    return this->Frames[id].Parent == id;
+  }
+
+  unsigned int GetParent(unsigned int id) const
+  {
+    return this->Frames[id].Parent;
+  }
+
+  bool HasName(unsigned int id) const { return this->Frames[id].Name != 0; }
+
+  cmStateSnapshot const& GetBottom(unsigned int id) const
+  {
+    return this->Bottoms[this->Frames[id].Bottom];
   }
-  void Ref() { ++this->RefCount; }
-  void Unref()
+
+  cmListFileContext GetContext(unsigned int id) const
   {
-    if (--this->RefCount == 0) {
-      delete this;
+    cmListFileBacktraceFrame const& frame = this->Frames[id];
+    cmListFileContext lfc;
+    lfc.FilePath = this->Strings[frame.FilePath];
+    lfc.Name = this->Strings[frame.Name];
+    lfc.Line = frame.Line;
+    return lfc;
+  }
+
+private:
+  typedef CM_UNORDERED_MAP<std::string, unsigned int> IdMap;
+  typedef std::map<cmStateSnapshot, unsigned int,
+                   cmStateSnapshot::StrictWeakOrder>
+    RootMap;
+
+  unsigned int Intern(std::string const& str)
+  {
+    std::pair<IdMap::iterator, bool> ins = this->StringIds.insert(
+      IdMap::value_type(str, static_cast<unsigned int>(this->Strings.size())));
+    if (ins.second) {
+      this->Strings.push_back(str);
     }
+    return ins.first->second;
   }
-  Entry* Up;
-  unsigned int RefCount;
+
+  std::vector<cmListFileBacktraceFrame> Frames;
+  std::vector<cmStateSnapshot> Bottoms;
+  std::vector<std::string> Strings;
+  IdMap StringIds;
+  IdMap FrameIds;
+  RootMap RootIds;
+#ifdef CMAKE_USE_LIBUV
+  uv_mutex_t Mutex;
+#endif
 };
 
-cmListFileBacktrace::cmListFileBacktrace(cmStateSnapshot const& bottom,
-                                         Entry* up,
-                                         cmListFileContext const& lfc)
-  : Bottom(bottom)
-  , Cur(new Entry(lfc, up))
+namespace {
+class cmListFileBacktraceLock
 {
-  assert(this->Bottom.IsValid());
-  this->Cur->Ref();
+  CM_DISABLE_COPY(cmListFileBacktraceLock)
+
+public:
+  cmListFileBacktraceLock(cmListFileBacktraceStorage* storage)
+    : Storage(storage)
+  {
+    this->Storage->Lock();
+  }
+  ~cmListFileBacktraceLock() { this->Storage->Unlock(); }
+  cmListFileBacktraceStorage* operator->() { return this->Storage; }
+
+private:
+  cmListFileBacktraceStorage* Storage;
+};
 }
 
-cmListFileBacktrace::cmListFileBacktrace(cmStateSnapshot const& bottom,
-                                         Entry* cur)
-  : Bottom(bottom)
-  , Cur(cur)
+cmListFileBacktraceStorage* cmListFileBacktrace::CreateStorage()
 {
-  if (this->Cur) {
-    assert(this->Bottom.IsValid());
-    this->Cur->Ref();
-  }
+  return new cmListFileBacktraceStorage;
 }
 
-cmListFileBacktrace::cmListFileBacktrace()
-  : Bottom()
-  , Cur(CM_NULLPTR)
+void cmListFileBacktrace::DestroyStorage(cmListFileBacktraceStorage* storage)
 {
+  delete storage;
 }
 
-cmListFileBacktrace::cmListFileBacktrace(cmStateSnapshot const& snapshot)
-  : Bottom(snapshot.GetCallStackBottom())
-  , Cur(CM_NULLPTR)
+cmListFileBacktrace::cmListFileBacktrace()
+  : Storage(CM_NULLPTR)
+  , Frame(0)
 {
 }
 
-cmListFileBacktrace::cmListFileBacktrace(cmListFileBacktrace const& r)
-  : Bottom(r.Bottom)
-  , Cur(r.Cur)
+cmListFileBacktrace::cmListFileBacktrace(cmStateSnapshot const& snapshot)
+  : Storage(snapshot.GetState()->GetBacktraceStorage())
+  , Frame(cmListFileBacktraceLock(this->Storage)
+            ->AddRoot(snapshot.GetCallStackBottom()))
 {
-  if (this->Cur) {
-    assert(this->Bottom.IsValid());
-    this->Cur->Ref();
-  }
 }
 
-cmListFileBacktrace& cmListFileBacktrace::operator=(
-  cmListFileBacktrace const& r)
+cmListFileBacktrace::cmListFileBacktrace(cmListFileBacktraceStorage* storage,
+                                         unsigned int frame)
+  : Storage(storage)
+  , Frame(frame)
 {
-  cmListFileBacktrace tmp(r);
-  std::swap(this->Cur, tmp.Cur);
-  std::swap(this->Bottom, tmp.Bottom);
-  return *this;
 }
 
-cmListFileBacktrace::~cmListFileBacktrace()
+cmStateSnapshot cmListFileBacktrace::GetBottom() const
 {
-  if (this->Cur) {
-    this->Cur->Unref();
+  if (!this->Storage) {
+    return cmStateSnapshot();
   }
+  return cmListFileBacktraceLock(this->Storage)->GetBottom(this->Frame);
 }
 
 cmListFileBacktrace cmListFileBacktrace::Push(std::string const& file) const
@@ -374,79 +614,112 @@ cmListFileBacktrace cmListFileBacktrace::Push(std::string const& file) const
   // skipped during call stack printing.
   cmListFileContext lfc;
   lfc.FilePath = file;
-  return cmListFileBacktrace(this->Bottom, this->Cur, lfc);
+  return this->Push(lfc);
 }
 
 cmListFileBacktrace cmListFileBacktrace::Push(
   cmListFileContext const& lfc) const
 {
-  return cmListFileBacktrace(this->Bottom, this->Cur, lfc);
+  assert(this->Storage);
+  return cmListFileBacktrace(
+    this->Storage,
+    cmListFileBacktraceLock(this->Storage)->AddFrame(this->Frame, lfc));
 }
 
 cmListFileBacktrace cmListFileBacktrace::Pop() const
 {
-  assert(this->Cur);
-  return cmListFileBacktrace(this->Bottom, this->Cur->Up);
+  assert(this->Storage);
+  cmListFileBacktraceLock storage(this->Storage);
+  assert(!storage->IsRoot(this->Frame));
+  return cmListFileBacktrace(this->Storage, storage->GetParent(this->Frame));
 }
 
-cmListFileContext const& cmListFileBacktrace::Top() const
+cmListFileContext cmListFileBacktrace::Top() const
 {
-  if (this->Cur) {
-    return *this->Cur;
+  if (!this->Storage) {
+    return cmListFileContext();
+  }
+  cmListFileBacktraceLock storage(this->Storage);
+  if (storage->IsRoot(this->Frame)) {
+    return cmListFileContext();
   }
-  static cmListFileContext const empty;
-  return empty;
+  return storage->GetContext(this->Frame);
 }
 
 void cmListFileBacktrace::PrintTitle(std::ostream& out) const
 {
-  if (!this->Cur) {
+  if (!this->Storage) {
     return;
   }
-  cmOutputConverter converter(this->Bottom);
-  cmListFileContext lfc = *this->Cur;
-  if (!this->Bottom.GetState()->GetIsInTryCompile()) {
+  cmStateSnapshot bottom;
+  cmListFileContext lfc;
+  {
+    cmListFileBacktraceLock storage(this->Storage);
+    if (storage->IsRoot(this->Frame)) {
+      return;
+    }
+    bottom = storage->GetBottom(this->Frame);
+    lfc = storage->GetContext(this->Frame);
+  }
+  cmOutputConverter converter(bottom);
+  if (!bottom.GetState()->GetIsInTryCompile()) {
     lfc.FilePath = converter.ConvertToRelativePath(
-      this->Bottom.GetState()->GetSourceDirectory(), lfc.FilePath);
+      bottom.GetState()->GetSourceDirectory(), lfc.FilePath);
   }
   out << (lfc.Line ? " at " : " in ") << lfc;
 }
 
 void cmListFileBacktrace::PrintCallStack(std::ostream& out) const
 {
-  if (!this->Cur || !this->Cur->Up) {
+  if (!this->Storage) {
     return;
   }
-
-  bool first = true;
-  cmOutputConverter converter(this->Bottom);
-  for (Entry* i = this->Cur->Up; i; i = i->Up) {
-    if (i->Name.empty()) {
-      // Skip this whole-file scope.  When we get here we already will
-      // have printed a more-specific context within the file.
-      continue;
+  cmStateSnapshot bottom;
+  std::vector<cmListFileContext> stack;
+  {
+    cmListFileBacktraceLock storage(this->Storage);
+    if (storage->IsRoot(this->Frame)) {
+      return;
     }
-    if (first) {
-      first = false;
-      out << "Call Stack (most recent call first):\n";
+    bottom = storage->GetBottom(this->Frame);
+    for (unsigned int i = storage->GetParent(this->Frame);
+         !storage->IsRoot(i); i = storage->GetParent(i)) {
+      // Skip whole-file scopes.  When we get here we already will
+      // have printed a more-specific context within the file.
+      if (storage->HasName(i)) {
+        stack.push_back(storage->GetContext(i));
+      }
     }
-    cmListFileContext lfc = *i;
-    if (!this->Bottom.GetState()->GetIsInTryCompile()) {
-      lfc.FilePath = converter.ConvertToRelativePath(
-        this->Bottom.GetState()->GetSourceDirectory(), lfc.FilePath);
+  }
+  if (stack.empty()) {
+    return;
+  }
+
+  out << "Call Stack (most recent call first):\n";
+  cmOutputConverter converter(bottom);
+  for (std::vector<cmListFileContext>::iterator i = stack.begin();
+       i != stack.end(); ++i) {
+    if (!bottom.GetState()->GetIsInTryCompile()) {
+      i->FilePath = converter.ConvertToRelativePath(
+        bottom.GetState()->GetSourceDirectory(), i->FilePath);
     }
-    out << "  " << lfc << "\n";
+    out << "  " << *i << "\n";
   }
 }
 
 size_t cmListFileBacktrace::Depth() const
 {
+  if (!this->Storage) {
+    return 0;
+  }
+  cmListFileBacktraceLock storage(this->Storage);
   size_t depth = 0;
-  if (this->Cur == CM_NULLPTR) {
+  if (storage->IsRoot(this->Frame)) {
     return 0;
   }
 
-  for (Entry* i = this->Cur->Up; i; i = i->Up) {
+  for (unsigned int i = storage->GetParent(this->Frame); !storage->IsRoot(i);
+       i = storage->GetParent(i)) {
     depth++;
   }
   return depth;
@@ -90,13 +90,33 @@ bool operator<(const cmListFileContext& lhs, const cmListFileContext& rhs);
 bool operator==(cmListFileContext const& lhs, cmListFileContext const& rhs);
 bool operator!=(cmListFileContext const& lhs, cmListFileContext const& rhs);
 
+// Represent a command invocation.  The arguments are immutable once set
+// and shared among copies, so recording a function body or reusing a
+// parsed listfile does not copy them.
 struct cmListFileFunction : public cmCommandContext
 {
-  std::vector<cmListFileArgument> Arguments;
+  cmListFileFunction();
+  cmListFileFunction(cmListFileFunction const& r);
+  cmListFileFunction& operator=(cmListFileFunction const& r);
+  ~cmListFileFunction();
+
+  // Get the arguments as written in the listfile.
+  std::vector<cmListFileArgument> const& GetArguments() const;
+
+  // Replace the arguments with the contents of the given vector.
+  // The vector is left empty.
+  void SetArguments(std::vector<cmListFileArgument>& args);
+
+private:
+  struct Storage;
+  Storage* Args;
 };
 
+class cmListFileBacktraceStorage;
+
 // Represent a backtrace (call stack).  Provide value semantics
-// but use efficient reference-counting underneath to avoid copies.
+// but store only a handle to a frame in a table owned by the cmState
+// of its bottom, in which equal call stacks share their frames.
 class cmListFileBacktrace
 {
 public:
@@ -109,12 +129,7 @@ public:
   // indicated by the given valid snapshot.
   cmListFileBacktrace(cmStateSnapshot const& snapshot);
 
-  // Backtraces may be copied and assigned as values.
-  cmListFileBacktrace(cmListFileBacktrace const& r);
-  cmListFileBacktrace& operator=(cmListFileBacktrace const& r);
-  ~cmListFileBacktrace();
-
-  cmStateSnapshot GetBottom() const { return this->Bottom; }
+  cmStateSnapshot GetBottom() const;
 
   // Get a backtrace with the given file scope added to the top.
   // May not be called until after construction with a valid snapshot.
@@ -130,7 +145,7 @@ public:
 
   // Get the context at the top of the backtrace.
   // Returns an empty context if the backtrace is empty.
-  cmListFileContext const& Top() const;
+  cmListFileContext Top() const;
 
   // Print the top of the backtrace.
   void PrintTitle(std::ostream& out) const;
@@ -141,18 +156,22 @@ public:
   // Get the number of 'frames' in this backtrace
   size_t Depth() const;
 
+  // Create and destroy the table of frames of a cmState.
+  static cmListFileBacktraceStorage* CreateStorage();
+  static void DestroyStorage(cmListFileBacktraceStorage* storage);
+
 private:
-  struct Entry;
+  cmListFileBacktrace(cmListFileBacktraceStorage* storage,
+                      unsigned int frame);
 
-  cmStateSnapshot Bottom;
-  Entry* Cur;
-  cmListFileBacktrace(cmStateSnapshot const& bottom, Entry* up,
-                      cmListFileContext const& lfc);
-  cmListFileBacktrace(cmStateSnapshot const& bottom, Entry* cur);
+  cmListFileBacktraceStorage* Storage;
+  unsigned int Frame;
 };
 
 struct cmListFile
 {
+  // Parse the given file.  Files that are read more than once are parsed
+  // only once per process as long as they do not change on disk.
   bool ParseFile(const char* path, cmMessenger* messenger,
                  cmListFileBacktrace const& lfbt);
 
@@ -153,9 +153,9 @@ cmLocalGenerator::cmLocalGenerator(cmGlobalGenerator* gg, cmMakefile* makefile)
 cmRulePlaceholderExpander* cmLocalGenerator::CreateRulePlaceholderExpander()
   const
 {
-  return new cmRulePlaceholderExpander(this->Compilers, this->VariableMappings,
-                                       this->CompilerSysroot,
-                                       this->LinkerSysroot);
+  return new cmRulePlaceholderExpander(
+    this->Compilers, this->VariableMappings, this->CompilerSysroot,
+    this->LinkerSysroot, &this->RulePlaceholderCache);
 }
 
 cmLocalGenerator::~cmLocalGenerator()
@@ -495,6 +495,27 @@ void cmLocalGenerator::GenerateInstallRules()
     /* clang-format on */
   }
 
+  // Queue the files installed by the rules below to install them on
+  // several threads.
+  const char* parallel_level =
+    this->Makefile->GetDefinition("CMAKE_INSTALL_PARALLEL_LEVEL");
+  if (parallel_level && *parallel_level) {
+    /* clang-format off */
+    fout <<
+      "# Set the number of threads to install files on.\n"
+      "if(NOT DEFINED CMAKE_INSTALL_PARALLEL_LEVEL)\n"
+      "  if(DEFINED ENV{CMAKE_INSTALL_PARALLEL_LEVEL})\n"
+      "    set(CMAKE_INSTALL_PARALLEL_LEVEL "
+      "\"$ENV{CMAKE_INSTALL_PARALLEL_LEVEL}\")\n"
+      "  else()\n"
+      "    set(CMAKE_INSTALL_PARALLEL_LEVEL \"" << parallel_level << "\")\n"
+      "  endif()\n"
+      "endif()\n"
+      "file(INSTALL_QUEUE BEGIN)\n"
+      "\n";
+    /* clang-format on */
+  }
+
   // Ask each install generator to write its code.
   std::vector<cmInstallGenerator*> const& installers =
     this->Makefile->GetInstallGenerators();
@@ -526,6 +547,11 @@ void cmLocalGenerator::GenerateInstallRules()
     fout << "endif()\n\n";
   }
 
+  // Install the queued files.
+  if (parallel_level && *parallel_level) {
+    fout << "file(INSTALL_QUEUE END)\n\n";
+  }
+
   // Record the install manifest.
   if (toplevel_install) {
     /* clang-format off */
@@ -548,12 +574,16 @@ void cmLocalGenerator::GenerateInstallRules()
 void cmLocalGenerator::AddGeneratorTarget(cmGeneratorTarget* gt)
 {
   this->GeneratorTargets.push_back(gt);
+  this->GeneratorTargetSearchIndex.insert(
+    GeneratorTargetMap::value_type(gt->GetName(), gt));
   this->GlobalGenerator->IndexGeneratorTarget(gt);
 }
 
 void cmLocalGenerator::AddImportedGeneratorTarget(cmGeneratorTarget* gt)
 {
   this->ImportedGeneratorTargets.push_back(gt);
+  this->ImportedGeneratorTargetSearchIndex.insert(
+    GeneratorTargetMap::value_type(gt->GetName(), gt));
   this->GlobalGenerator->IndexGeneratorTarget(gt);
 }
 
@@ -562,30 +592,13 @@ void cmLocalGenerator::AddOwnedImportedGeneratorTarget(cmGeneratorTarget* gt)
   this->OwnedImportedGeneratorTargets.push_back(gt);
 }
 
-struct NamedGeneratorTargetFinder
-{
-  NamedGeneratorTargetFinder(std::string const& name)
-    : Name(name)
-  {
-  }
-
-  bool operator()(cmGeneratorTarget* tgt)
-  {
-    return tgt->GetName() == this->Name;
-  }
-
-private:
-  std::string Name;
-};
-
 cmGeneratorTarget* cmLocalGenerator::FindLocalNonAliasGeneratorTarget(
   const std::string& name) const
 {
-  std::vector<cmGeneratorTarget*>::const_iterator ti =
-    std::find_if(this->GeneratorTargets.begin(), this->GeneratorTargets.end(),
-                 NamedGeneratorTargetFinder(name));
-  if (ti != this->GeneratorTargets.end()) {
-    return *ti;
+  GeneratorTargetMap::const_iterator ti =
+    this->GeneratorTargetSearchIndex.find(name);
+  if (ti != this->GeneratorTargetSearchIndex.end()) {
+    return ti->second;
   }
   return CM_NULLPTR;
 }
@@ -1416,11 +1429,10 @@ void cmLocalGenerator::AddLanguageFlagsForLinking(
 cmGeneratorTarget* cmLocalGenerator::FindGeneratorTargetToUse(
   const std::string& name) const
 {
-  std::vector<cmGeneratorTarget*>::const_iterator imported = std::find_if(
-    this->ImportedGeneratorTargets.begin(),
-    this->ImportedGeneratorTargets.end(), NamedGeneratorTargetFinder(name));
-  if (imported != this->ImportedGeneratorTargets.end()) {
-    return *imported;
+  GeneratorTargetMap::const_iterator imported =
+    this->ImportedGeneratorTargetSearchIndex.find(name);
+  if (imported != this->ImportedGeneratorTargetSearchIndex.end()) {
+    return imported->second;
   }
 
   if (cmGeneratorTarget* t = this->FindLocalNonAliasGeneratorTarget(name)) {
@@ -2343,6 +2355,31 @@ bool cmLocalGenerator::IsNMake() const
 std::string cmLocalGenerator::GetObjectFileNameWithoutTarget(
   const cmSourceFile& source, std::string const& dir_max,
   bool* hasSourceExtension, char const* customOutputExtension)
+{
+  std::string const objectName = this->ComputeObjectFileName(
+    source, this->ReplaceObjectFileExtension(source), hasSourceExtension,
+    customOutputExtension);
+
+  // Convert to a safe name.
+  return this->CreateSafeUniqueObjectFileName(objectName, dir_max);
+}
+
+bool cmLocalGenerator::ReplaceObjectFileExtension(const cmSourceFile& source)
+{
+  // For CMake 2.4 compatibility replace the extension by default.
+  if (this->NeedBackwardsCompatibility_2_4()) {
+    return true;
+  }
+  std::string const lang = source.GetLanguage();
+  if (lang.empty()) {
+    return false;
+  }
+  return this->Makefile->IsOn("CMAKE_" + lang + "_OUTPUT_EXTENSION_REPLACE");
+}
+
+std::string cmLocalGenerator::ComputeObjectFileName(
+  const cmSourceFile& source, bool replaceExtension, bool* hasSourceExtension,
+  char const* customOutputExtension) const
 {
   // Construct the object file name using the full path to the source
   // file which is its only unique identification.
@@ -2388,22 +2425,8 @@ std::string cmLocalGenerator::GetObjectFileNameWithoutTarget(
   // extension.
   bool keptSourceExtension = true;
   if (!source.GetPropertyAsBool("KEEP_EXTENSION")) {
-    // Decide whether this language wants to replace the source
-    // extension with the object extension.  For CMake 2.4
-    // compatibility do this by default.
-    bool replaceExt = this->NeedBackwardsCompatibility_2_4();
-    if (!replaceExt) {
-      std::string lang = source.GetLanguage();
-      if (!lang.empty()) {
-        std::string repVar = "CMAKE_";
-        repVar += lang;
-        repVar += "_OUTPUT_EXTENSION_REPLACE";
-        replaceExt = this->Makefile->IsOn(repVar);
-      }
-    }
-
     // Remove the source extension if it is to be replaced.
-    if (replaceExt || customOutputExtension) {
+    if (replaceExtension || customOutputExtension) {
       keptSourceExtension = false;
       std::string::size_type dot_pos = objectName.rfind('.');
       if (dot_pos != std::string::npos) {
@@ -2421,9 +2444,7 @@ std::string cmLocalGenerator::GetObjectFileNameWithoutTarget(
   if (hasSourceExtension) {
     *hasSourceExtension = keptSourceExtension;
   }
-
-  // Convert to a safe name.
-  return this->CreateSafeUniqueObjectFileName(objectName, dir_max);
+  return objectName;
 }
 
 std::string cmLocalGenerator::GetSourceFileLanguage(const cmSourceFile& source)
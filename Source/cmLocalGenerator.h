@@ -6,6 +6,7 @@
 #include "cmConfigure.h"
 
 #include "cm_kwiml.h"
+#include "cm_unordered_map.hxx"
 #include <iosfwd>
 #include <map>
 #include <set>
@@ -15,6 +16,7 @@
 #include "cmListFileCache.h"
 #include "cmOutputConverter.h"
 #include "cmPolicies.h"
+#include "cmRulePlaceholderExpander.h"
 #include "cmStateSnapshot.h"
 #include "cmake.h"
 
@@ -24,7 +26,6 @@ class cmGeneratorTarget;
 class cmGlobalGenerator;
 class cmLinkLineComputer;
 class cmMakefile;
-class cmRulePlaceholderExpander;
 class cmSourceFile;
 class cmState;
 
@@ -285,6 +286,22 @@ public:
     bool* hasSourceExtension = CM_NULLPTR,
     char const* customOutputExtension = CM_NULLPTR);
 
+  /** Compute the object file name of a source file before it is made
+      safe and unique by CreateSafeUniqueObjectFileName.  This reads
+      only state that does not change during generation, so it may be
+      called concurrently.  */
+  std::string ComputeObjectFileName(const cmSourceFile& source,
+                                    bool replaceExtension,
+                                    bool* hasSourceExtension,
+                                    char const* customOutputExtension) const;
+
+  /** Return whether the object file name of a source file replaces the
+      source extension instead of appending to it.  */
+  bool ReplaceObjectFileExtension(const cmSourceFile& source);
+
+  std::string& CreateSafeUniqueObjectFileName(const std::string& sin,
+                                              std::string const& dir_max);
+
   /** Fill out the static linker flags for the given target.  */
   void GetStaticLibraryFlags(std::string& flags, std::string const& config,
                              cmGeneratorTarget* target);
@@ -338,9 +355,6 @@ protected:
     std::ostream& os, const std::string& config,
     std::vector<std::string> const& configurationTypes);
 
-  std::string& CreateSafeUniqueObjectFileName(const std::string& sin,
-                                              std::string const& dir_max);
-
   /** Check whether the native build system supports the given
       definition.  Issues a warning.  */
   virtual bool CheckDefinition(std::string const& define) const;
@@ -357,12 +371,16 @@ protected:
   std::vector<cmGeneratorTarget*> GeneratorTargets;
   std::vector<cmGeneratorTarget*> ImportedGeneratorTargets;
   std::vector<cmGeneratorTarget*> OwnedImportedGeneratorTargets;
+  typedef CM_UNORDERED_MAP<std::string, cmGeneratorTarget*> GeneratorTargetMap;
+  GeneratorTargetMap GeneratorTargetSearchIndex;
+  GeneratorTargetMap ImportedGeneratorTargetSearchIndex;
   std::map<std::string, std::string> AliasTargets;
 
   std::map<std::string, std::string> Compilers;
   std::map<std::string, std::string> VariableMappings;
   std::string CompilerSysroot;
   std::string LinkerSysroot;
+  mutable cmRulePlaceholderExpander::RuleCache RulePlaceholderCache;
 
   bool EmitUniversalBinaryFlags;
 
@@ -39,7 +39,8 @@ cmLocalNinjaGenerator::CreateRulePlaceholderExpander() const
 {
   cmRulePlaceholderExpander* ret =
     new cmRulePlaceholderExpander(this->Compilers, this->VariableMappings,
-                                  this->CompilerSysroot, this->LinkerSysroot);
+                                  this->CompilerSysroot, this->LinkerSysroot,
+                                  &this->RulePlaceholderCache);
   ret->SetTargetImpLib("$TARGET_IMPLIB");
   return ret;
 }
@@ -58,11 +59,6 @@ void cmLocalNinjaGenerator::Generate()
     this->HomeRelativeOutputPath = "";
   }
 
-  this->WriteProcessedMakefile(this->GetBuildFileStream());
-#ifdef NINJA_GEN_VERBOSE_FILES
-  this->WriteProcessedMakefile(this->GetRulesFileStream());
-#endif
-
   // We do that only once for the top CMakeLists.txt file.
   if (this->IsRootMakefile()) {
     this->WriteBuildFileTop();
@@ -79,10 +75,18 @@ void cmLocalNinjaGenerator::Generate()
     }
   }
 
+  this->GetGlobalNinjaGenerator()->OpenDirectoryBuildFileStream(this);
+
+  this->WriteProcessedMakefile(this->GetBuildFileStream());
+#ifdef NINJA_GEN_VERBOSE_FILES
+  this->WriteProcessedMakefile(this->GetRulesFileStream());
+#endif
+
   std::vector<cmGeneratorTarget*> targets = this->GetGeneratorTargets();
   for (std::vector<cmGeneratorTarget*>::iterator t = targets.begin();
        t != targets.end(); ++t) {
-    if ((*t)->GetType() == cmStateEnums::INTERFACE_LIBRARY) {
+    if ((*t)->GetType() == cmStateEnums::INTERFACE_LIBRARY ||
+        !this->GetGlobalNinjaGenerator()->IsTargetInFocus(*t)) {
       continue;
     }
     cmNinjaTargetGenerator* tg = cmNinjaTargetGenerator::New(*t);
@@ -98,6 +102,8 @@ void cmLocalNinjaGenerator::Generate()
   }
 
   this->WriteCustomCommandBuildStatements();
+
+  this->GetGlobalNinjaGenerator()->CloseDirectoryBuildFileStream();
 }
 
 // TODO: Picked up from cmLocalUnixMakefileGenerator3.  Refactor it.
@@ -97,18 +97,20 @@ bool cmMacroHelperCommand::InvokeInitialPass(
   }
   // Invoke all the functions that were collected in the block.
   cmListFileFunction newLFF;
+  std::vector<cmListFileArgument> newLFFArgs;
   // for each function
   for (unsigned int c = 0; c < this->Functions.size(); ++c) {
     // Replace the formal arguments and then invoke the command.
-    newLFF.Arguments.clear();
-    newLFF.Arguments.reserve(this->Functions[c].Arguments.size());
+    std::vector<cmListFileArgument> const& lffArgs =
+      this->Functions[c].GetArguments();
+    newLFFArgs.clear();
+    newLFFArgs.reserve(lffArgs.size());
     newLFF.Name = this->Functions[c].Name;
     newLFF.Line = this->Functions[c].Line;
 
     // for each argument of the current function
-    for (std::vector<cmListFileArgument>::iterator k =
-           this->Functions[c].Arguments.begin();
-         k != this->Functions[c].Arguments.end(); ++k) {
+    for (std::vector<cmListFileArgument>::const_iterator k = lffArgs.begin();
+         k != lffArgs.end(); ++k) {
       cmListFileArgument arg;
       arg.Value = k->Value;
       if (k->Delim != cmListFileArgument::Bracket) {
@@ -133,8 +135,9 @@ bool cmMacroHelperCommand::InvokeInitialPass(
       }
       arg.Delim = k->Delim;
       arg.Line = k->Line;
-      newLFF.Arguments.push_back(arg);
+      newLFFArgs.push_back(arg);
     }
+    newLFF.SetArguments(newLFFArgs);
     cmExecutionStatus status;
     if (!this->Makefile->ExecuteCommand(newLFF, status) ||
         status.GetNestedError()) {
@@ -194,7 +197,7 @@ bool cmMacroFunctionBlocker::ShouldRemove(const cmListFileFunction& lff,
 {
   if (!cmSystemTools::Strucmp(lff.Name.c_str(), "endmacro")) {
     std::vector<std::string> expandedArguments;
-    mf.ExpandArguments(lff.Arguments, expandedArguments,
+    mf.ExpandArguments(lff.GetArguments(), expandedArguments,
                        this->GetStartingContext().FilePath.c_str());
     // if the endmacro has arguments make sure they
     // match the arguments of the macro
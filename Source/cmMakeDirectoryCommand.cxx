@@ -3,6 +3,7 @@
 #include "cmMakeDirectoryCommand.h"
 
 #include "cmMakefile.h"
+#include "cmPathCache.h"
 #include "cmSystemTools.h"
 
 class cmExecutionStatus;
@@ -23,5 +24,6 @@ bool cmMakeDirectoryCommand::InitialPass(std::vector<std::string> const& args,
     return false;
   }
   cmSystemTools::MakeDirectory(args[0].c_str());
+  cmPathCache::InvalidatePath(args[0]);
   return true;
 }
@@ -26,7 +26,10 @@
 #include "cmGeneratorExpressionEvaluationFile.h"
 #include "cmGlobalGenerator.h"
 #include "cmInstallGenerator.h" // IWYU pragma: keep
+#include "cmInstallHashCache.h"
+#include "cmInstallQueue.h"
 #include "cmListFileCache.h"
+#include "cmPathCache.h"
 #include "cmSourceFile.h"
 #include "cmSourceFileLocation.h"
 #include "cmState.h"
@@ -213,8 +216,8 @@ void cmMakefile::PrintCommandTrace(const cmListFileFunction& lff) const
   bool expand = this->GetCMakeInstance()->GetTraceExpand();
   std::string temp;
   for (std::vector<cmListFileArgument>::const_iterator i =
-         lff.Arguments.begin();
-       i != lff.Arguments.end(); ++i) {
+         lff.GetArguments().begin();
+       i != lff.GetArguments().end(); ++i) {
     if (expand) {
       temp = i->Value;
       this->ExpandVariablesInString(temp);
@@ -252,6 +255,11 @@ private:
   cmMakefile* Makefile;
 };
 
+bool cmMakefile::RunInstallQueue()
+{
+  return this->GetCMakeInstance()->GetInstallQueue()->Run(this);
+}
+
 bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
                                 cmExecutionStatus& status)
 {
@@ -287,7 +295,8 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
       }
 
       // Try invoking the command.
-      bool invokeSucceeded = pcmd->InvokeInitialPass(lff.Arguments, status);
+      bool invokeSucceeded =
+        pcmd->InvokeInitialPass(lff.GetArguments(), status);
       bool hadNestedError = status.GetNestedError();
       if (!invokeSucceeded || hadNestedError) {
         if (!hadNestedError) {
@@ -505,6 +514,22 @@ private:
   bool ReportError;
 };
 
+// Drop the files a script that stopped early left queued for
+// installation, and save the hashes of the files it installed.
+static void cmMakefileFinishInstall(cmMakefile* mf)
+{
+  cmInstallQueue* queue = mf->GetCMakeInstance()->GetInstallQueue();
+  if (queue->IsOpen()) {
+    if (!cmSystemTools::GetFatalErrorOccured()) {
+      mf->IssueMessage(cmake::FATAL_ERROR,
+                       "file(INSTALL_QUEUE BEGIN) has no matching "
+                       "file(INSTALL_QUEUE END).");
+    }
+    queue->Discard();
+  }
+  mf->GetCMakeInstance()->GetInstallHashCache()->Save();
+}
+
 bool cmMakefile::ReadListFile(const char* filename)
 {
   std::string filenametoread = cmSystemTools::CollapseFullPath(
@@ -519,6 +544,7 @@ bool cmMakefile::ReadListFile(const char* filename)
   }
 
   this->ReadListFile(listFile, filenametoread);
+  cmMakefileFinishInstall(this);
   if (cmSystemTools::GetFatalErrorOccured()) {
     scope.Quiet();
   }
@@ -1473,13 +1499,16 @@ void cmMakefile::Configure()
     if (!hasProject) {
       cmListFileFunction project;
       project.Name = "PROJECT";
-      cmListFileArgument prj("Project", cmListFileArgument::Unquoted, 0);
-      project.Arguments.push_back(prj);
+      std::vector<cmListFileArgument> prjArgs;
+      prjArgs.push_back(
+        cmListFileArgument("Project", cmListFileArgument::Unquoted, 0));
+      project.SetArguments(prjArgs);
       listFile.Functions.insert(listFile.Functions.begin(), project);
     }
   }
 
   this->ReadListFile(listFile, currentStart);
+  cmMakefileFinishInstall(this);
   if (cmSystemTools::GetFatalErrorOccured()) {
     scope.Quiet();
   }
@@ -1663,6 +1692,26 @@ void cmMakefile::AddDefinition(const std::string& name, const char* value)
 #endif
 }
 
+bool cmMakefile::AppendListDefinition(const std::string& name,
+                                      const std::string& value)
+{
+  if (!this->StateSnapshot.AppendListDefinition(name, value)) {
+    return false;
+  }
+  if (this->VariableInitialized(name)) {
+    this->LogUnused("changing definition", name);
+  }
+
+#ifdef CMAKE_BUILD_WITH_CMAKE
+  cmVariableWatch* vv = this->GetVariableWatch();
+  if (vv) {
+    vv->VariableAccessed(name, cmVariableWatch::VARIABLE_MODIFIED_ACCESS,
+                         this->StateSnapshot.GetDefinition(name), this);
+  }
+#endif
+  return true;
+}
+
 void cmMakefile::AddCacheDefinition(const std::string& name, const char* value,
                                     const char* doc,
                                     cmStateEnums::CacheEntryType type,
@@ -2304,6 +2353,12 @@ const char* cmMakefile::GetDefinition(const std::string& name) const
   return def;
 }
 
+std::vector<std::string> const* cmMakefile::GetDefinitionList(
+  const std::string& name, bool& hasEmpty) const
+{
+  return this->StateSnapshot.GetDefinitionList(name, hasEmpty);
+}
+
 const char* cmMakefile::GetSafeDefinition(const std::string& def) const
 {
   const char* ret = this->GetDefinition(def);
@@ -3111,12 +3166,31 @@ void cmMakefile::SetArgcArgv(const std::vector<std::string>& args)
   }
 }
 
+static std::string cmMakefileSourceFileSearchKey(std::string const& name)
+{
+  // Two locations match only if their names are equal or one of them
+  // is the other plus an extension, so the part before the first dot
+  // is the same for all matching locations.  It also stays the same
+  // when an ambiguous extension is resolved later.
+  std::string key = name.substr(0, name.find('.'));
+#if defined(_WIN32) || defined(__APPLE__)
+  // Names are compared case-insensitively on these platforms.
+  key = cmSystemTools::LowerCase(key);
+#endif
+  return key;
+}
+
 cmSourceFile* cmMakefile::GetSource(const std::string& sourceName) const
 {
   cmSourceFileLocation sfl(this, sourceName);
-  for (std::vector<cmSourceFile*>::const_iterator sfi =
-         this->SourceFiles.begin();
-       sfi != this->SourceFiles.end(); ++sfi) {
+  SourceFileSearchIndexType::const_iterator sfsi =
+    this->SourceFileSearchIndex.find(
+      cmMakefileSourceFileSearchKey(sfl.GetName()));
+  if (sfsi == this->SourceFileSearchIndex.end()) {
+    return CM_NULLPTR;
+  }
+  for (std::vector<cmSourceFile*>::const_iterator sfi = sfsi->second.begin();
+       sfi != sfsi->second.end(); ++sfi) {
     cmSourceFile* sf = *sfi;
     if (sf->Matches(sfl)) {
       return sf;
@@ -3133,6 +3207,9 @@ cmSourceFile* cmMakefile::CreateSource(const std::string& sourceName,
     sf->SetProperty("GENERATED", "1");
   }
   this->SourceFiles.push_back(sf);
+  this->SourceFileSearchIndex[cmMakefileSourceFileSearchKey(
+                                sf->GetLocation().GetName())]
+    .push_back(sf);
   return sf;
 }
 
@@ -3196,6 +3273,7 @@ int cmMakefile::TryCompile(const std::string& srcdir,
   if (!cmSystemTools::FileIsDirectory(bindir)) {
     cmSystemTools::MakeDirectory(bindir.c_str());
   }
+  cmPathCache::InvalidateTree(bindir);
 
   // change to the tests directory and run cmake
   // use the cmake object instead of calling cmake
@@ -3291,6 +3369,7 @@ int cmMakefile::TryCompile(const std::string& srcdir,
   // finally call the generator to actually build the resulting project
   int ret = this->GetGlobalGenerator()->TryCompile(
     srcdir, bindir, projectName, targetName, fast, output, this);
+  cmPathCache::InvalidateTree(bindir);
 
   this->IsSourceFileTryCompile = false;
   return ret;
@@ -3523,6 +3602,7 @@ int cmMakefile::ConfigureFile(const char* infile, const char* outfile,
     std::string path = soutfile.substr(0, pos);
     cmSystemTools::MakeDirectory(path.c_str());
   }
+  cmPathCache::InvalidatePath(soutfile);
 
   if (copyonly) {
     if (!cmSystemTools::CopyFileIfDifferent(sinfile.c_str(),
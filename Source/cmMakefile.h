@@ -232,6 +232,13 @@ public:
    * can be used in CMake to refer to lists, directories, etc.
    */
   void AddDefinition(const std::string& name, const char* value);
+  /**
+   * Append a ;-separated value to a variable set in the current scope,
+   * separated by a ; unless the variable is empty, without copying it.
+   * Return false, changing nothing, if the variable is not set in the
+   * current scope.
+   */
+  bool AppendListDefinition(const std::string& name, const std::string& value);
   ///! Add a definition to this makefile and the global cmake cache.
   void AddCacheDefinition(const std::string& name, const char* value,
                           const char* doc, cmStateEnums::CacheEntryType type,
@@ -421,6 +428,15 @@ public:
   const char* GetSafeDefinition(const std::string&) const;
   const char* GetRequiredDefinition(const std::string& name) const;
   bool IsDefinitionSet(const std::string&) const;
+  /**
+   * Get the elements of a variable's value as a list with empty elements,
+   * and whether any is empty, or null if it is not a normal variable.
+   * They are split once and kept with the variable until it is set
+   * again.  This does not notify variable watches; call GetDefinition
+   * first.
+   */
+  std::vector<std::string> const* GetDefinitionList(const std::string& name,
+                                                    bool& hasEmpty) const;
   /**
    * Get the list of all variables in the current space. If argument
    * cacheonly is specified and is greater than 0, then only cache
@@ -570,6 +586,13 @@ public:
   bool ExecuteCommand(const cmListFileFunction& lff,
                       cmExecutionStatus& status);
 
+  /**
+   * Install the files queued by file(INSTALL) before a command that
+   * reads them.  Returns false if an installation failed, after reporting
+   * the error at the command that queued it.
+   */
+  bool RunInstallQueue();
+
   ///! Enable support for named language, if nil then all languages are
   /// enabled.
   void EnableLanguage(std::vector<std::string> const& languages,
@@ -805,6 +828,12 @@ protected:
   std::map<std::string, std::string> AliasTargets;
   std::vector<cmSourceFile*> SourceFiles;
 
+  // Source files by the part of their name that cmSourceFileLocation
+  // matching cannot change, to avoid a linear search in GetSource.
+  typedef CM_UNORDERED_MAP<std::string, std::vector<cmSourceFile*> >
+    SourceFileSearchIndexType;
+  SourceFileSearchIndexType SourceFileSearchIndex;
+
   // Tests
   std::map<std::string, cmTest*> Tests;
 
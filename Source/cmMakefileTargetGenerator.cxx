@@ -395,6 +395,11 @@ void cmMakefileTargetGenerator::WriteObjectRuleFiles(
   // generate the build rule file
   this->WriteObjectBuildFile(obj, lang, source, depends);
 
+  // The compiler reports the dependencies of the object itself.
+  if (this->UseCompilerDepends(lang)) {
+    return;
+  }
+
   // The object file should be checked for dependency integrity.
   std::string objFullPath = this->LocalGenerator->GetCurrentBinaryDirectory();
   objFullPath += "/";
@@ -471,6 +476,24 @@ void cmMakefileTargetGenerator::WriteObjectBuildFile(
                           << "\n";
   }
 
+  // Have the compiler write the dependencies of the object.
+  if (this->UseCompilerDepends(lang)) {
+    std::string const depfile = obj + ".d";
+    std::string depfileFlags = this->Makefile->GetSafeDefinition(
+      "CMAKE_DEPFILE_FLAGS_" + lang);
+    cmSystemTools::ReplaceString(
+      depfileFlags, "<DEPFILE>",
+      this->LocalGenerator->ConvertToOutputFormat(depfile,
+                                                  cmOutputConverter::SHELL));
+    cmSystemTools::ReplaceString(
+      depfileFlags, "<OBJECT>",
+      this->LocalGenerator->ConvertToOutputFormat(relativeObj,
+                                                  cmOutputConverter::SHELL));
+    this->LocalGenerator->AppendFlags(flags, depfileFlags);
+    this->CompilerDependFiles.push_back(
+      this->LocalGenerator->ConvertToFullPath(depfile));
+  }
+
   // Get the output paths for source and object files.
   std::string sourceFile = this->LocalGenerator->ConvertToOutputFormat(
     source.GetFullPath(), cmOutputConverter::SHELL);
@@ -973,6 +996,55 @@ bool cmMakefileTargetGenerator::WriteMakeRule(
   return symbolic;
 }
 
+bool cmMakefileTargetGenerator::UseCompilerDepends(
+  std::string const& lang) const
+{
+  // The build files include the depfiles before the objects are built,
+  // so the make tool must tolerate missing files.
+  if (!this->GlobalGenerator->GetMakefiles()[0]->IsOn(
+        "CMAKE_DEPENDS_USE_COMPILER") ||
+      this->GlobalGenerator->OptionalIncludeDirective.empty()) {
+    return false;
+  }
+  // The Fortran scanner also tracks module dependencies.
+  if (lang == "Fortran") {
+    return false;
+  }
+  // The build files include the depfiles, so they must use make syntax.
+  std::string const format =
+    this->Makefile->GetSafeDefinition("CMAKE_" + lang + "_DEPFILE_FORMAT");
+  const char* flags =
+    this->Makefile->GetDefinition("CMAKE_DEPFILE_FLAGS_" + lang);
+  return format == "gcc" && flags && *flags;
+}
+
+void cmMakefileTargetGenerator::WriteCompilerDependsIncludes()
+{
+  if (this->CompilerDependFiles.empty()) {
+    return;
+  }
+
+  const char* root = (this->Makefile->IsOn("CMAKE_MAKE_INCLUDE_FROM_ROOT")
+                        ? "$(CMAKE_BINARY_DIR)/"
+                        : "");
+
+  *this->BuildFileStream
+    << "# Include the dependencies written by the compiler, if any.\n";
+  for (std::vector<std::string>::const_iterator i =
+         this->CompilerDependFiles.begin();
+       i != this->CompilerDependFiles.end(); ++i) {
+    *this->BuildFileStream
+      << this->GlobalGenerator->OptionalIncludeDirective << " " << root
+      << cmSystemTools::ConvertToOutputPath(
+           this->LocalGenerator
+             ->MaybeConvertToRelativePath(
+               this->LocalGenerator->GetBinaryDirectory(), *i)
+             .c_str())
+      << "\n";
+  }
+  *this->BuildFileStream << "\n";
+}
+
 void cmMakefileTargetGenerator::WriteTargetDependRules()
 {
   // must write the targets depend info file
@@ -1046,6 +1118,34 @@ void cmMakefileTargetGenerator::WriteTargetDependRules()
     this->LocalGenerator->GetRelativeTargetDirectory(this->GeneratorTarget);
   depTarget += "/depend";
 
+  this->WriteCompilerDependsIncludes();
+
+  // Without anything left for the scanner to do, skip running CMake
+  // and drop dependencies it may have written before.
+  if (this->GlobalGenerator->GetMakefiles()[0]->IsOn(
+        "CMAKE_DEPENDS_USE_COMPILER") &&
+      this->LocalGenerator->GetImplicitDepends(this->GeneratorTarget)
+        .empty() &&
+      this->MultipleOutputPairs.empty()) {
+    std::string dependFileNameFull = this->TargetBuildDirectoryFull;
+    dependFileNameFull += "/depend.make";
+    cmGeneratedFileStream depFileStream(
+      dependFileNameFull.c_str(), false,
+      this->GlobalGenerator->GetMakefileEncoding());
+    depFileStream.SetCopyIfDifferent(true);
+    depFileStream << "# Empty dependencies file for "
+                  << this->GeneratorTarget->GetName() << ".\n"
+                  << "# This may be replaced when dependencies are built."
+                  << std::endl;
+
+    if (this->CustomCommandDriver == OnDepends) {
+      this->DriveCustomCommands(depends);
+    }
+    this->LocalGenerator->WriteMakeRule(*this->BuildFileStream, CM_NULLPTR,
+                                        depTarget, depends, commands, true);
+    return;
+  }
+
   // Add a command to call CMake to scan dependencies.  CMake will
   // touch the corresponding depends file after scanning dependencies.
   std::ostringstream depCmd;
@@ -101,6 +101,13 @@ protected:
   void WriteObjectDependRules(cmSourceFile const& source,
                               std::vector<std::string>& depends);
 
+  // whether objects of the given language get their dependencies from
+  // depfiles written by the compiler instead of the dependency scanner
+  bool UseCompilerDepends(std::string const& lang) const;
+
+  // write the include directives for the compiler generated depfiles
+  void WriteCompilerDependsIncludes();
+
   // write the build rule for a custom command
   void GenerateCustomRuleFile(cmCustomCommandGenerator const& ccg);
 
@@ -214,6 +221,9 @@ protected:
   // files to clean
   std::vector<std::string> CleanFiles;
 
+  // depfiles written by the compiler for objects of this target
+  std::vector<std::string> CompilerDependFiles;
+
   // objects used by this target
   std::vector<std::string> Objects;
   std::vector<std::string> ExternalObjects;
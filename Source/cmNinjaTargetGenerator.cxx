@@ -128,6 +128,15 @@ std::string cmNinjaTargetGenerator::ComputeFlagsForObject(
   cmSourceFile const* source, const std::string& language)
 {
   std::string flags = this->GetFlags(language);
+  this->LocalGenerator->AppendFlags(
+    flags, this->ComputeSourceFlags(source, language));
+  return flags;
+}
+
+std::string cmNinjaTargetGenerator::ComputeSourceFlags(
+  cmSourceFile const* source, const std::string& language)
+{
+  std::string flags;
 
   // Add Fortran format flags.
   if (language == "Fortran") {
@@ -176,6 +185,15 @@ bool cmNinjaTargetGenerator::NeedDepTypeMSVC(const std::string& lang) const
 // void cmMakefileTargetGenerator::WriteTargetLanguageFlags().
 std::string cmNinjaTargetGenerator::ComputeDefines(cmSourceFile const* source,
                                                    const std::string& language)
+{
+  std::string definesString = this->GetDefines(language);
+  this->LocalGenerator->AppendFlags(
+    definesString, this->ComputeSourceDefines(source, language));
+  return definesString;
+}
+
+std::string cmNinjaTargetGenerator::ComputeSourceDefines(
+  cmSourceFile const* source, const std::string& language)
 {
   std::set<std::string> defines;
   this->LocalGenerator->AppendDefines(
@@ -187,12 +205,21 @@ std::string cmNinjaTargetGenerator::ComputeDefines(cmSourceFile const* source,
                                         source->GetProperty(defPropName));
   }
 
-  std::string definesString = this->GetDefines(language);
+  std::string definesString;
   this->LocalGenerator->JoinDefines(defines, definesString, language);
 
   return definesString;
 }
 
+bool cmNinjaTargetGenerator::HoistTargetCompileVariables(
+  std::string const& lang) const
+{
+  // The explicit preprocessing rules share their variables with the
+  // compilation rule and prepend per-source include directories, so
+  // keep them fully bound on each build statement.
+  return !this->NeedExplicitPreprocessing(lang);
+}
+
 cmNinjaDeps cmNinjaTargetGenerator::ComputeLinkDeps() const
 {
   // Static libraries never depend on other targets for linking.
@@ -392,8 +419,6 @@ void cmNinjaTargetGenerator::WriteCompileRule(const std::string& lang)
   vars.Language = lang.c_str();
   vars.Source = "$in";
   vars.Object = "$out";
-  vars.Defines = "$DEFINES";
-  vars.Includes = "$INCLUDES";
   vars.TargetPDB = "$TARGET_PDB";
   vars.TargetCompilePDB = "$TARGET_COMPILE_PDB";
   vars.ObjectDir = "$OBJECT_DIR";
@@ -406,15 +431,34 @@ void cmNinjaTargetGenerator::WriteCompileRule(const std::string& lang)
   cmMakefile* mf = this->GetMakefile();
 
   std::string flags = "$FLAGS";
+  std::string defines = "$DEFINES";
+  std::string includes = "$INCLUDES";
   std::string rspfile;
   std::string rspcontent;
   std::string responseFlag;
 
+  // Spell out the flags, definitions and include directories shared by
+  // all sources of the target in the rule so that the build statements
+  // need to bind only their per-source additions.
+  if (this->HoistTargetCompileVariables(lang)) {
+    std::string const& targetFlags = this->GetFlags(lang);
+    if (!targetFlags.empty()) {
+      flags = targetFlags + " " + flags;
+    }
+    std::string const& targetDefines = this->GetDefines(lang);
+    if (!targetDefines.empty()) {
+      defines = targetDefines + " " + defines;
+    }
+    includes = this->GetIncludes(lang);
+  }
+  vars.Defines = defines.c_str();
+  vars.Includes = includes.c_str();
+
   bool const lang_supports_response = !(lang == "RC" || lang == "CUDA");
   if (lang_supports_response && this->ForceResponseFile()) {
     rspfile = "$RSP_FILE";
     responseFlag = "@" + rspfile;
-    rspcontent = " $DEFINES $INCLUDES $FLAGS";
+    rspcontent = " " + defines + " " + includes + " " + flags;
     flags = responseFlag;
     vars.Defines = "";
     vars.Includes = "";
@@ -812,19 +856,33 @@ void cmNinjaTargetGenerator::WriteObjectBuildStatement(
   std::string const objectFileDir =
     cmSystemTools::GetFilenamePath(objectFileName);
 
+  std::string const sourceFlags = this->ComputeSourceFlags(source, language);
+  std::string const sourceDefines =
+    this->ComputeSourceDefines(source, language);
+  std::string flags = this->GetFlags(language);
+  this->LocalGenerator->AppendFlags(flags, sourceFlags);
+  std::string defines = this->GetDefines(language);
+  this->LocalGenerator->AppendFlags(defines, sourceDefines);
+
+  this->ExportObjectCompileCommand(language, sourceFileName, objectDir,
+                                   objectFileName, objectFileDir, flags,
+                                   defines, this->GetIncludes(language));
+
   cmNinjaVars vars;
-  vars["FLAGS"] = this->ComputeFlagsForObject(source, language);
-  vars["DEFINES"] = this->ComputeDefines(source, language);
-  vars["INCLUDES"] = this->GetIncludes(language);
+  if (this->HoistTargetCompileVariables(language)) {
+    // The compile rule already has the target-wide values.
+    vars["FLAGS"] = sourceFlags;
+    vars["DEFINES"] = sourceDefines;
+  } else {
+    vars["FLAGS"] = flags;
+    vars["DEFINES"] = defines;
+    vars["INCLUDES"] = this->GetIncludes(language);
+  }
   if (!this->NeedDepTypeMSVC(language)) {
     vars["DEP_FILE"] = this->GetLocalGenerator()->ConvertToOutputFormat(
       objectFileName + ".d", cmOutputConverter::SHELL);
   }
 
-  this->ExportObjectCompileCommand(
-    language, sourceFileName, objectDir, objectFileName, objectFileDir,
-    vars["FLAGS"], vars["DEFINES"], vars["INCLUDES"]);
-
   std::string comment;
   std::string rule = this->LanguageCompilerRule(language);
 
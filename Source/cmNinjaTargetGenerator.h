@@ -83,6 +83,21 @@ protected:
   std::string ComputeDefines(cmSourceFile const* source,
                              const std::string& language);
 
+  /// @return the flags added on top of the target flags by @a source.
+  std::string ComputeSourceFlags(cmSourceFile const* source,
+                                 const std::string& language);
+
+  /// @return the definitions added on top of the target ones by @a source.
+  std::string ComputeSourceDefines(cmSourceFile const* source,
+                                   const std::string& language);
+
+  /**
+   * Whether the compile rule for @a lang spells out the target-wide
+   * flags, definitions and include directories so that object build
+   * statements bind only their per-source additions.
+   */
+  bool HoistTargetCompileVariables(std::string const& lang) const;
+
   std::string ConvertToNinjaPath(const std::string& path) const
   {
     return this->GetGlobalGenerator()->ConvertToNinjaPath(path);
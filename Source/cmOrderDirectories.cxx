@@ -5,6 +5,7 @@
 #include "cmAlgorithms.h"
 #include "cmGeneratorTarget.h"
 #include "cmGlobalGenerator.h"
+#include "cmPathCache.h"
 #include "cmSystemTools.h"
 #include "cmake.h"
 
@@ -58,8 +59,12 @@ public:
 
   void FindConflicts(unsigned int index)
   {
-    for (unsigned int i = 0; i < this->OD->OriginalDirectories.size(); ++i) {
+    std::vector<unsigned int> candidates;
+    this->FindCandidateDirectories(candidates);
+    for (std::vector<unsigned int>::const_iterator ci = candidates.begin();
+         ci != candidates.end(); ++ci) {
       // Check if this directory conflicts with the entry.
+      unsigned int i = *ci;
       std::string const& dir = this->OD->OriginalDirectories[i];
       if (!this->OD->IsSameDirectory(dir, this->Directory) &&
           this->FindConflict(dir)) {
@@ -75,12 +80,15 @@ public:
   void FindImplicitConflicts(std::ostringstream& w)
   {
     bool first = true;
-    for (unsigned int i = 0; i < this->OD->OriginalDirectories.size(); ++i) {
+    std::vector<unsigned int> candidates;
+    this->FindCandidateDirectories(candidates);
+    for (std::vector<unsigned int>::const_iterator ci = candidates.begin();
+         ci != candidates.end(); ++ci) {
       // Check if this directory conflicts with the entry.
-      std::string const& dir = this->OD->OriginalDirectories[i];
+      std::string const& dir = this->OD->OriginalDirectories[*ci];
       if (dir != this->Directory &&
-          cmSystemTools::GetRealPath(dir) !=
-            cmSystemTools::GetRealPath(this->Directory) &&
+          cmPathCache::GetRealPath(dir) !=
+            cmPathCache::GetRealPath(this->Directory) &&
           this->FindConflict(dir)) {
         // The library will be found in this directory but it is
         // supposed to be found in an implicit search directory.
@@ -98,6 +106,10 @@ public:
 protected:
   virtual bool FindConflict(std::string const& dir) = 0;
 
+  // Add the directories whose content may hold a conflicting file.
+  virtual void AddCandidateDirectories(std::vector<unsigned int>& dirs) = 0;
+  void FindCandidateDirectories(std::vector<unsigned int>& dirs);
+
   bool FileMayConflict(std::string const& dir, std::string const& name);
 
   cmOrderDirectories* OD;
@@ -132,6 +144,18 @@ bool cmOrderDirectoriesConstraint::FileMayConflict(std::string const& dir,
   return fi != files.end();
 }
 
+void cmOrderDirectoriesConstraint::FindCandidateDirectories(
+  std::vector<unsigned int>& dirs)
+{
+  // Directories whose content is not known may hold any file.
+  dirs = this->OD->UnindexedDirectories;
+  this->AddCandidateDirectories(dirs);
+
+  // Check the candidates in the original directory order.
+  std::sort(dirs.begin(), dirs.end());
+  dirs.erase(std::unique(dirs.begin(), dirs.end()), dirs.end());
+}
+
 class cmOrderDirectoriesConstraintSOName : public cmOrderDirectoriesConstraint
 {
 public:
@@ -163,6 +187,15 @@ public:
 
   bool FindConflict(std::string const& dir) CM_OVERRIDE;
 
+  void AddCandidateDirectories(std::vector<unsigned int>& dirs) CM_OVERRIDE
+  {
+    if (!this->SOName.empty()) {
+      this->OD->FindDirectoriesWithFile(this->SOName, dirs);
+    } else {
+      this->OD->FindDirectoriesWithPrefix(this->FileName, dirs);
+    }
+  }
+
 private:
   // The soname of the shared library if it is known.
   std::string SOName;
@@ -211,6 +244,8 @@ public:
   }
 
   bool FindConflict(std::string const& dir) CM_OVERRIDE;
+
+  void AddCandidateDirectories(std::vector<unsigned int>& dirs) CM_OVERRIDE;
 };
 
 bool cmOrderDirectoriesConstraintLibrary::FindConflict(std::string const& dir)
@@ -241,6 +276,26 @@ bool cmOrderDirectoriesConstraintLibrary::FindConflict(std::string const& dir)
   return false;
 }
 
+void cmOrderDirectoriesConstraintLibrary::AddCandidateDirectories(
+  std::vector<unsigned int>& dirs)
+{
+  this->OD->FindDirectoriesWithFile(this->FileName, dirs);
+
+  // Look for the same names as FindConflict.
+  if (!this->OD->LinkExtensions.empty() &&
+      this->OD->RemoveLibraryExtension.find(this->FileName)) {
+    std::string lib = this->OD->RemoveLibraryExtension.match(1);
+    std::string ext = this->OD->RemoveLibraryExtension.match(2);
+    for (std::vector<std::string>::iterator i =
+           this->OD->LinkExtensions.begin();
+         i != this->OD->LinkExtensions.end(); ++i) {
+      if (*i != ext) {
+        this->OD->FindDirectoriesWithFile(lib + *i, dirs);
+      }
+    }
+  }
+}
+
 cmOrderDirectories::cmOrderDirectories(cmGlobalGenerator* gg,
                                        const cmGeneratorTarget* target,
                                        const char* purpose)
@@ -436,6 +491,9 @@ void cmOrderDirectories::FindConflicts()
   this->ConflictGraph.resize(this->OriginalDirectories.size());
   this->DirectoryVisited.resize(this->OriginalDirectories.size(), 0);
 
+  // Look up the content of each directory only once.
+  this->IndexDirectoryContent();
+
   // Find directories conflicting with each entry.
   for (unsigned int i = 0; i < this->ConstraintEntries.size(); ++i) {
     this->ConstraintEntries[i]->FindConflicts(i);
@@ -458,6 +516,74 @@ void cmOrderDirectories::FindConflicts()
   this->FindImplicitConflicts();
 }
 
+static std::string cmOrderDirectoriesFileKey(std::string const& name)
+{
+#if defined(_WIN32) || defined(__APPLE__)
+  // The file system may not be case sensitive.
+  return cmSystemTools::LowerCase(name);
+#else
+  return name;
+#endif
+}
+
+void cmOrderDirectories::IndexDirectoryContent()
+{
+  // Record the directories in which each file name appears.  Entries
+  // then check for conflicts only in directories that hold one of
+  // their candidate names instead of in every directory.
+  for (unsigned int i = 0; i < this->OriginalDirectories.size(); ++i) {
+    std::string const& dir = this->OriginalDirectories[i];
+    std::set<std::string> const& files =
+      this->GlobalGenerator->GetDirectoryContent(dir, true);
+    if (files.empty()) {
+      // The directory may exist without being readable.
+      if (cmSystemTools::FileIsDirectory(dir)) {
+        this->UnindexedDirectories.push_back(i);
+      }
+      continue;
+    }
+    for (std::set<std::string>::const_iterator fi = files.begin();
+         fi != files.end(); ++fi) {
+      this->DirectoryContentIndex[cmOrderDirectoriesFileKey(*fi)].push_back(
+        i);
+    }
+  }
+}
+
+void cmOrderDirectories::FindDirectoriesWithFile(
+  std::string const& name, std::vector<unsigned int>& dirs) const
+{
+  DirectoryContentIndexType::const_iterator i =
+    this->DirectoryContentIndex.find(cmOrderDirectoriesFileKey(name));
+  if (i != this->DirectoryContentIndex.end()) {
+    dirs.insert(dirs.end(), i->second.begin(), i->second.end());
+  }
+}
+
+void cmOrderDirectories::FindDirectoriesWithPrefix(
+  std::string const& prefix, std::vector<unsigned int>& dirs) const
+{
+  if (prefix.empty()) {
+    return;
+  }
+
+  // Cover the same range of names as
+  // cmOrderDirectoriesConstraintSOName::FindConflict.
+  std::string first = cmOrderDirectoriesFileKey(prefix);
+  std::string last = first;
+  ++last[last.size() - 1];
+  DirectoryContentIndexType::const_iterator i =
+    this->DirectoryContentIndex.lower_bound(first);
+  DirectoryContentIndexType::const_iterator e =
+    this->DirectoryContentIndex.lower_bound(last);
+  for (; i != e; ++i) {
+    dirs.insert(dirs.end(), i->second.begin(), i->second.end());
+  }
+  std::string end = prefix;
+  ++end[end.size() - 1];
+  this->FindDirectoriesWithFile(end, dirs);
+}
+
 void cmOrderDirectories::FindImplicitConflicts()
 {
   // Check for items in implicit link directories that have conflicts
@@ -568,7 +694,7 @@ std::string const& cmOrderDirectories::GetRealPath(std::string const& dir)
       this->RealPaths.key_comp()(dir, i->first)) {
     typedef std::map<std::string, std::string>::value_type value_type;
     i = this->RealPaths.insert(
-      i, value_type(dir, cmSystemTools::GetRealPath(dir)));
+      i, value_type(dir, cmPathCache::GetRealPath(dir)));
   }
   return i->second;
 }
@@ -55,10 +55,21 @@ private:
   std::vector<std::string> OriginalDirectories;
   std::map<std::string, int> DirectoryIndex;
   std::vector<int> DirectoryVisited;
+
+  // Map from file name to the directories containing it.
+  typedef std::map<std::string, std::vector<unsigned int> >
+    DirectoryContentIndexType;
+  DirectoryContentIndexType DirectoryContentIndex;
+  std::vector<unsigned int> UnindexedDirectories;
   void CollectOriginalDirectories();
   int AddOriginalDirectory(std::string const& dir);
   void AddOriginalDirectories(std::vector<std::string> const& dirs);
   void FindConflicts();
+  void IndexDirectoryContent();
+  void FindDirectoriesWithFile(std::string const& name,
+                               std::vector<unsigned int>& dirs) const;
+  void FindDirectoriesWithPrefix(std::string const& prefix,
+                                 std::vector<unsigned int>& dirs) const;
   void FindImplicitConflicts();
   void OrderDirectories();
   void VisitDirectory(unsigned int i);
@@ -89,6 +100,7 @@ private:
 
   friend class cmOrderDirectoriesConstraint;
   friend class cmOrderDirectoriesConstraintLibrary;
+  friend class cmOrderDirectoriesConstraintSOName;
 };
 
 #endif
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "cmAlgorithms.h"
+#include "cmPathCache.h"
 #include "cmState.h"
 #include "cmStateDirectory.h"
 #include "cmSystemTools.h"
@@ -103,32 +104,9 @@ bool cmOutputConverter::ContainedInDirectory(std::string const& local_path,
   return bothInSource || bothInBinary;
 }
 
-std::string cmOutputConverter::ConvertToRelativePath(
-  std::string const& local_path, std::string const& remote_path) const
-{
-  if (!ContainedInDirectory(local_path, remote_path,
-                            this->StateSnapshot.GetDirectory())) {
-    return remote_path;
-  }
-
-  return this->ForceToRelativePath(local_path, remote_path);
-}
-
-std::string cmOutputConverter::ForceToRelativePath(
+static std::string cmOutputConverterRelativePath(
   std::string const& local_path, std::string const& remote_path)
 {
-  // The paths should never be quoted.
-  assert(local_path[0] != '\"');
-  assert(remote_path[0] != '\"');
-
-  // The local path should never have a trailing slash.
-  assert(local_path.empty() || local_path[local_path.size() - 1] != '/');
-
-  // If the path is already relative then just return the path.
-  if (!cmSystemTools::FileIsFullPath(remote_path.c_str())) {
-    return remote_path;
-  }
-
   // Identify the longest shared path component between the remote
   // path and the local path.
   std::vector<std::string> local;
@@ -188,6 +166,41 @@ std::string cmOutputConverter::ForceToRelativePath(
   return relative;
 }
 
+std::string cmOutputConverter::ConvertToRelativePath(
+  std::string const& local_path, std::string const& remote_path) const
+{
+  if (!ContainedInDirectory(local_path, remote_path,
+                            this->StateSnapshot.GetDirectory())) {
+    return remote_path;
+  }
+
+  return this->ForceToRelativePath(local_path, remote_path);
+}
+
+std::string cmOutputConverter::ForceToRelativePath(
+  std::string const& local_path, std::string const& remote_path)
+{
+  // The paths should never be quoted.
+  assert(local_path[0] != '\"');
+  assert(remote_path[0] != '\"');
+
+  // The local path should never have a trailing slash.
+  assert(local_path.empty() || local_path[local_path.size() - 1] != '/');
+
+  // If the path is already relative then just return the path.
+  if (!cmSystemTools::FileIsFullPath(remote_path.c_str())) {
+    return remote_path;
+  }
+
+  // Generators convert the same paths for many targets and rules.
+  std::string relative;
+  if (!cmPathCache::FindRelativePath(local_path, remote_path, relative)) {
+    relative = cmOutputConverterRelativePath(local_path, remote_path);
+    cmPathCache::StoreRelativePath(local_path, remote_path, relative);
+  }
+  return relative;
+}
+
 static bool cmOutputConverterIsShellOperator(const std::string& str)
 {
   static std::set<std::string> shellOperators;
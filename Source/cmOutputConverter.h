@@ -33,6 +33,7 @@ public:
                                          OutputFormat format = SHELL) const;
 
   void SetLinkScriptShell(bool linkScriptShell);
+  bool GetLinkScriptShell() const { return this->LinkScriptShell; }
 
   /**
    * Flags to pass to Shell_GetArgument.  These modify the generated
@@ -0,0 +1,353 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmPathCache.h"
+
+#include "cmSystemTools.h"
+#include "cm_sys_stat.h"
+#include "cm_unordered_map.hxx"
+
+#ifdef CMAKE_USE_LIBUV
+#include "cm_uv.h"
+#endif
+
+#if defined(_WIN32)
+#include "cmsys/Directory.hxx"
+#else
+#include <dirent.h>
+#endif
+
+namespace {
+
+struct cmPathCacheListing
+{
+  cmPathCacheListing()
+    : Loaded(false)
+  {
+  }
+  bool Loaded;
+  std::vector<cmPathCache::DirectoryEntry> Entries;
+};
+
+struct cmPathCacheData
+{
+  cmPathCacheData()
+  {
+#ifdef CMAKE_USE_LIBUV
+    uv_mutex_init(&this->Mutex);
+#endif
+  }
+
+  typedef CM_UNORDERED_MAP<std::string, std::string> StringMap;
+  typedef CM_UNORDERED_MAP<std::string, bool> BoolMap;
+  typedef CM_UNORDERED_MAP<std::string, cmPathCacheListing> ListingMap;
+
+  StringMap Collapsed;
+  StringMap Relative;
+  BoolMap Exists;
+  StringMap RealPaths;
+  ListingMap Listings;
+
+#ifdef CMAKE_USE_LIBUV
+  uv_mutex_t Mutex;
+#endif
+};
+
+cmPathCacheData& cmPathCacheGetData()
+{
+  static cmPathCacheData data;
+  return data;
+}
+
+class cmPathCacheLock
+{
+  CM_DISABLE_COPY(cmPathCacheLock)
+
+public:
+  cmPathCacheLock(cmPathCacheData& data)
+    : Data(data)
+  {
+#ifdef CMAKE_USE_LIBUV
+    uv_mutex_lock(&this->Data.Mutex);
+#endif
+  }
+  ~cmPathCacheLock()
+  {
+#ifdef CMAKE_USE_LIBUV
+    uv_mutex_unlock(&this->Data.Mutex);
+#endif
+  }
+
+private:
+  cmPathCacheData& Data;
+};
+
+std::string cmPathCacheKey(std::string const& a, std::string const& b)
+{
+  // Paths never contain a null character.
+  std::string key;
+  key.reserve(a.size() + b.size() + 1);
+  key += a;
+  key += '\0';
+  key += b;
+  return key;
+}
+
+template <typename Map>
+bool cmPathCacheFind(cmPathCacheData& data, Map const& map,
+                     std::string const& key, typename Map::mapped_type& value)
+{
+  cmPathCacheLock lock(data);
+  typename Map::const_iterator i = map.find(key);
+  if (i == map.end()) {
+    return false;
+  }
+  value = i->second;
+  return true;
+}
+
+template <typename Map>
+void cmPathCacheStore(cmPathCacheData& data, Map& map, std::string const& key,
+                      typename Map::mapped_type const& value)
+{
+  cmPathCacheLock lock(data);
+  map[key] = value;
+}
+
+void cmPathCacheEraseWithParents(cmPathCacheData& data,
+                                 std::string const& path)
+{
+  std::string p = path;
+  while (!p.empty()) {
+    data.Exists.erase(p);
+    data.RealPaths.erase(p);
+    data.Listings.erase(p);
+    std::string const parent = cmSystemTools::GetFilenamePath(p);
+    if (parent == p) {
+      break;
+    }
+    p = parent;
+  }
+}
+
+template <typename Map>
+void cmPathCacheEraseChildren(Map& map, std::string const& prefix)
+{
+  typename Map::iterator i = map.begin();
+  while (i != map.end()) {
+    if (i->first.compare(0, prefix.size(), prefix) == 0) {
+      map.erase(i++);
+    } else {
+      ++i;
+    }
+  }
+}
+
+// Only collapsed full paths are cached.  Relative paths depend on the
+// working directory, and other forms of a path would not be found when
+// it is invalidated.
+bool cmPathCacheIsKey(std::string const& path)
+{
+  return cmSystemTools::FileIsFullPath(path.c_str()) &&
+    cmPathCache::CollapseFullPath(path) == path;
+}
+
+cmPathCache::EntryType cmPathCacheEntryType(std::string const& path)
+{
+#if defined(_WIN32)
+  if (cmSystemTools::FileIsSymlink(path)) {
+    return cmPathCache::EntrySymlink;
+  }
+  if (cmSystemTools::FileIsDirectory(path)) {
+    return cmPathCache::EntryDirectory;
+  }
+#else
+  struct stat st;
+  if (lstat(path.c_str(), &st) == 0) {
+    if (S_ISLNK(st.st_mode)) {
+      return cmPathCache::EntrySymlink;
+    }
+    if (S_ISDIR(st.st_mode)) {
+      return cmPathCache::EntryDirectory;
+    }
+  }
+#endif
+  return cmPathCache::EntryFile;
+}
+
+void cmPathCacheReadDirectory(std::string const& dir,
+                              cmPathCacheListing& listing)
+{
+  cmPathCache::DirectoryEntry entry;
+#if defined(_WIN32)
+  cmsys::Directory d;
+  if (!d.Load(dir)) {
+    return;
+  }
+  listing.Loaded = true;
+  for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
+    entry.Name = d.GetFile(i);
+    if (entry.Name == "." || entry.Name == "..") {
+      continue;
+    }
+    entry.Type = cmPathCacheEntryType(dir + "/" + entry.Name);
+    listing.Entries.push_back(entry);
+  }
+#else
+  DIR* d = opendir(dir.c_str());
+  if (!d) {
+    return;
+  }
+  listing.Loaded = true;
+  while (struct dirent* e = readdir(d)) {
+    entry.Name = e->d_name;
+    if (entry.Name == "." || entry.Name == "..") {
+      continue;
+    }
+#if defined(DT_UNKNOWN)
+    // The entry type comes with the directory read on most file systems.
+    switch (e->d_type) {
+      case DT_DIR:
+        entry.Type = cmPathCache::EntryDirectory;
+        break;
+      case DT_LNK:
+        entry.Type = cmPathCache::EntrySymlink;
+        break;
+      case DT_UNKNOWN:
+        entry.Type = cmPathCacheEntryType(dir + "/" + entry.Name);
+        break;
+      default:
+        entry.Type = cmPathCache::EntryFile;
+        break;
+    }
+#else
+    entry.Type = cmPathCacheEntryType(dir + "/" + entry.Name);
+#endif
+    listing.Entries.push_back(entry);
+  }
+  closedir(d);
+#endif
+}
+}
+
+std::string cmPathCache::CollapseFullPath(std::string const& path)
+{
+  if (!cmSystemTools::FileIsFullPath(path.c_str())) {
+    return cmSystemTools::CollapseFullPath(path);
+  }
+  cmPathCacheData& data = cmPathCacheGetData();
+  std::string result;
+  if (!cmPathCacheFind(data, data.Collapsed, path, result)) {
+    result = cmSystemTools::CollapseFullPath(path);
+    cmPathCacheStore(data, data.Collapsed, path, result);
+  }
+  return result;
+}
+
+std::string cmPathCache::CollapseFullPath(std::string const& path,
+                                          std::string const& base)
+{
+  if (cmSystemTools::FileIsFullPath(path.c_str())) {
+    return cmPathCache::CollapseFullPath(path);
+  }
+  cmPathCacheData& data = cmPathCacheGetData();
+  std::string const key = cmPathCacheKey(base, path);
+  std::string result;
+  if (!cmPathCacheFind(data, data.Collapsed, key, result)) {
+    result = cmSystemTools::CollapseFullPath(path, base);
+    cmPathCacheStore(data, data.Collapsed, key, result);
+  }
+  return result;
+}
+
+bool cmPathCache::FileExists(std::string const& path)
+{
+  if (!cmPathCacheIsKey(path)) {
+    return cmSystemTools::FileExists(path);
+  }
+  cmPathCacheData& data = cmPathCacheGetData();
+  bool result;
+  if (!cmPathCacheFind(data, data.Exists, path, result)) {
+    result = cmSystemTools::FileExists(path);
+    cmPathCacheStore(data, data.Exists, path, result);
+  }
+  return result;
+}
+
+std::string cmPathCache::GetRealPath(std::string const& path)
+{
+  if (!cmPathCacheIsKey(path)) {
+    return cmSystemTools::GetRealPath(path);
+  }
+  cmPathCacheData& data = cmPathCacheGetData();
+  std::string result;
+  if (!cmPathCacheFind(data, data.RealPaths, path, result)) {
+    result = cmSystemTools::GetRealPath(path);
+    cmPathCacheStore(data, data.RealPaths, path, result);
+  }
+  return result;
+}
+
+bool cmPathCache::ListDirectory(std::string const& dir,
+                                std::vector<DirectoryEntry>& entries)
+{
+  cmPathCacheData& data = cmPathCacheGetData();
+  cmPathCacheListing listing;
+  if (!cmPathCacheFind(data, data.Listings, dir, listing)) {
+    cmPathCacheReadDirectory(dir, listing);
+    cmPathCacheStore(data, data.Listings, dir, listing);
+  }
+  entries.swap(listing.Entries);
+  return listing.Loaded;
+}
+
+bool cmPathCache::FindRelativePath(std::string const& local,
+                                   std::string const& remote,
+                                   std::string& relative)
+{
+  cmPathCacheData& data = cmPathCacheGetData();
+  return cmPathCacheFind(data, data.Relative,
+                         cmPathCacheKey(local, remote), relative);
+}
+
+void cmPathCache::StoreRelativePath(std::string const& local,
+                                    std::string const& remote,
+                                    std::string const& relative)
+{
+  cmPathCacheData& data = cmPathCacheGetData();
+  cmPathCacheStore(data, data.Relative, cmPathCacheKey(local, remote),
+                   relative);
+}
+
+void cmPathCache::InvalidatePath(std::string const& path)
+{
+  // Entries are keyed by collapsed full paths.
+  std::string const key = cmSystemTools::CollapseFullPath(path);
+  cmPathCacheData& data = cmPathCacheGetData();
+  cmPathCacheLock lock(data);
+  cmPathCacheEraseWithParents(data, key);
+}
+
+void cmPathCache::InvalidateTree(std::string const& p)
+{
+  std::string const path = cmSystemTools::CollapseFullPath(p);
+  cmPathCacheData& data = cmPathCacheGetData();
+  cmPathCacheLock lock(data);
+  cmPathCacheEraseWithParents(data, path);
+  std::string const prefix = path + "/";
+  cmPathCacheEraseChildren(data.Exists, prefix);
+  cmPathCacheEraseChildren(data.RealPaths, prefix);
+  cmPathCacheEraseChildren(data.Listings, prefix);
+}
+
+void cmPathCache::InvalidateFileSystem()
+{
+  cmPathCacheData& data = cmPathCacheGetData();
+  cmPathCacheLock lock(data);
+  data.Exists.clear();
+  data.RealPaths.clear();
+  data.Listings.clear();
+#ifdef _WIN32
+  // Collapsing a path also looks up the actual case of its components.
+  data.Collapsed.clear();
+#endif
+}
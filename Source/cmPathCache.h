@@ -0,0 +1,85 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmPathCache_h
+#define cmPathCache_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <vector>
+
+/** \class cmPathCache
+ * \brief Process-wide cache of path queries made during configure and
+ * generate.
+ *
+ * Results of pure string operations (collapsing and relative paths) are
+ * kept for the lifetime of the process.  Results that depend on the file
+ * system (existence, real paths and directory listings) are kept until
+ * they are invalidated.
+ * Commands that create, modify or remove files while configuring must
+ * call InvalidatePath() or InvalidateTree() with the affected paths, and
+ * InvalidateFileSystem() when the affected paths are not known.
+ *
+ * All methods may be called concurrently.
+ */
+class cmPathCache
+{
+public:
+  /** Cached cmSystemTools::CollapseFullPath.  Relative paths without a
+      base depend on the working directory and are not cached.  */
+  static std::string CollapseFullPath(std::string const& path);
+  static std::string CollapseFullPath(std::string const& path,
+                                      std::string const& base);
+
+  /** Cached cmSystemTools::FileExists.  Only collapsed full paths are
+      cached.  */
+  static bool FileExists(std::string const& path);
+
+  /** Cached cmSystemTools::GetRealPath.  Only collapsed full paths are
+      cached.  */
+  static std::string GetRealPath(std::string const& path);
+
+  /** Type of a directory entry.  Symbolic links are not followed.  */
+  enum EntryType
+  {
+    EntryFile,
+    EntryDirectory,
+    EntrySymlink
+  };
+
+  struct DirectoryEntry
+  {
+    std::string Name;
+    EntryType Type;
+  };
+
+  /** List the entries of a directory other than "." and "..".  Their
+      types come from the listing itself where the platform provides
+      them, so most entries need no stat.  Return false if the directory
+      cannot be read.  */
+  static bool ListDirectory(std::string const& dir,
+                            std::vector<DirectoryEntry>& entries);
+
+  /** Look up the relative path from directory local to path remote
+      stored by a previous call to StoreRelativePath().  */
+  static bool FindRelativePath(std::string const& local,
+                               std::string const& remote,
+                               std::string& relative);
+  static void StoreRelativePath(std::string const& local,
+                                std::string const& remote,
+                                std::string const& relative);
+
+  /** Forget file system state of a path that has been created or
+      modified, and of its parent directories.  Relative paths are taken
+      from the working directory.  */
+  static void InvalidatePath(std::string const& path);
+
+  /** Forget file system state of a path that has been removed or
+      renamed, of its parent directories and of everything below it.  */
+  static void InvalidateTree(std::string const& path);
+
+  /** Forget all file system state.  */
+  static void InvalidateFileSystem();
+};
+
+#endif
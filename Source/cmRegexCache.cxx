@@ -0,0 +1,103 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmRegexCache.h"
+
+#include <list>
+#include <utility>
+
+#include "cm_unordered_map.hxx"
+
+#ifdef CMAKE_USE_LIBUV
+#include "cm_uv.h"
+#endif
+
+namespace {
+
+// Enough for the distinct expressions of the loops in a project and the
+// modules it includes, while bounding the memory kept.
+static const size_t cmRegexCacheCapacity = 256;
+
+struct cmRegexCacheData
+{
+  cmRegexCacheData()
+  {
+#ifdef CMAKE_USE_LIBUV
+    uv_mutex_init(&this->Mutex);
+#endif
+  }
+
+  // The front of the list is the most recently used entry.
+  typedef std::pair<std::string, cmsys::RegularExpression> EntryType;
+  typedef std::list<EntryType> EntryList;
+  typedef CM_UNORDERED_MAP<std::string, EntryList::iterator> EntryMap;
+
+  EntryList Entries;
+  EntryMap Index;
+
+#ifdef CMAKE_USE_LIBUV
+  uv_mutex_t Mutex;
+#endif
+};
+
+cmRegexCacheData& cmRegexCacheGetData()
+{
+  static cmRegexCacheData data;
+  return data;
+}
+
+class cmRegexCacheLock
+{
+  CM_DISABLE_COPY(cmRegexCacheLock)
+
+public:
+  cmRegexCacheLock(cmRegexCacheData& data)
+    : Data(data)
+  {
+#ifdef CMAKE_USE_LIBUV
+    uv_mutex_lock(&this->Data.Mutex);
+#endif
+  }
+  ~cmRegexCacheLock()
+  {
+#ifdef CMAKE_USE_LIBUV
+    uv_mutex_unlock(&this->Data.Mutex);
+#endif
+  }
+
+private:
+  cmRegexCacheData& Data;
+};
+}
+
+bool cmRegexCache::Compile(cmsys::RegularExpression& regex,
+                           std::string const& pattern)
+{
+  cmRegexCacheData& data = cmRegexCacheGetData();
+  {
+    cmRegexCacheLock lock(data);
+    cmRegexCacheData::EntryMap::iterator i = data.Index.find(pattern);
+    if (i != data.Index.end()) {
+      data.Entries.splice(data.Entries.begin(), data.Entries, i->second);
+      regex = i->second->second;
+      return true;
+    }
+  }
+
+  // Compile without holding the lock.
+  if (!regex.compile(pattern)) {
+    return false;
+  }
+
+  cmRegexCacheLock lock(data);
+  if (data.Index.find(pattern) != data.Index.end()) {
+    // Another thread compiled the same pattern meanwhile.
+    return true;
+  }
+  data.Entries.push_front(cmRegexCacheData::EntryType(pattern, regex));
+  data.Index[pattern] = data.Entries.begin();
+  if (data.Entries.size() > cmRegexCacheCapacity) {
+    data.Index.erase(data.Entries.back().first);
+    data.Entries.pop_back();
+  }
+  return true;
+}
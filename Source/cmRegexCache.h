@@ -0,0 +1,34 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmRegexCache_h
+#define cmRegexCache_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+
+#include "cmsys/RegularExpression.hxx"
+
+/** \class cmRegexCache
+ * \brief Process-wide cache of compiled regular expressions.
+ *
+ * Commands that take a regular expression from the project, such as
+ * string(REGEX), if(MATCHES) and list(FILTER), are often called in loops
+ * with the same expression.  The most recently used compiled programs are
+ * kept so that each expression is compiled once.  Callers get their own
+ * copy, so a cached program never holds the state of a match and may be
+ * evicted while the copy is in use.
+ *
+ * All methods may be called concurrently.
+ */
+class cmRegexCache
+{
+public:
+  /** Compile the pattern into the given regular expression, or copy the
+      program compiled for it before.  Patterns that fail to compile are
+      not cached, so the error is reported again.  */
+  static bool Compile(cmsys::RegularExpression& regex,
+                      std::string const& pattern);
+};
+
+#endif
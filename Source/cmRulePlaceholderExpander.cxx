@@ -2,21 +2,92 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmRulePlaceholderExpander.h"
 
+#include <algorithm>
 #include <ctype.h>
 #include <string.h>
 #include <utility>
 
+#include "cmAlgorithms.h"
 #include "cmOutputConverter.h"
 #include "cmSystemTools.h"
 
+namespace {
+
+typedef cmRulePlaceholderExpander::RuleVariables cmRuleVariables;
+
+// Placeholders replaced by a rule variable whenever it is set.
+struct cmRulePlaceholderVariable
+{
+  const char* Name;
+  const char* cmRuleVariables::*Value;
+};
+
+cmRulePlaceholderVariable const cmRulePlaceholderVariables[] = {
+  { "LINK_FLAGS", &cmRuleVariables::LinkFlags },
+  { "MANIFESTS", &cmRuleVariables::Manifests },
+  { "FLAGS", &cmRuleVariables::Flags },
+  { "SOURCE", &cmRuleVariables::Source },
+  { "PREPROCESSED_SOURCE", &cmRuleVariables::PreprocessedSource },
+  { "ASSEMBLY_SOURCE", &cmRuleVariables::AssemblySource },
+  { "OBJECT", &cmRuleVariables::Object },
+  { "OBJECT_DIR", &cmRuleVariables::ObjectDir },
+  { "OBJECT_FILE_DIR", &cmRuleVariables::ObjectFileDir },
+  { "OBJECTS", &cmRuleVariables::Objects },
+  { "OBJECTS_QUOTED", &cmRuleVariables::ObjectsQuoted },
+  { "DEFINES", &cmRuleVariables::Defines },
+  { "INCLUDES", &cmRuleVariables::Includes },
+  { "TARGET_PDB", &cmRuleVariables::TargetPDB },
+  { "TARGET_COMPILE_PDB", &cmRuleVariables::TargetCompilePDB },
+  { "DEP_FILE", &cmRuleVariables::DependencyFile },
+  { "TARGET", &cmRuleVariables::Target },
+  { "LINK_LIBRARIES", &cmRuleVariables::LinkLibraries },
+  { "LANGUAGE", &cmRuleVariables::Language },
+  { "TARGET_NAME", &cmRuleVariables::CMTargetName },
+  { "TARGET_TYPE", &cmRuleVariables::CMTargetType },
+  { "OUTPUT", &cmRuleVariables::Output }
+};
+
+// Placeholders whose value depends on the rule variables in other ways.
+const char* const cmRulePlaceholderDependentNames[] = {
+  "TARGET_QUOTED",
+  "TARGET_UNQUOTED",
+  "LANGUAGE_COMPILE_FLAGS",
+  "TARGET_IMPLIB",
+  "TARGET_VERSION_MAJOR",
+  "TARGET_VERSION_MINOR",
+  "TARGET_BASE",
+  "TARGET_SONAME",
+  "SONAME_FLAG",
+  "TARGET_INSTALLNAME_DIR"
+};
+
+std::string const& cmRulePlaceholderLookup(
+  std::map<std::string, std::string> const& m, std::string const& key)
+{
+  static std::string const empty;
+  std::map<std::string, std::string>::const_iterator i = m.find(key);
+  if (i == m.end()) {
+    return empty;
+  }
+  return i->second;
+}
+}
+
+cmRulePlaceholderExpander::RuleCache::RuleCache()
+  : Converter(CM_NULLPTR)
+{
+}
+
 cmRulePlaceholderExpander::cmRulePlaceholderExpander(
   std::map<std::string, std::string> const& compilers,
   std::map<std::string, std::string> const& variableMappings,
-  std::string const& compilerSysroot, std::string const& linkerSysroot)
+  std::string const& compilerSysroot, std::string const& linkerSysroot,
+  RuleCache* cache)
   : Compilers(compilers)
   , VariableMappings(variableMappings)
   , CompilerSysroot(compilerSysroot)
   , LinkerSysroot(linkerSysroot)
+  , Cache(cache ? cache : &this->OwnCache)
 {
 }
 
@@ -210,28 +281,27 @@ std::string cmRulePlaceholderExpander::ExpandRuleVariable(
       cmOutputConverter::SHELL);
   }
 
-  std::map<std::string, std::string>::iterator compIt =
+  std::map<std::string, std::string>::const_iterator compIt =
     this->Compilers.find(variable);
 
   if (compIt != this->Compilers.end()) {
+    std::map<std::string, std::string> const& vm = this->VariableMappings;
+    std::string const prefix = "CMAKE_" + compIt->second;
     std::string ret = outputConverter->ConvertToOutputForExisting(
-      this->VariableMappings["CMAKE_" + compIt->second + "_COMPILER"]);
+      cmRulePlaceholderLookup(vm, prefix + "_COMPILER"));
     std::string const& compilerArg1 =
-      this->VariableMappings["CMAKE_" + compIt->second + "_COMPILER_ARG1"];
+      cmRulePlaceholderLookup(vm, prefix + "_COMPILER_ARG1");
     std::string const& compilerTarget =
-      this->VariableMappings["CMAKE_" + compIt->second + "_COMPILER_TARGET"];
+      cmRulePlaceholderLookup(vm, prefix + "_COMPILER_TARGET");
     std::string const& compilerOptionTarget =
-      this->VariableMappings["CMAKE_" + compIt->second +
-                             "_COMPILE_OPTIONS_TARGET"];
+      cmRulePlaceholderLookup(vm, prefix + "_COMPILE_OPTIONS_TARGET");
     std::string const& compilerExternalToolchain =
-      this->VariableMappings["CMAKE_" + compIt->second +
-                             "_COMPILER_EXTERNAL_TOOLCHAIN"];
+      cmRulePlaceholderLookup(vm, prefix + "_COMPILER_EXTERNAL_TOOLCHAIN");
     std::string const& compilerOptionExternalToolchain =
-      this->VariableMappings["CMAKE_" + compIt->second +
-                             "_COMPILE_OPTIONS_EXTERNAL_TOOLCHAIN"];
+      cmRulePlaceholderLookup(vm,
+                              prefix + "_COMPILE_OPTIONS_EXTERNAL_TOOLCHAIN");
     std::string const& compilerOptionSysroot =
-      this->VariableMappings["CMAKE_" + compIt->second +
-                             "_COMPILE_OPTIONS_SYSROOT"];
+      cmRulePlaceholderLookup(vm, prefix + "_COMPILE_OPTIONS_SYSROOT");
 
     // if there is a required first argument to the compiler add it
     // to the compiler string
@@ -267,7 +337,7 @@ std::string cmRulePlaceholderExpander::ExpandRuleVariable(
     return ret;
   }
 
-  std::map<std::string, std::string>::iterator mapIt =
+  std::map<std::string, std::string>::const_iterator mapIt =
     this->VariableMappings.find(variable);
   if (mapIt != this->VariableMappings.end()) {
     if (variable.find("_FLAG") == std::string::npos) {
@@ -278,22 +348,30 @@ std::string cmRulePlaceholderExpander::ExpandRuleVariable(
   return variable;
 }
 
-void cmRulePlaceholderExpander::ExpandRuleVariables(
-  cmOutputConverter* outputConverter, std::string& s,
-  const RuleVariables& replaceValues)
+cmRulePlaceholderExpander::RuleCache::Template const&
+cmRulePlaceholderExpander::CompileRule(std::string const& s)
 {
+  std::map<std::string, RuleCache::Template>::iterator ti =
+    this->Cache->Templates.find(s);
+  if (ti != this->Cache->Templates.end()) {
+    return ti->second;
+  }
+  RuleCache::Template& t = this->Cache->Templates[s];
+  t.Expand = false;
+
   std::string::size_type start = s.find('<');
   // no variables to expand
   if (start == std::string::npos) {
-    return;
+    return t;
   }
   std::string::size_type pos = 0;
-  std::string expandedInput;
+  RuleCache::Segment seg;
   while (start != std::string::npos && start < s.size() - 2) {
     std::string::size_type end = s.find('>', start);
     // if we find a < with no > we are done
     if (end == std::string::npos) {
-      return;
+      t.Segments.clear();
+      return t;
     }
     char c = s[start + 1];
     // if the next char after the < is not A-Za-z then
@@ -303,16 +381,119 @@ void cmRulePlaceholderExpander::ExpandRuleVariables(
     } else {
       // extract the var
       std::string var = s.substr(start + 1, end - start - 1);
-      std::string replace =
-        this->ExpandRuleVariable(outputConverter, var, replaceValues);
-      expandedInput += s.substr(pos, start - pos);
-      expandedInput += replace;
+      if (start > pos) {
+        seg.Text = s.substr(pos, start - pos);
+        seg.Variable = -1;
+        seg.IsPlaceholder = false;
+        seg.IsConstant = false;
+        t.Segments.push_back(seg);
+      }
+      seg.Text = var;
+      seg.Variable = -1;
+      seg.IsPlaceholder = true;
+      for (int i = 0; i < static_cast<int>(cmArraySize(
+                            cmRulePlaceholderVariables));
+           ++i) {
+        if (var == cmRulePlaceholderVariables[i].Name) {
+          seg.Variable = i;
+          break;
+        }
+      }
+      seg.IsConstant = seg.Variable < 0 &&
+        std::find(cmArrayBegin(cmRulePlaceholderDependentNames),
+                  cmArrayEnd(cmRulePlaceholderDependentNames),
+                  var) == cmArrayEnd(cmRulePlaceholderDependentNames);
+      t.Segments.push_back(seg);
       // move to next one
       start = s.find('<', start + var.size() + 2);
       pos = end + 1;
     }
   }
   // add the rest of the input
-  expandedInput += s.substr(pos, s.size() - pos);
-  s = expandedInput;
+  if (pos < s.size()) {
+    seg.Text = s.substr(pos, s.size() - pos);
+    seg.Variable = -1;
+    seg.IsPlaceholder = false;
+    seg.IsConstant = false;
+    t.Segments.push_back(seg);
+  }
+  t.Expand = true;
+  return t;
+}
+
+std::string const& cmRulePlaceholderExpander::ExpandConstant(
+  cmOutputConverter* outputConverter, std::string const& variable,
+  const RuleVariables& replaceValues)
+{
+  RuleCache& cache = *this->Cache;
+  if (cache.Converter != outputConverter) {
+    cache.Converter = outputConverter;
+    for (int f = 0; f < 2; ++f) {
+      cache.Constants[f][0].clear();
+      cache.Constants[f][1].clear();
+    }
+  }
+  // Compilers get the link sysroot when link flags are given, and their
+  // paths are converted differently for a link script shell.
+  std::map<std::string, std::string>& constants =
+    cache.Constants[replaceValues.LinkFlags ? 1 : 0]
+                   [outputConverter->GetLinkScriptShell() ? 1 : 0];
+  std::map<std::string, std::string>::iterator i = constants.find(variable);
+  if (i == constants.end()) {
+    std::map<std::string, std::string>::value_type entry(
+      variable,
+      this->ExpandRuleVariable(outputConverter, variable, replaceValues));
+    i = constants.insert(entry).first;
+  }
+  return i->second;
+}
+
+void cmRulePlaceholderExpander::ExpandRuleVariables(
+  cmOutputConverter* outputConverter, std::string& s,
+  const RuleVariables& replaceValues)
+{
+  RuleCache::Template const& t = this->CompileRule(s);
+  if (!t.Expand) {
+    return;
+  }
+
+  // Look up all values first so the result is allocated only once.
+  std::vector<RuleCache::Segment>::size_type const n = t.Segments.size();
+  std::vector<std::string> values(n);
+  std::vector<std::pair<const char*, std::string::size_type> > pieces(n);
+  std::string::size_type size = 0;
+  for (std::vector<RuleCache::Segment>::size_type i = 0; i < n; ++i) {
+    RuleCache::Segment const& seg = t.Segments[i];
+    const char* value = CM_NULLPTR;
+    std::string::size_type length = 0;
+    if (!seg.IsPlaceholder) {
+      value = seg.Text.c_str();
+      length = seg.Text.size();
+    } else if (seg.Variable >= 0 &&
+               replaceValues.*cmRulePlaceholderVariables[seg.Variable].Value) {
+      value = replaceValues.*cmRulePlaceholderVariables[seg.Variable].Value;
+      length = strlen(value);
+    } else if (seg.IsConstant) {
+      std::string const& constant =
+        this->ExpandConstant(outputConverter, seg.Text, replaceValues);
+      value = constant.c_str();
+      length = constant.size();
+    } else {
+      values[i] =
+        this->ExpandRuleVariable(outputConverter, seg.Text, replaceValues);
+      value = values[i].c_str();
+      length = values[i].size();
+    }
+    pieces[i] = std::make_pair(value, length);
+    size += length;
+  }
+
+  std::string expandedInput;
+  expandedInput.reserve(size);
+  for (std::vector<std::pair<const char*, std::string::size_type> >::
+         const_iterator pi = pieces.begin();
+       pi != pieces.end(); ++pi) {
+    expandedInput.append(pi->first, pi->second);
+  }
+  s.swap(expandedInput);
 }
@@ -8,16 +8,51 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 class cmOutputConverter;
 
 class cmRulePlaceholderExpander
 {
 public:
+  /** Rule templates compiled into literal text and placeholder slots.
+      One cache is shared by all expanders of a local generator so that
+      each template is scanned only once.  Placeholders whose values do
+      not depend on the rule variables are also expanded only once.  */
+  class RuleCache
+  {
+  public:
+    RuleCache();
+
+  private:
+    friend class cmRulePlaceholderExpander;
+
+    struct Segment
+    {
+      std::string Text;
+      // Index of the rule variable for the placeholder, if any.
+      int Variable;
+      bool IsPlaceholder;
+      bool IsConstant;
+    };
+    struct Template
+    {
+      bool Expand;
+      std::vector<Segment> Segments;
+    };
+    std::map<std::string, Template> Templates;
+
+    // Values of constant placeholders, indexed by whether link flags are
+    // given and whether the converter writes for a link script shell.
+    cmOutputConverter* Converter;
+    std::map<std::string, std::string> Constants[2][2];
+  };
+
   cmRulePlaceholderExpander(
     std::map<std::string, std::string> const& compilers,
     std::map<std::string, std::string> const& variableMappings,
-    std::string const& compilerSysroot, std::string const& linkerSysroot);
+    std::string const& compilerSysroot, std::string const& linkerSysroot,
+    RuleCache* cache = CM_NULLPTR);
 
   void SetTargetImpLib(std::string const& targetImpLib)
   {
@@ -71,12 +106,19 @@ public:
                                  const RuleVariables& replaceValues);
 
 private:
+  RuleCache::Template const& CompileRule(std::string const& s);
+  std::string const& ExpandConstant(cmOutputConverter* outputConverter,
+                                    std::string const& variable,
+                                    const RuleVariables& replaceValues);
+
   std::string TargetImpLib;
 
-  std::map<std::string, std::string> Compilers;
-  std::map<std::string, std::string> VariableMappings;
+  std::map<std::string, std::string> const& Compilers;
+  std::map<std::string, std::string> const& VariableMappings;
   std::string CompilerSysroot;
   std::string LinkerSysroot;
+  RuleCache OwnCache;
+  RuleCache* Cache;
 };
 
 #endif
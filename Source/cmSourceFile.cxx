@@ -7,6 +7,7 @@
 #include "cmCustomCommand.h"
 #include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
+#include "cmPathCache.h"
 #include "cmProperty.h"
 #include "cmState.h"
 #include "cmSystemTools.h"
@@ -148,7 +149,7 @@ bool cmSourceFile::FindFullPath(std::string* error)
       tryPath += "/";
     }
     tryPath += this->Location.GetName();
-    tryPath = cmSystemTools::CollapseFullPath(tryPath, *di);
+    tryPath = cmPathCache::CollapseFullPath(tryPath, *di);
     if (this->TryFullPath(tryPath, "")) {
       return true;
     }
@@ -197,7 +198,7 @@ bool cmSourceFile::TryFullPath(const std::string& path, const std::string& ext)
     tryPath += ".";
     tryPath += ext;
   }
-  if (cmSystemTools::FileExists(tryPath.c_str())) {
+  if (cmPathCache::FileExists(tryPath)) {
     this->FullPath = tryPath;
     return true;
   }
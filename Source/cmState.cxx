@@ -31,11 +31,13 @@ cmState::cmState()
   , MSYSShell(false)
 {
   this->CacheManager = new cmCacheManager;
+  this->BacktraceStorage = cmListFileBacktrace::CreateStorage();
 }
 
 cmState::~cmState()
 {
   delete this->CacheManager;
+  cmListFileBacktrace::DestroyStorage(this->BacktraceStorage);
   cmDeleteAll(this->BuiltinCommands);
   cmDeleteAll(this->ScriptedCommands);
 }
@@ -599,6 +601,11 @@ unsigned int cmState::GetCacheMinorVersion() const
   return this->CacheManager->GetCacheMinorVersion();
 }
 
+cmListFileBacktraceStorage* cmState::GetBacktraceStorage() const
+{
+  return this->BacktraceStorage;
+}
+
 const char* cmState::GetBinaryDirectory() const
 {
   return this->BinaryDirectory.c_str();
@@ -21,6 +21,7 @@
 
 class cmCacheManager;
 class cmCommand;
+class cmListFileBacktraceStorage;
 class cmPropertyDefinition;
 class cmStateSnapshot;
 
@@ -158,6 +159,8 @@ public:
   unsigned int GetCacheMajorVersion() const;
   unsigned int GetCacheMinorVersion() const;
 
+  cmListFileBacktraceStorage* GetBacktraceStorage() const;
+
 private:
   friend class cmake;
   void AddCacheEntry(const std::string& key, const char* value,
@@ -170,6 +173,7 @@ private:
   std::map<std::string, cmCommand*> ScriptedCommands;
   cmPropertyMap GlobalProperties;
   cmCacheManager* CacheManager;
+  cmListFileBacktraceStorage* BacktraceStorage;
 
   cmLinkedTree<cmStateDetail::BuildsystemDirectoryStateType>
     BuildsystemDirectory;
@@ -12,6 +12,7 @@
 #include "cmCryptoHash.h"
 #include "cmGeneratorExpression.h"
 #include "cmMakefile.h"
+#include "cmRegexCache.h"
 #include "cmSystemTools.h"
 #include "cmTimestamp.h"
 #include "cmUuid.h"
@@ -253,7 +254,7 @@ bool cmStringCommand::RegexMatch(std::vector<std::string> const& args)
   this->Makefile->ClearMatches();
   // Compile the regular expression.
   cmsys::RegularExpression re;
-  if (!re.compile(regex.c_str())) {
+  if (!cmRegexCache::Compile(re, regex)) {
     std::string e =
       "sub-command REGEX, mode MATCH failed to compile regex \"" + regex +
       "\".";
@@ -294,7 +295,7 @@ bool cmStringCommand::RegexMatchAll(std::vector<std::string> const& args)
   this->Makefile->ClearMatches();
   // Compile the regular expression.
   cmsys::RegularExpression re;
-  if (!re.compile(regex.c_str())) {
+  if (!cmRegexCache::Compile(re, regex)) {
     std::string e =
       "sub-command REGEX, mode MATCHALL failed to compile regex \"" + regex +
       "\".";
@@ -377,7 +378,7 @@ bool cmStringCommand::RegexReplace(std::vector<std::string> const& args)
   this->Makefile->ClearMatches();
   // Compile the regular expression.
   cmsys::RegularExpression re;
-  if (!re.compile(regex.c_str())) {
+  if (!cmRegexCache::Compile(re, regex)) {
     std::string e =
       "sub-command REGEX, mode REPLACE failed to compile regex \"" + regex +
       "\".";
@@ -65,6 +65,16 @@
 #include <mach-o/dyld.h>
 #endif
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
+
 #ifdef __QNX__
 #include <malloc.h> /* for malloc/free on QNX */
 #endif
@@ -849,15 +859,155 @@ std::string cmSystemTools::FileExistsInParentDirectories(const char* fname,
   return "";
 }
 
+#if defined(__linux__)
+// Copy the content of the open regular file 'in' into destination, which
+// is created or truncated.  The size from fstat is only a hint: files in
+// /proc report none, and others may change while copied.  The caller owns
+// 'in'.
+static bool cmSystemToolsCloneFileContent(int in, off_t size,
+                                          std::string const& destination)
+{
+  int out = open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (out < 0) {
+    return false;
+  }
+
+  // A reflink shares the extents on copy-on-write file systems.
+  bool ok = size > 0 && ioctl(out, FICLONE, in) == 0;
+  if (!ok) {
+    // Both calls below advance the file offsets, so sendfile picks up
+    // where copy_file_range stopped (e.g. across file systems), and the
+    // read loop where either stopped.
+    off_t remaining = size;
+#if defined(__NR_copy_file_range)
+    while (remaining > 0) {
+      long n = syscall(__NR_copy_file_range, in, CM_NULLPTR, out, CM_NULLPTR,
+                       static_cast<size_t>(remaining), 0u);
+      if (n <= 0) {
+        break;
+      }
+      remaining -= n;
+    }
+#endif
+    while (remaining > 0) {
+      size_t const chunk = remaining > 0x40000000
+        ? static_cast<size_t>(0x40000000)
+        : static_cast<size_t>(remaining);
+      ssize_t n = sendfile(out, in, CM_NULLPTR, chunk);
+      if (n <= 0) {
+        break;
+      }
+      remaining -= n;
+    }
+
+    // Copy the rest until the end of the file.
+    ok = true;
+    char buffer[16384];
+    while (ok) {
+      ssize_t n = read(in, buffer, sizeof(buffer));
+      if (n == 0) {
+        break;
+      }
+      if (n < 0) {
+        ok = errno == EINTR;
+        continue;
+      }
+      for (char const* p = buffer; ok && n > 0;) {
+        ssize_t const w = write(out, p, static_cast<size_t>(n));
+        if (w < 0) {
+          ok = errno == EINTR;
+          continue;
+        }
+        p += w;
+        n -= w;
+      }
+    }
+  }
+
+  if (close(out) != 0) {
+    ok = false;
+  }
+  return ok;
+}
+#endif
+
 bool cmSystemTools::cmCopyFile(const char* source, const char* destination)
 {
+#if defined(__linux__)
+  // Follow the steps of CopyFileAlways but let the kernel copy the data.
+  if (!cmSystemTools::SameFile(source, destination) &&
+      !cmSystemTools::FileIsDirectory(source)) {
+    mode_t perm = 0;
+    bool perms = cmSystemTools::GetPermissions(source, perm);
+    std::string real_destination = destination;
+    std::string destination_dir;
+    if (cmSystemTools::FileIsDirectory(destination)) {
+      destination_dir = real_destination;
+      cmSystemTools::ConvertToUnixSlashes(real_destination);
+      real_destination += '/';
+      real_destination += cmSystemTools::GetFilenameName(source);
+    } else {
+      destination_dir = cmSystemTools::GetFilenamePath(destination);
+    }
+    // Open the source before removing the destination so that a missing
+    // or unreadable source leaves the destination alone.
+    int in = open(source, O_RDONLY);
+    if (in >= 0) {
+      bool cloned = false;
+      struct stat st;
+      if (fstat(in, &st) == 0 && S_ISREG(st.st_mode)) {
+        cmSystemTools::MakeDirectory(destination_dir);
+        cmSystemTools::RemoveFile(real_destination);
+        cloned = cmSystemToolsCloneFileContent(in, st.st_size,
+                                               real_destination);
+      }
+      close(in);
+      if (cloned) {
+        return !perms ||
+          cmSystemTools::SetPermissions(real_destination, perm);
+      }
+    }
+  }
+#endif
   return Superclass::CopyFileAlways(source, destination);
 }
 
 bool cmSystemTools::CopyFileIfDifferent(const char* source,
                                         const char* destination)
 {
-  return Superclass::CopyFileIfDifferent(source, destination);
+  // Compare against the file a copy into a directory would create.
+  std::string real_destination = destination;
+  if (cmSystemTools::FileIsDirectory(real_destination)) {
+    cmSystemTools::ConvertToUnixSlashes(real_destination);
+    real_destination += '/';
+    real_destination += cmSystemTools::GetFilenameName(source);
+  }
+  if (cmSystemTools::FilesDiffer(source, real_destination)) {
+    return cmSystemTools::cmCopyFile(source, destination);
+  }
+  return true;
+}
+
+bool cmSystemTools::CloneFileContent(std::string const& source,
+                                     std::string const& destination)
+{
+#if defined(__linux__)
+  int in = open(source.c_str(), O_RDONLY);
+  if (in < 0) {
+    return false;
+  }
+  bool ok = false;
+  struct stat st;
+  if (fstat(in, &st) == 0 && S_ISREG(st.st_mode)) {
+    ok = cmSystemToolsCloneFileContent(in, st.st_size, destination);
+  }
+  close(in);
+  return ok;
+#else
+  (void)source;
+  (void)destination;
+  return false;
+#endif
 }
 
 #ifdef _WIN32
@@ -934,6 +1084,19 @@ bool cmSystemTools::RenameFile(const char* oldname, const char* newname)
 #endif
 }
 
+bool cmSystemTools::CreateLink(std::string const& origName,
+                               std::string const& newName)
+{
+#ifdef _WIN32
+  return CreateHardLinkW(
+           SystemTools::ConvertToWindowsExtendedPath(newName).c_str(),
+           SystemTools::ConvertToWindowsExtendedPath(origName).c_str(),
+           CM_NULLPTR) != 0;
+#else
+  return link(origName.c_str(), newName.c_str()) == 0;
+#endif
+}
+
 std::string cmSystemTools::ComputeFileHash(const std::string& source,
                                            cmCryptoHash::Algo algo)
 {
@@ -1431,7 +1594,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
                               const std::vector<std::string>& files,
                               cmTarCompression compressType, bool verbose,
                               std::string const& mtime,
-                              std::string const& format)
+                              std::string const& format, unsigned int threads)
 {
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   std::string cwd = cmSystemTools::GetCurrentWorkingDirectory();
@@ -1460,7 +1623,8 @@ bool cmSystemTools::CreateTar(const char* outFileName,
       break;
   }
 
-  cmArchiveWrite a(fout, compress, format.empty() ? "paxr" : format);
+  cmArchiveWrite a(fout, compress, format.empty() ? "paxr" : format,
+                   threads);
 
   a.SetMTime(mtime);
   a.SetVerbose(verbose);
@@ -1475,7 +1639,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
       break;
     }
   }
-  if (!a) {
+  if (!a.Close()) {
     cmSystemTools::Error(a.GetError().c_str());
     return false;
   }
@@ -1484,6 +1648,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
   (void)outFileName;
   (void)files;
   (void)verbose;
+  (void)threads;
   return false;
 #endif
 }
@@ -2276,6 +2441,146 @@ struct cmSystemToolsRPathInfo
   std::string Name;
   std::string Value;
 };
+
+// Remove the RPATH from an ELF binary that was already parsed.
+static bool cmSystemToolsRemoveRPath(cmELF& elf, std::string const& file,
+                                     std::string* emsg, bool* removed)
+{
+  if (removed) {
+    *removed = false;
+  }
+  int zeroCount = 0;
+  unsigned long zeroPosition[2] = { 0, 0 };
+  unsigned long zeroSize[2] = { 0, 0 };
+  unsigned long bytesBegin = 0;
+  std::vector<char> bytes;
+  {
+    // Get the RPATH and RUNPATH entries from the ELF binary and sort
+    // them by index in the dynamic section header.
+    int se_count = 0;
+    cmELF::StringEntry const* se[2] = { CM_NULLPTR, CM_NULLPTR };
+    if (cmELF::StringEntry const* se_rpath = elf.GetRPath()) {
+      se[se_count++] = se_rpath;
+    }
+    if (cmELF::StringEntry const* se_runpath = elf.GetRunPath()) {
+      se[se_count++] = se_runpath;
+    }
+    if (se_count == 0) {
+      // There is no RPATH or RUNPATH anyway.
+      return true;
+    }
+    if (se_count == 2 && se[1]->IndexInSection < se[0]->IndexInSection) {
+      std::swap(se[0], se[1]);
+    }
+
+    // Obtain a copy of the dynamic entries
+    cmELF::DynamicEntryList dentries = elf.GetDynamicEntries();
+    if (dentries.empty()) {
+      // This should happen only for invalid ELF files where a DT_NULL
+      // appears before the end of the table.
+      if (emsg) {
+        *emsg = "DYNAMIC section contains a DT_NULL before the end.";
+      }
+      return false;
+    }
+
+    // Save information about the string entries to be zeroed.
+    zeroCount = se_count;
+    for (int i = 0; i < se_count; ++i) {
+      zeroPosition[i] = se[i]->Position;
+      zeroSize[i] = se[i]->Size;
+    }
+
+    // Get size of one DYNAMIC entry
+    unsigned long const sizeof_dentry =
+      elf.GetDynamicEntryPosition(1) - elf.GetDynamicEntryPosition(0);
+
+    // Adjust the entry list as necessary to remove the run path
+    unsigned long entriesErased = 0;
+    for (cmELF::DynamicEntryList::iterator it = dentries.begin();
+         it != dentries.end();) {
+      if (it->first == cmELF::TagRPath || it->first == cmELF::TagRunPath) {
+        it = dentries.erase(it);
+        entriesErased++;
+        continue;
+      }
+      if (cmELF::TagMipsRldMapRel != 0 &&
+          it->first == cmELF::TagMipsRldMapRel) {
+        // Background: debuggers need to know the "linker map" which contains
+        // the addresses each dynamic object is loaded at. Most arches use
+        // the DT_DEBUG tag which the dynamic linker writes to (directly) and
+        // contain the location of the linker map, however on MIPS the
+        // .dynamic section is always read-only so this is not possible. MIPS
+        // objects instead contain a DT_MIPS_RLD_MAP tag which contains the
+        // address where the dyanmic linker will write to (an indirect
+        // version of DT_DEBUG). Since this doesn't work when using PIE, a
+        // relative equivalent was created - DT_MIPS_RLD_MAP_REL. Since this
+        // version contains a relative offset, moving it changes the
+        // calculated address. This may cause the dyanmic linker to write
+        // into memory it should not be changing.
+        //
+        // To fix this, we adjust the value of DT_MIPS_RLD_MAP_REL here. If
+        // we move it up by n bytes, we add n bytes to the value of this tag.
+        it->second += entriesErased * sizeof_dentry;
+      }
+
+      it++;
+    }
+
+    // Encode new entries list
+    bytes = elf.EncodeDynamicEntries(dentries);
+    bytesBegin = elf.GetDynamicEntryPosition(0);
+  }
+
+  // Open the file for update.
+  cmsys::ofstream f(file.c_str(),
+                    std::ios::in | std::ios::out | std::ios::binary);
+  if (!f) {
+    if (emsg) {
+      *emsg = "Error opening file for update.";
+    }
+    return false;
+  }
+
+  // Write the new DYNAMIC table header.
+  if (!f.seekp(bytesBegin)) {
+    if (emsg) {
+      *emsg = "Error seeking to DYNAMIC table header for RPATH.";
+    }
+    return false;
+  }
+  if (!f.write(&bytes[0], bytes.size())) {
+    if (emsg) {
+      *emsg = "Error replacing DYNAMIC table header.";
+    }
+    return false;
+  }
+
+  // Fill the RPATH and RUNPATH strings with zero bytes.
+  for (int i = 0; i < zeroCount; ++i) {
+    if (!f.seekp(zeroPosition[i])) {
+      if (emsg) {
+        *emsg = "Error seeking to RPATH position.";
+      }
+      return false;
+    }
+    for (unsigned long j = 0; j < zeroSize[i]; ++j) {
+      f << '\0';
+    }
+    if (!f) {
+      if (emsg) {
+        *emsg = "Error writing the empty rpath string to the file.";
+      }
+      return false;
+    }
+  }
+
+  // Everything was updated successfully.
+  if (removed) {
+    *removed = true;
+  }
+  return true;
+}
 #endif
 
 bool cmSystemTools::ChangeRPath(std::string const& file,
@@ -2290,10 +2595,10 @@ bool cmSystemTools::ChangeRPath(std::string const& file,
   int rp_count = 0;
   bool remove_rpath = true;
   cmSystemToolsRPathInfo rp[2];
-  {
-    // Parse the ELF binary.
-    cmELF elf(file.c_str());
 
+  // Parse the ELF binary once for both the check and the update.
+  cmELF elf(file.c_str());
+  {
     // Get the RPATH and RUNPATH entries from it.
     int se_count = 0;
     cmELF::StringEntry const* se[2] = { CM_NULLPTR, CM_NULLPTR };
@@ -2399,7 +2704,7 @@ bool cmSystemTools::ChangeRPath(std::string const& file,
 
   // If the resulting rpath is empty, just remove the entire entry instead.
   if (remove_rpath) {
-    return cmSystemTools::RemoveRPath(file, emsg, changed);
+    return cmSystemToolsRemoveRPath(elf, file, emsg, changed);
   }
 
   {
@@ -2595,143 +2900,8 @@ bool cmSystemTools::RemoveRPath(std::string const& file, std::string* emsg,
                                 bool* removed)
 {
 #if defined(CMAKE_USE_ELF_PARSER)
-  if (removed) {
-    *removed = false;
-  }
-  int zeroCount = 0;
-  unsigned long zeroPosition[2] = { 0, 0 };
-  unsigned long zeroSize[2] = { 0, 0 };
-  unsigned long bytesBegin = 0;
-  std::vector<char> bytes;
-  {
-    // Parse the ELF binary.
-    cmELF elf(file.c_str());
-
-    // Get the RPATH and RUNPATH entries from it and sort them by index
-    // in the dynamic section header.
-    int se_count = 0;
-    cmELF::StringEntry const* se[2] = { CM_NULLPTR, CM_NULLPTR };
-    if (cmELF::StringEntry const* se_rpath = elf.GetRPath()) {
-      se[se_count++] = se_rpath;
-    }
-    if (cmELF::StringEntry const* se_runpath = elf.GetRunPath()) {
-      se[se_count++] = se_runpath;
-    }
-    if (se_count == 0) {
-      // There is no RPATH or RUNPATH anyway.
-      return true;
-    }
-    if (se_count == 2 && se[1]->IndexInSection < se[0]->IndexInSection) {
-      std::swap(se[0], se[1]);
-    }
-
-    // Obtain a copy of the dynamic entries
-    cmELF::DynamicEntryList dentries = elf.GetDynamicEntries();
-    if (dentries.empty()) {
-      // This should happen only for invalid ELF files where a DT_NULL
-      // appears before the end of the table.
-      if (emsg) {
-        *emsg = "DYNAMIC section contains a DT_NULL before the end.";
-      }
-      return false;
-    }
-
-    // Save information about the string entries to be zeroed.
-    zeroCount = se_count;
-    for (int i = 0; i < se_count; ++i) {
-      zeroPosition[i] = se[i]->Position;
-      zeroSize[i] = se[i]->Size;
-    }
-
-    // Get size of one DYNAMIC entry
-    unsigned long const sizeof_dentry =
-      elf.GetDynamicEntryPosition(1) - elf.GetDynamicEntryPosition(0);
-
-    // Adjust the entry list as necessary to remove the run path
-    unsigned long entriesErased = 0;
-    for (cmELF::DynamicEntryList::iterator it = dentries.begin();
-         it != dentries.end();) {
-      if (it->first == cmELF::TagRPath || it->first == cmELF::TagRunPath) {
-        it = dentries.erase(it);
-        entriesErased++;
-        continue;
-      }
-      if (cmELF::TagMipsRldMapRel != 0 &&
-          it->first == cmELF::TagMipsRldMapRel) {
-        // Background: debuggers need to know the "linker map" which contains
-        // the addresses each dynamic object is loaded at. Most arches use
-        // the DT_DEBUG tag which the dynamic linker writes to (directly) and
-        // contain the location of the linker map, however on MIPS the
-        // .dynamic section is always read-only so this is not possible. MIPS
-        // objects instead contain a DT_MIPS_RLD_MAP tag which contains the
-        // address where the dyanmic linker will write to (an indirect
-        // version of DT_DEBUG). Since this doesn't work when using PIE, a
-        // relative equivalent was created - DT_MIPS_RLD_MAP_REL. Since this
-        // version contains a relative offset, moving it changes the
-        // calculated address. This may cause the dyanmic linker to write
-        // into memory it should not be changing.
-        //
-        // To fix this, we adjust the value of DT_MIPS_RLD_MAP_REL here. If
-        // we move it up by n bytes, we add n bytes to the value of this tag.
-        it->second += entriesErased * sizeof_dentry;
-      }
-
-      it++;
-    }
-
-    // Encode new entries list
-    bytes = elf.EncodeDynamicEntries(dentries);
-    bytesBegin = elf.GetDynamicEntryPosition(0);
-  }
-
-  // Open the file for update.
-  cmsys::ofstream f(file.c_str(),
-                    std::ios::in | std::ios::out | std::ios::binary);
-  if (!f) {
-    if (emsg) {
-      *emsg = "Error opening file for update.";
-    }
-    return false;
-  }
-
-  // Write the new DYNAMIC table header.
-  if (!f.seekp(bytesBegin)) {
-    if (emsg) {
-      *emsg = "Error seeking to DYNAMIC table header for RPATH.";
-    }
-    return false;
-  }
-  if (!f.write(&bytes[0], bytes.size())) {
-    if (emsg) {
-      *emsg = "Error replacing DYNAMIC table header.";
-    }
-    return false;
-  }
-
-  // Fill the RPATH and RUNPATH strings with zero bytes.
-  for (int i = 0; i < zeroCount; ++i) {
-    if (!f.seekp(zeroPosition[i])) {
-      if (emsg) {
-        *emsg = "Error seeking to RPATH position.";
-      }
-      return false;
-    }
-    for (unsigned long j = 0; j < zeroSize[i]; ++j) {
-      f << '\0';
-    }
-    if (!f) {
-      if (emsg) {
-        *emsg = "Error writing the empty rpath string to the file.";
-      }
-      return false;
-    }
-  }
-
-  // Everything was updated successfully.
-  if (removed) {
-    *removed = true;
-  }
-  return true;
+  cmELF elf(file.c_str());
+  return cmSystemToolsRemoveRPath(elf, file, emsg, removed);
 #else
   (void)file;
   (void)emsg;
@@ -176,10 +176,23 @@ public:
   static bool cmCopyFile(const char* source, const char* destination);
   static bool CopyFileIfDifferent(const char* source, const char* destination);
 
+  /** Copy the content of the regular file source into destination,
+      which is created or truncated, letting the kernel do the work
+      (reflink, copy_file_range or sendfile).  Returns false if none of
+      these is available, in which case nothing useful was written and
+      the caller should fall back to a buffered copy.  */
+  static bool CloneFileContent(std::string const& source,
+                               std::string const& destination);
+
   /** Rename a file or directory within a single disk volume (atomic
       if possible).  */
   static bool RenameFile(const char* oldname, const char* newname);
 
+  /** Create a hard link newName to the existing file origName.  Both
+      must be on the same disk volume.  */
+  static bool CreateLink(std::string const& origName,
+                         std::string const& newName);
+
   ///! Compute the hash of a file
   static std::string ComputeFileHash(const std::string& source,
                                      cmCryptoHash::Algo algo);
@@ -414,7 +427,8 @@ public:
                         const std::vector<std::string>& files,
                         cmTarCompression compressType, bool verbose,
                         std::string const& mtime = std::string(),
-                        std::string const& format = std::string());
+                        std::string const& format = std::string(),
+                        unsigned int threads = 1);
   static bool ExtractTar(const char* inFileName, bool verbose);
   // This should be called first thing in main
   // it will keep child processes from inheriting the
@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include "cmMakefile.h"
+#include "cmPathCache.h"
 #include "cmState.h"
 #include "cmStateTypes.h"
 #include "cmSystemTools.h"
@@ -191,6 +192,8 @@ void cmTryRunCommand::RunExecutable(const std::string& runArgs,
   bool worked = cmSystemTools::RunSingleCommand(
     finalCommand.c_str(), out, out, &retVal, CM_NULLPTR,
     cmSystemTools::OUTPUT_NONE, timeout);
+  // The executable may have created or removed any file.
+  cmPathCache::InvalidateFileSystem();
   // set the run var
   char retChar[1000];
   if (worked) {
@@ -282,6 +285,7 @@ void cmTryRunCommand::DoNotRunExecutable(const std::string& runArgs,
     static bool firstTryRun = true;
     cmsys::ofstream file(resultFileName.c_str(),
                          firstTryRun ? std::ios::out : std::ios::app);
+    cmPathCache::InvalidatePath(resultFileName);
     if (file) {
       if (firstTryRun) {
         /* clang-format off */
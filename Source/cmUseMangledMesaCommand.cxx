@@ -5,6 +5,7 @@
 #include "cmsys/FStream.hxx"
 #include "cmsys/RegularExpression.hxx"
 
+#include "cmPathCache.h"
 #include "cmSystemTools.h"
 
 class cmExecutionStatus;
@@ -103,4 +104,5 @@ void cmUseMangledMesaCommand::CopyAndFullPathMesaHeader(const char* source,
   fout.close();
   cmSystemTools::CopyFileIfDifferent(tempOutputFile.c_str(), outFile.c_str());
   cmSystemTools::RemoveFile(tempOutputFile);
+  cmPathCache::InvalidatePath(outFile);
 }
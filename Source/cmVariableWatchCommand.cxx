@@ -42,17 +42,18 @@ static void cmVariableWatchCommandVariableAccessed(const std::string& variable,
 
   std::string stack = makefile->GetProperty("LISTFILE_STACK");
   if (!data->Command.empty()) {
-    newLFF.Arguments.clear();
-    newLFF.Arguments.push_back(
+    std::vector<cmListFileArgument> newLFFArgs;
+    newLFFArgs.push_back(
       cmListFileArgument(variable, cmListFileArgument::Quoted, 9999));
-    newLFF.Arguments.push_back(
+    newLFFArgs.push_back(
       cmListFileArgument(accessString, cmListFileArgument::Quoted, 9999));
-    newLFF.Arguments.push_back(cmListFileArgument(
+    newLFFArgs.push_back(cmListFileArgument(
       newValue ? newValue : "", cmListFileArgument::Quoted, 9999));
-    newLFF.Arguments.push_back(
+    newLFFArgs.push_back(
       cmListFileArgument(currentListFile, cmListFileArgument::Quoted, 9999));
-    newLFF.Arguments.push_back(
+    newLFFArgs.push_back(
       cmListFileArgument(stack, cmListFileArgument::Quoted, 9999));
+    newLFF.SetArguments(newLFFArgs);
     newLFF.Name = data->Command;
     newLFF.Line = 9999;
     cmExecutionStatus status;
@@ -119,7 +119,7 @@ bool cmWhileFunctionBlocker::ShouldRemove(const cmListFileFunction& lff,
   if (!cmSystemTools::Strucmp(lff.Name.c_str(), "endwhile")) {
     // if the endwhile has arguments, then make sure
     // they match the arguments of the matching while
-    if (lff.Arguments.empty() || lff.Arguments == this->Args) {
+    if (lff.GetArguments().empty() || lff.GetArguments() == this->Args) {
       return true;
     }
   }
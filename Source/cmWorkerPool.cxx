@@ -0,0 +1,95 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmWorkerPool.h"
+
+#include <stddef.h>
+
+#ifdef CMAKE_USE_LIBUV
+#include "cm_uv.h"
+
+namespace {
+struct cmWorkerPoolQueue
+{
+  std::vector<cmWorkerPool::Job*> const* Jobs;
+  size_t Next;
+  uv_mutex_t Mutex;
+};
+}
+
+static void cmWorkerPoolThread(void* arg)
+{
+  cmWorkerPoolQueue* queue = static_cast<cmWorkerPoolQueue*>(arg);
+  for (;;) {
+    uv_mutex_lock(&queue->Mutex);
+    size_t const index = queue->Next++;
+    uv_mutex_unlock(&queue->Mutex);
+    if (index >= queue->Jobs->size()) {
+      return;
+    }
+    (*queue->Jobs)[index]->Process();
+  }
+}
+#endif
+
+cmWorkerPool::cmWorkerPool(unsigned int threadCount)
+  : ThreadCount(threadCount)
+{
+  if (this->ThreadCount == 0) {
+    this->ThreadCount = cmWorkerPool::GetHardwareThreadCount();
+  }
+}
+
+void cmWorkerPool::Process(std::vector<Job*> const& jobs)
+{
+  size_t threads = this->ThreadCount;
+  if (threads > jobs.size()) {
+    threads = jobs.size();
+  }
+
+#ifdef CMAKE_USE_LIBUV
+  if (threads > 1) {
+    cmWorkerPoolQueue queue;
+    queue.Jobs = &jobs;
+    queue.Next = 0;
+    if (uv_mutex_init(&queue.Mutex) == 0) {
+      // The calling thread is one of the workers.
+      std::vector<uv_thread_t> tids(threads - 1);
+      size_t started = 0;
+      for (; started < tids.size(); ++started) {
+        if (uv_thread_create(&tids[started], cmWorkerPoolThread, &queue) !=
+            0) {
+          break;
+        }
+      }
+      // This also drains the queue if no thread could be started at all.
+      cmWorkerPoolThread(&queue);
+      for (size_t i = 0; i < started; ++i) {
+        uv_thread_join(&tids[i]);
+      }
+      uv_mutex_destroy(&queue.Mutex);
+      return;
+    }
+  }
+#endif
+
+  for (std::vector<Job*>::const_iterator it = jobs.begin(); it != jobs.end();
+       ++it) {
+    (*it)->Process();
+  }
+}
+
+unsigned int cmWorkerPool::GetHardwareThreadCount()
+{
+  unsigned int count = 1;
+#ifdef CMAKE_USE_LIBUV
+  uv_cpu_info_t* info = CM_NULLPTR;
+  int n = 0;
+  if (uv_cpu_info(&info, &n) == 0) {
+    if (n > 0) {
+      count = static_cast<unsigned int>(n);
+    }
+    uv_free_cpu_info(info, n);
+  }
+#endif
+  return count;
+}
@@ -0,0 +1,47 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmWorkerPool_h
+#define cmWorkerPool_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <vector>
+
+/** \class cmWorkerPool
+ * \brief Run a batch of independent jobs on a bounded number of threads.
+ *
+ * Jobs are handed out in order and Process() returns only after every
+ * job has finished.  Callers store per-job results in the job objects
+ * and report them afterwards, so output order does not depend on
+ * scheduling.  Without libuv (e.g. while bootstrapping) the jobs run
+ * serially on the calling thread.
+ */
+class cmWorkerPool
+{
+  CM_DISABLE_COPY(cmWorkerPool)
+
+public:
+  class Job
+  {
+  public:
+    virtual ~Job() {}
+    virtual void Process() = 0;
+  };
+
+  /** Construct a pool running at most threadCount jobs concurrently.
+      A count of zero selects the number of hardware threads.  */
+  cmWorkerPool(unsigned int threadCount = 0);
+
+  unsigned int GetThreadCount() const { return this->ThreadCount; }
+
+  /** Run all jobs and wait for them to finish.  */
+  void Process(std::vector<Job*> const& jobs);
+
+  /** Return the number of threads the hardware can run concurrently.  */
+  static unsigned int GetHardwareThreadCount();
+
+private:
+  unsigned int ThreadCount;
+};
+
+#endif
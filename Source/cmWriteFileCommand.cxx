@@ -5,6 +5,7 @@
 #include "cmsys/FStream.hxx"
 
 #include "cmMakefile.h"
+#include "cmPathCache.h"
 #include "cmSystemTools.h"
 #include "cm_sys_stat.h"
 
@@ -69,6 +70,7 @@ bool cmWriteFileCommand::InitialPass(std::vector<std::string> const& args,
   }
   file << message << std::endl;
   file.close();
+  cmPathCache::InvalidatePath(fileName);
   if (mode) {
     cmSystemTools::SetPermissions(fileName.c_str(), mode);
   }
@@ -13,10 +13,14 @@
 #include "cmGeneratorTarget.h"
 #include "cmGlobalGenerator.h"
 #include "cmGlobalGeneratorFactory.h"
+#include "cmGlobVerificationManager.h"
+#include "cmInstallHashCache.h"
+#include "cmInstallQueue.h"
 #include "cmLinkLineComputer.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #include "cmMessenger.h"
+#include "cmPathCache.h"
 #include "cmState.h"
 #include "cmStateDirectory.h"
 #include "cmSystemTools.h"
@@ -160,6 +164,9 @@ cmake::cmake(Role role)
   this->DebugTryCompile = false;
   this->ClearBuildSystem = false;
   this->FileComparison = new cmFileTimeComparison;
+  this->InstallQueue = new cmInstallQueue;
+  this->InstallHashCache = new cmInstallHashCache;
+  this->GlobVerificationManager = new cmGlobVerificationManager;
 
   this->State = new cmState;
   this->CurrentSnapshot = this->State->CreateBaseSnapshot();
@@ -235,6 +242,9 @@ cmake::~cmake()
   delete this->VariableWatch;
 #endif
   delete this->FileComparison;
+  delete this->InstallQueue;
+  delete this->InstallHashCache;
+  delete this->GlobVerificationManager;
 }
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
@@ -1334,6 +1344,12 @@ int cmake::ActualConfigure()
   this->UpdateConversionPathTable();
   this->CleanupCommandsAndMacros();
 
+  // Files may have changed since a previous configure in this process.
+  if (!this->GetIsInTryCompile()) {
+    cmPathCache::InvalidateFileSystem();
+  }
+  this->GlobVerificationManager->Reset();
+
   int res = 0;
   if (this->GetWorkingMode() == NORMAL_MODE) {
     res = this->DoPreConfigureChecks();
@@ -1676,6 +1692,12 @@ int cmake::Generate()
   if (!this->GlobalGenerator->Compute()) {
     return -1;
   }
+  std::string cmakeFiles = this->GetHomeOutputDirectory();
+  cmakeFiles += cmake::GetCMakeFilesDirectory();
+  if (!this->GlobVerificationManager->SaveVerificationScript(cmakeFiles)) {
+    cmSystemTools::Error("Unable to write the glob verification script.");
+    return -1;
+  }
   this->GlobalGenerator->Generate();
   if (!this->GraphVizFile.empty()) {
     std::cout << "Generate graphviz: " << this->GraphVizFile << std::endl;
@@ -2002,6 +2024,22 @@ int cmake::CheckBuildSystem()
     }
   }
 
+  // Let the globs given CONFIGURE_DEPENDS touch their stamp file, which
+  // is one of the dependencies, if any result changed.
+  if (const char* verifyStr =
+        mf->GetDefinition("CMAKE_MAKEFILE_VERIFY_GLOBS")) {
+    std::string const verify = verifyStr;
+    if (!mf->ReadListFile(verify.c_str()) ||
+        cmSystemTools::GetErrorOccuredFlag()) {
+      if (verbose) {
+        std::ostringstream msg;
+        msg << "Re-run cmake error reading : " << verify << "\n";
+        cmSystemTools::Stdout(msg.str().c_str());
+      }
+      return 1;
+    }
+  }
+
   // Get the set of dependencies and outputs.
   std::vector<std::string> depends;
   std::vector<std::string> outputs;
@@ -23,6 +23,9 @@ class cmExternalMakefileProjectGeneratorFactory;
 class cmFileTimeComparison;
 class cmGlobalGenerator;
 class cmGlobalGeneratorFactory;
+class cmGlobVerificationManager;
+class cmInstallHashCache;
+class cmInstallQueue;
 class cmMakefile;
 class cmMessenger;
 class cmState;
@@ -325,6 +328,27 @@ public:
    */
   cmFileTimeComparison* GetFileComparison() { return this->FileComparison; }
 
+  /**
+   * Get the queue of deferred file installations
+   */
+  cmInstallQueue* GetInstallQueue() { return this->InstallQueue; }
+
+  /**
+   * Get the content hashes of installed files
+   */
+  cmInstallHashCache* GetInstallHashCache()
+  {
+    return this->InstallHashCache;
+  }
+
+  /**
+   * Get the globs whose results the build system re-checks
+   */
+  cmGlobVerificationManager* GetGlobVerificationManager()
+  {
+    return this->GlobVerificationManager;
+  }
+
   // Do we want debug output during the cmake run.
   bool GetDebugOutput() { return this->DebugOutput; }
   void SetDebugOutputOn(bool b) { this->DebugOutput = b; }
@@ -502,6 +526,9 @@ private:
   bool ClearBuildSystem;
   bool DebugTryCompile;
   cmFileTimeComparison* FileComparison;
+  cmInstallQueue* InstallQueue;
+  cmInstallHashCache* InstallHashCache;
+  cmGlobVerificationManager* GlobVerificationManager;
   std::string GraphVizFile;
   InstalledFilesMap InstalledFiles;
 
@@ -4,6 +4,7 @@
 
 #include "cmAlgorithms.h"
 #include "cmGlobalGenerator.h"
+#include "cmInstallQueue.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #include "cmQtAutoGenerators.h"
@@ -12,6 +13,7 @@
 #include "cmSystemTools.h"
 #include "cmUtils.hxx"
 #include "cmVersion.h"
+#include "cmWorkerPool.h"
 #include "cm_auto_ptr.hxx"
 #include "cmake.h"
 
@@ -39,6 +41,7 @@
 #include "cmsys/Terminal.h"
 #include <algorithm>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
@@ -107,6 +110,9 @@ void CMakeCommandUsage(const char* program)
     << "  time command [args...]    - run command and return elapsed time\n"
     << "  touch file                - touch a file.\n"
     << "  touch_nocreate file       - touch a file but do not create it.\n"
+    << "File lists of copy, copy_if_different, *sum, remove, touch and the "
+       "rpath commands may use @<file> to read names from <file>, one per "
+       "line.\n"
 #if defined(_WIN32) && !defined(__CYGWIN__)
     << "Available on Windows only:\n"
     << "  delete_regv key           - delete registry value\n"
@@ -117,7 +123,10 @@ void CMakeCommandUsage(const char* program)
     << "  write_regv key value      - write registry value\n"
 #else
     << "Available on UNIX only:\n"
+    << "  change_rpath old new <file>...\n"
+    << "                            - change the RPATH of ELF files\n"
     << "  create_symlink old new    - create a symbolic link new -> old\n"
+    << "  remove_rpath <file>...    - remove the RPATH of ELF files\n"
 #endif
     ;
   /* clang-format on */
@@ -161,54 +170,246 @@ static bool cmTarFilesFrom(std::string const& file,
   return true;
 }
 
+// Append the arguments in [argBeg, argEnd) to files, replacing each
+// "@<file>" naming an existing response file with its non-empty lines.
+// Like compiler drivers, an "@" argument that names no file is literal.
+static bool cmcmdExpandResponseFiles(
+  std::vector<std::string>::const_iterator argBeg,
+  std::vector<std::string>::const_iterator argEnd,
+  std::vector<std::string>& files)
+{
+  for (; argBeg != argEnd; ++argBeg) {
+    std::string const& arg = *argBeg;
+    if (arg.size() < 2 || arg[0] != '@' ||
+        !cmSystemTools::FileExists(arg.c_str() + 1, true)) {
+      files.push_back(arg);
+      continue;
+    }
+    cmsys::ifstream fin(arg.c_str() + 1);
+    if (!fin) {
+      std::cerr << "Error: cannot read response file \"" << arg.substr(1)
+                << "\".\n";
+      return false;
+    }
+    std::string line;
+    while (cmSystemTools::GetLineFromStream(fin, line)) {
+      if (!line.empty()) {
+        files.push_back(line);
+      }
+    }
+  }
+  return true;
+}
+
+namespace {
+// Copy the sources that end up at the same path one after another, in
+// the order given, so the last one wins as it does without threads.
+class cmcmdCopyJob : public cmWorkerPool::Job
+{
+public:
+  cmcmdCopyJob(std::vector<std::string> const& sources,
+               std::string const& destination, bool ifDifferent,
+               std::vector<char>& success)
+    : Sources(sources)
+    , Destination(destination)
+    , IfDifferent(ifDifferent)
+    , Success(success)
+  {
+  }
+
+  void Process() CM_OVERRIDE
+  {
+    for (std::vector<size_t>::const_iterator si = this->Indices.begin();
+         si != this->Indices.end(); ++si) {
+      std::string const& source = this->Sources[*si];
+      this->Success[*si] = this->IfDifferent
+        ? cmSystemTools::CopyFileIfDifferent(source.c_str(),
+                                             this->Destination.c_str())
+        : cmSystemTools::cmCopyFile(source.c_str(),
+                                    this->Destination.c_str());
+    }
+  }
+
+  std::vector<size_t> Indices;
+
+private:
+  std::vector<std::string> const& Sources;
+  std::string const& Destination;
+  bool const IfDifferent;
+  std::vector<char>& Success;
+};
+
+class cmcmdRemoveJob : public cmWorkerPool::Job
+{
+public:
+  cmcmdRemoveJob(std::string const& file, bool force)
+    : File(file)
+    , Force(force)
+    , Success(false)
+  {
+  }
+
+  void Process() CM_OVERRIDE
+  {
+    // Complain if the file could not be removed, still exists,
+    // and the -f option was not given.
+    this->Success = cmSystemTools::RemoveFile(this->File) || this->Force ||
+      !cmSystemTools::FileExists(this->File.c_str());
+  }
+
+  std::string const& File;
+  bool const Force;
+  bool Success;
+};
+
+class cmcmdTouchJob : public cmWorkerPool::Job
+{
+public:
+  cmcmdTouchJob(std::string const& file, bool create)
+    : File(file)
+    , Create(create)
+    , Success(false)
+  {
+  }
+
+  void Process() CM_OVERRIDE
+  {
+    this->Success = cmSystemTools::Touch(this->File, this->Create);
+  }
+
+  std::string const& File;
+  bool const Create;
+  bool Success;
+};
+}
+
+// Run the jobs on a worker pool.  The caller reports the results in
+// job order afterwards so the output does not depend on scheduling.
+template <typename T>
+static void cmcmdProcessJobs(std::vector<T*> const& jobs)
+{
+  std::vector<cmWorkerPool::Job*> pending(jobs.begin(), jobs.end());
+  cmWorkerPool pool;
+  pool.Process(pending);
+}
+
+static int cmcmdCopyFiles(std::vector<std::string>& args, bool ifDifferent)
+{
+  char const* command = ifDifferent ? "copy_if_different" : "copy";
+  std::string const& destination = args.back();
+  std::vector<std::string> files;
+  if (!cmcmdExpandResponseFiles(args.begin() + 2, args.end() - 1, files)) {
+    return 1;
+  }
+
+  // If multiple source files specified,
+  // then destination must be directory
+  if ((files.size() > 1) && (!cmSystemTools::FileIsDirectory(destination))) {
+    std::cerr << "Error: Target (for " << command << " command) \""
+              << destination << "\" is not a directory.\n";
+    return 1;
+  }
+
+  // Group the sources by the path they are copied to.
+  bool const toDirectory = cmSystemTools::FileIsDirectory(destination);
+  std::vector<char> success(files.size(), 0);
+  std::map<std::string, cmcmdCopyJob*> targets;
+  std::vector<cmcmdCopyJob*> jobs;
+  for (size_t i = 0; i < files.size(); ++i) {
+    std::string target = destination;
+    if (toDirectory) {
+      target += "/";
+      target += cmSystemTools::GetFilenameName(files[i]);
+    }
+    cmcmdCopyJob*& job = targets[cmSystemTools::CollapseFullPath(target)];
+    if (!job) {
+      job = new cmcmdCopyJob(files, destination, ifDifferent, success);
+      jobs.push_back(job);
+    }
+    job->Indices.push_back(i);
+  }
+  cmcmdProcessJobs(jobs);
+  cmDeleteAll(jobs);
+
+  // If error occurs we want to continue copying next files.
+  bool return_value = false;
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (!success[i]) {
+      if (ifDifferent) {
+        std::cerr << "Error copying file (if different) from \"" << files[i]
+                  << "\" to \"" << destination << "\".\n";
+      } else {
+        std::cerr << "Error copying file \"" << files[i] << "\" to \""
+                  << destination << "\".\n";
+      }
+      return_value = true;
+    }
+  }
+  return return_value;
+}
+
+static int cmcmdTouchFiles(std::vector<std::string>& args, bool create)
+{
+  std::vector<std::string> files;
+  if (!cmcmdExpandResponseFiles(args.begin() + 2, args.end(), files)) {
+    return 1;
+  }
+  std::vector<cmcmdTouchJob*> jobs;
+  for (std::vector<std::string>::const_iterator fi = files.begin();
+       fi != files.end(); ++fi) {
+    jobs.push_back(new cmcmdTouchJob(*fi, create));
+  }
+  cmcmdProcessJobs(jobs);
+
+  int result = 0;
+  for (std::vector<cmcmdTouchJob*>::const_iterator ji = jobs.begin();
+       ji != jobs.end(); ++ji) {
+    if (!(*ji)->Success) {
+      result = 1;
+    }
+  }
+  cmDeleteAll(jobs);
+  return result;
+}
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+static int cmcmdEditRPaths(std::vector<std::string>& args, bool remove)
+{
+  std::vector<std::string>::const_iterator first = args.begin() + 2;
+  std::string oldRPath;
+  std::string newRPath;
+  if (!remove) {
+    oldRPath = args[2];
+    newRPath = args[3];
+    first += 2;
+  }
+  std::vector<std::string> files;
+  if (!cmcmdExpandResponseFiles(first, args.end(), files)) {
+    return 1;
+  }
+  std::vector<std::string> messages;
+  std::string error;
+  if (!cmInstallQueue::EditRPaths(files, remove, oldRPath, newRPath, 0,
+                                  messages, error)) {
+    std::cerr << error << "\n";
+    return 1;
+  }
+  return 0;
+}
+#endif
+
 int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
 {
   // IF YOU ADD A NEW COMMAND, DOCUMENT IT ABOVE and in cmakemain.cxx
   if (args.size() > 1) {
     // Copy file
     if (args[1] == "copy" && args.size() > 3) {
-      // If multiple source files specified,
-      // then destination must be directory
-      if ((args.size() > 4) &&
-          (!cmSystemTools::FileIsDirectory(args[args.size() - 1]))) {
-        std::cerr << "Error: Target (for copy command) \""
-                  << args[args.size() - 1] << "\" is not a directory.\n";
-        return 1;
-      }
-      // If error occurs we want to continue copying next files.
-      bool return_value = false;
-      for (std::string::size_type cc = 2; cc < args.size() - 1; cc++) {
-        if (!cmSystemTools::cmCopyFile(args[cc].c_str(),
-                                       args[args.size() - 1].c_str())) {
-          std::cerr << "Error copying file \"" << args[cc] << "\" to \""
-                    << args[args.size() - 1] << "\".\n";
-          return_value = true;
-        }
-      }
-      return return_value;
+      return cmcmdCopyFiles(args, false);
     }
 
     // Copy file if different.
     if (args[1] == "copy_if_different" && args.size() > 3) {
-      // If multiple source files specified,
-      // then destination must be directory
-      if ((args.size() > 4) &&
-          (!cmSystemTools::FileIsDirectory(args[args.size() - 1]))) {
-        std::cerr << "Error: Target (for copy_if_different command) \""
-                  << args[args.size() - 1] << "\" is not a directory.\n";
-        return 1;
-      }
-      // If error occurs we want to continue copying next files.
-      bool return_value = false;
-      for (std::string::size_type cc = 2; cc < args.size() - 1; cc++) {
-        if (!cmSystemTools::CopyFileIfDifferent(
-              args[cc].c_str(), args[args.size() - 1].c_str())) {
-          std::cerr << "Error copying file (if different) from \"" << args[cc]
-                    << "\" to \"" << args[args.size() - 1] << "\".\n";
-          return_value = true;
-        }
-      }
-      return return_value;
+      return cmcmdCopyFiles(args, true);
     }
 
     // Copy directory content
@@ -546,42 +747,41 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
 
     // Remove file
     if (args[1] == "remove" && args.size() > 2) {
+      std::vector<std::string> files;
+      if (!cmcmdExpandResponseFiles(args.begin() + 2, args.end(), files)) {
+        return 1;
+      }
+      // Stop at the first file that cannot be removed before -f is
+      // given.  The files after -f cannot fail, so remove them together.
       bool force = false;
-      for (std::string::size_type cc = 2; cc < args.size(); cc++) {
-        if (args[cc] == "\\-f" || args[cc] == "-f") {
+      std::vector<cmcmdRemoveJob*> jobs;
+      for (std::vector<std::string>::const_iterator fi = files.begin();
+           fi != files.end(); ++fi) {
+        if (*fi == "\\-f" || *fi == "-f") {
           force = true;
+        } else if (force) {
+          jobs.push_back(new cmcmdRemoveJob(*fi, force));
         } else {
-          // Complain if the file could not be removed, still exists,
-          // and the -f option was not given.
-          if (!cmSystemTools::RemoveFile(args[cc]) && !force &&
-              cmSystemTools::FileExists(args[cc].c_str())) {
+          cmcmdRemoveJob job(*fi, force);
+          job.Process();
+          if (!job.Success) {
             return 1;
           }
         }
       }
+      cmcmdProcessJobs(jobs);
+      cmDeleteAll(jobs);
       return 0;
     }
 
     // Touch file
     if (args[1] == "touch" && args.size() > 2) {
-      for (std::string::size_type cc = 2; cc < args.size(); cc++) {
-        if (!cmSystemTools::Touch(args[cc], true)) {
-          return 1;
-        }
-      }
-      return 0;
+      return cmcmdTouchFiles(args, true);
     }
 
     // Touch file
     if (args[1] == "touch_nocreate" && args.size() > 2) {
-      for (std::string::size_type cc = 2; cc < args.size(); cc++) {
-        // Complain if the file could not be removed, still exists,
-        // and the -f option was not given.
-        if (!cmSystemTools::Touch(args[cc], false)) {
-          return 1;
-        }
-      }
-      return 0;
+      return cmcmdTouchFiles(args, false);
     }
 
     // capabilities
@@ -756,6 +956,16 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
       return 0;
     }
 
+#if !defined(_WIN32) || defined(__CYGWIN__)
+    // Command to change or remove the RPATH of ELF binaries.
+    if (args[1] == "change_rpath" && args.size() > 4) {
+      return cmcmdEditRPaths(args, false);
+    }
+    if (args[1] == "remove_rpath" && args.size() > 2) {
+      return cmcmdEditRPaths(args, true);
+    }
+#endif
+
     // Internal CMake shared library support.
     if (args[1] == "cmake_symlink_library" && args.size() == 5) {
       return cmcmd::SymlinkLibrary(args);
@@ -899,6 +1109,7 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
       std::vector<std::string> files;
       std::string mtime;
       std::string format;
+      unsigned long threads = 1;
       bool doing_options = true;
       for (std::string::size_type cc = 4; cc < args.size(); cc++) {
         std::string const& arg = args[cc];
@@ -923,6 +1134,14 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
                                    format.c_str());
               return 1;
             }
+          } else if (cmHasLiteralPrefix(arg, "--threads=")) {
+            std::string const& value = arg.substr(10);
+            if (value.find_first_not_of("0123456789") != std::string::npos ||
+                !cmSystemTools::StringToULong(value.c_str(), &threads)) {
+              cmSystemTools::Error("Invalid -E tar --threads= argument: ",
+                                   value.c_str());
+              return 1;
+            }
           } else {
             cmSystemTools::Error("Unknown option to -E tar: ", arg.c_str());
             return 1;
@@ -968,7 +1187,8 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
         }
       } else if (flags.find_first_of('c') != std::string::npos) {
         if (!cmSystemTools::CreateTar(outFile.c_str(), files, compress,
-                                      verbose, mtime, format)) {
+                                      verbose, mtime, format,
+                                      static_cast<unsigned int>(threads))) {
           cmSystemTools::Error("Problem creating tar: ", outFile.c_str());
           return 1;
         }
@@ -1090,23 +1310,34 @@ int cmcmd::HashSumFile(std::vector<std::string>& args, cmCryptoHash::Algo algo)
   if (args.size() < 3) {
     return -1;
   }
-  int retval = 0;
+  std::vector<std::string> files;
+  if (!cmcmdExpandResponseFiles(args.begin() + 2, args.end(), files)) {
+    return 1;
+  }
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  std::vector<std::string> const values =
+    cmCryptoHash::HashFiles(algo, files);
+#else
+  std::vector<std::string> values;
+  for (std::vector<std::string>::const_iterator fi = files.begin();
+       fi != files.end(); ++fi) {
+    values.push_back(cmSystemTools::ComputeFileHash(*fi, algo));
+  }
+#endif
 
-  for (std::string::size_type cc = 2; cc < args.size(); cc++) {
-    const char* filename = args[cc].c_str();
-    // Cannot compute sum of a directory
-    if (cmSystemTools::FileIsDirectory(filename)) {
-      std::cerr << "Error: " << filename << " is a directory" << std::endl;
+  int retval = 0;
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (!values[i].empty()) {
+      std::cout << values[i] << "  " << files[i] << std::endl;
+    } else if (cmSystemTools::FileIsDirectory(files[i])) {
+      // Cannot compute sum of a directory
+      std::cerr << "Error: " << files[i] << " is a directory" << std::endl;
       retval++;
     } else {
-      std::string value = cmSystemTools::ComputeFileHash(filename, algo);
-      if (value.empty()) {
-        // To mimic "md5sum/shasum" behavior in a shell:
-        std::cerr << filename << ": No such file or directory" << std::endl;
-        retval++;
-      } else {
-        std::cout << value << "  " << filename << std::endl;
-      }
+      // To mimic "md5sum/shasum" behavior in a shell:
+      std::cerr << files[i] << ": No such file or directory" << std::endl;
+      retval++;
     }
   }
   return retval;
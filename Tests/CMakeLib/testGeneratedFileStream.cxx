@@ -3,13 +3,47 @@
 #include "cmGeneratedFileStream.h"
 #include "cmSystemTools.h"
 
+#include "cmsys/FStream.hxx"
 #include <iostream>
+#include <iterator>
 #include <string>
 
 #define cmFailed(m1, m2)                                                      \
   std::cout << "FAILED: " << (m1) << (m2) << "\n";                            \
   failed = 1
 
+static std::string readFile(std::string const& file)
+{
+  cmsys::ifstream fin(file.c_str(), std::ios::in | std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(fin),
+                     std::istreambuf_iterator<char>());
+}
+
+// Write content with copy-if-different and check whether the file was
+// replaced and holds the content afterwards.
+static bool testCopyIfDifferent(std::string const& file,
+                                std::string const& content, bool replace)
+{
+  cmGeneratedFileStream gm(file.c_str());
+  gm.SetCopyIfDifferent(true);
+  gm << content;
+  bool const replaced = gm.Close();
+  if (replaced != replace) {
+    std::cout << "FAILED: copy-if-different " << (replace ? "kept" : "replaced")
+              << " " << file << " (" << content.size() << " bytes)\n";
+    return false;
+  }
+  if (cmSystemTools::FileExists((file + ".tmp").c_str())) {
+    std::cout << "FAILED: copy-if-different left " << file << ".tmp\n";
+    return false;
+  }
+  if (readFile(file) != content) {
+    std::cout << "FAILED: copy-if-different content of " << file << "\n";
+    return false;
+  }
+  return true;
+}
+
 int testGeneratedFileStream(int /*unused*/, char* /*unused*/ [])
 {
   int failed = 0;
@@ -75,6 +109,26 @@ int testGeneratedFileStream(int /*unused*/, char* /*unused*/ [])
     cmFailed("Something wrong with cmGeneratedFileStream. Cannot find file: ",
              file1.c_str());
   }
+
+  // Content larger than the internal buffer, differing in a later chunk.
+  std::string file5 = "generatedFile5";
+  std::string big(3 << 20, 'x');
+  std::string bigChanged = big;
+  bigChanged[bigChanged.size() - 10] = 'y';
+  if (!testCopyIfDifferent(file5, "content", true) ||
+      !testCopyIfDifferent(file5, "content", false) ||
+      !testCopyIfDifferent(file5, "content longer", true) ||
+      !testCopyIfDifferent(file5, "content", true) ||
+      !testCopyIfDifferent(file5, "", true) ||
+      !testCopyIfDifferent(file5, "", false) ||
+      !testCopyIfDifferent(file5, big, true) ||
+      !testCopyIfDifferent(file5, big, false) ||
+      !testCopyIfDifferent(file5, bigChanged, true) ||
+      !testCopyIfDifferent(file5, bigChanged + "z", true)) {
+    failed = 1;
+  }
+  cmSystemTools::RemoveFile(file5);
+
   cmSystemTools::RemoveFile(file1);
   cmSystemTools::RemoveFile(file2);
   cmSystemTools::RemoveFile(file3);
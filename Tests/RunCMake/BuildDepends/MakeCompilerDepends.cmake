@@ -0,0 +1,14 @@
+enable_language(C)
+set(CMAKE_DEPENDS_USE_COMPILER ON)
+
+add_executable(main MakeCompilerDepends.c)
+target_include_directories(main PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+
+file(GENERATE OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/check-$<LOWER_CASE:$<CONFIG>>.cmake CONTENT "
+set(check_pairs
+  \"$<TARGET_FILE:main>|${CMAKE_CURRENT_BINARY_DIR}/MakeCompilerDepends.h\"
+  )
+set(check_exes
+  \"$<TARGET_FILE:main>\"
+  )
+")
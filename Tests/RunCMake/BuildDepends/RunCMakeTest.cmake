@@ -45,6 +45,7 @@ run_BuildDepends(Custom-Always)
 
 if(RunCMake_GENERATOR MATCHES "Make")
   run_BuildDepends(MakeCustomIncludes)
+  run_BuildDepends(MakeCompilerDepends)
   if(NOT "${RunCMake_BINARY_DIR}" STREQUAL "${RunCMake_SOURCE_DIR}")
     run_BuildDepends(MakeInProjectOnly)
   endif()
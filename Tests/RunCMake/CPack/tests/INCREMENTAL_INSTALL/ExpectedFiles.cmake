@@ -0,0 +1,8 @@
+set(EXPECTED_FILES_COUNT "1")
+set(EXPECTED_FILE_CONTENT_1_LIST
+  "/usr"
+  "/usr/bin"
+  "/usr/bin/incremental"
+  "/usr/share"
+  "/usr/share/CMakeLists.txt"
+  "/usr/share/changed.txt")
@@ -0,0 +1,5 @@
+function(get_test_prerequirements found_var config_file)
+  if(UNIX AND NOT APPLE) # limit test to ELF platforms with hard links
+    set(${found_var} true PARENT_SCOPE)
+  endif()
+endfunction()
@@ -0,0 +1,64 @@
+# Keep the files of the first run under other names.
+file(GLOB install_dir_ "${bin_dir}/_CPack_Packages/*/${GENERATOR_TYPE}/*/share")
+get_filename_component(install_dir_ "${install_dir_}" DIRECTORY)
+foreach(file_ share/CMakeLists.txt share/changed.txt bin/incremental)
+  get_filename_component(name_ "${file_}" NAME)
+  file(REMOVE "${bin_dir}/first_${name_}")
+  execute_process(COMMAND ln "${install_dir_}/${file_}" "${bin_dir}/first_${name_}"
+    RESULT_VARIABLE result_)
+  if(NOT result_ EQUAL 0)
+    message(FATAL_ERROR "Cannot link '${install_dir_}/${file_}'${output_error_message}")
+  endif()
+endforeach()
+
+# Change one file and the RPATH of the executable and package again.
+file(TIMESTAMP "${bin_dir}/incremental" built_)
+file(WRITE "${bin_dir}/changed.txt" "second\n")
+execute_process(COMMAND ${CMAKE_COMMAND} -DINCREMENTAL_RPATH=/run_2 .
+  WORKING_DIRECTORY "${bin_dir}"
+  OUTPUT_QUIET)
+execute_process(COMMAND ${CMAKE_CPACK_COMMAND}
+  WORKING_DIRECTORY "${bin_dir}"
+  RESULT_VARIABLE result_
+  OUTPUT_VARIABLE second_output_
+  ERROR_VARIABLE second_output_)
+if(NOT result_ EQUAL 0)
+  message(FATAL_ERROR "Second CPack run failed: '${second_output_}'")
+endif()
+file(TIMESTAMP "${bin_dir}/incremental" rebuilt_)
+if(NOT rebuilt_ STREQUAL built_)
+  message(FATAL_ERROR "The executable was relinked, so no copy was reused.")
+endif()
+
+# The unchanged file was linked to the copy of the first run.
+file(APPEND "${bin_dir}/first_CMakeLists.txt" "# reused\n")
+file(READ "${install_dir_}/share/CMakeLists.txt" content_)
+if(NOT content_ MATCHES "# reused\n$")
+  message(FATAL_ERROR "CMakeLists.txt was not reused: '${second_output_}'")
+endif()
+
+# The changed file was installed again, not written through the link.
+file(READ "${install_dir_}/share/changed.txt" content_)
+file(READ "${bin_dir}/first_changed.txt" first_content_)
+if(NOT content_ STREQUAL "second\n" OR NOT first_content_ STREQUAL "first\n")
+  message(FATAL_ERROR "changed.txt was not installed again: '${content_}' "
+    "and '${first_content_}' of the first run")
+endif()
+
+# The copy of the executable with the old RPATH was dropped.
+file(READ_ELF "${install_dir_}/bin/incremental"
+  RPATH rpath_ RUNPATH runpath_)
+file(READ_ELF "${bin_dir}/first_incremental"
+  RPATH first_rpath_ RUNPATH first_runpath_)
+string(APPEND rpath_ "${runpath_}")
+string(APPEND first_rpath_ "${first_runpath_}")
+if(NOT rpath_ STREQUAL "/run_2" OR NOT first_rpath_ STREQUAL "/run_1")
+  message(FATAL_ERROR "Unexpected RPATH '${rpath_}' of the executable and "
+    "'${first_rpath_}' of the first run")
+endif()
+
+# Nothing else of the first run is left.
+file(GLOB previous_ "${bin_dir}/_CPack_Packages/*/${GENERATOR_TYPE}.previous")
+if(previous_)
+  message(FATAL_ERROR "The previous install directory was not removed.")
+endif()
@@ -0,0 +1,17 @@
+set(CPACK_INCREMENTAL_INSTALL ON)
+
+# VerifyResult.cmake changes changed.txt and the RPATH of the executable
+# and runs CPack again, which must not overwrite the files here.
+if(NOT EXISTS "${CMAKE_CURRENT_BINARY_DIR}/changed.txt")
+  file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/changed.txt" "first\n")
+  file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/main.cpp" "int main() { return 0; }\n")
+endif()
+
+# Both runs give the build tree the same RPATH, so it is not relinked.
+set(INCREMENTAL_RPATH "/run_1" CACHE STRING "")
+add_executable(incremental "${CMAKE_CURRENT_BINARY_DIR}/main.cpp")
+set_target_properties(incremental PROPERTIES INSTALL_RPATH "${INCREMENTAL_RPATH}")
+
+install(TARGETS incremental DESTINATION bin)
+install(FILES CMakeLists.txt "${CMAKE_CURRENT_BINARY_DIR}/changed.txt"
+  DESTINATION share)
@@ -0,0 +1,7 @@
+set(EXPECTED_FILES_COUNT "3")
+
+foreach(file_no_ 1 2 3)
+  set(EXPECTED_FILE_${file_no_}_COMPONENT "pkg_${file_no_}")
+  set(EXPECTED_FILE_CONTENT_${file_no_}_LIST
+    "/usr;/usr/pkg_${file_no_};/usr/pkg_${file_no_}/CMakeLists.txt;/usr/pkg_${file_no_}/pkg_${file_no_}.txt")
+endforeach()
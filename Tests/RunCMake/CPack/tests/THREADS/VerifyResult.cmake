@@ -0,0 +1,21 @@
+# The packages were written concurrently; each must hold its own files.
+foreach(file_no_ 1 2 3)
+  set(pkg_ "pkg_${file_no_}")
+  if(GENERATOR_TYPE STREQUAL "DEB")
+    set(${pkg_}_md5sums
+      "^([0-9a-f]+  usr/${pkg_}/(CMakeLists|${pkg_})\\.txt\n)([0-9a-f]+  usr/${pkg_}/(CMakeLists|${pkg_})\\.txt\n)$")
+    verifyDebControl("${bin_dir}/${FOUND_FILE_${file_no_}}" "${pkg_}" "md5sums")
+  else()
+    file(REMOVE_RECURSE "${bin_dir}/extract_${pkg_}")
+    file(MAKE_DIRECTORY "${bin_dir}/extract_${pkg_}")
+    execute_process(COMMAND ${CMAKE_COMMAND} -E tar xf
+      "${bin_dir}/${FOUND_FILE_${file_no_}}"
+      WORKING_DIRECTORY "${bin_dir}/extract_${pkg_}"
+      RESULT_VARIABLE result_)
+    file(READ "${bin_dir}/extract_${pkg_}/${pkg_}/${pkg_}.txt" content_)
+    if(NOT result_ EQUAL 0 OR NOT content_ STREQUAL "${pkg_}\n")
+      message(FATAL_ERROR "Unexpected content of '${pkg_}.txt' in "
+        "'${FOUND_FILE_${file_no_}}': '${content_}'")
+    endif()
+  endif()
+endforeach()
@@ -0,0 +1,11 @@
+if(RunCMake_SUBTEST_SUFFIX STREQUAL "invalid")
+  set(CPACK_THREADS -1)
+else()
+  set(CPACK_THREADS 4)
+endif()
+
+foreach(component_ pkg_1 pkg_2 pkg_3)
+  file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/${component_}.txt" "${component_}\n")
+  install(FILES CMakeLists.txt "${CMAKE_CURRENT_BINARY_DIR}/${component_}.txt"
+    DESTINATION ${component_} COMPONENT ${component_})
+endforeach()
@@ -0,0 +1,4 @@
+# A failed copy must not remove the file it would have replaced.
+if(NOT EXISTS ${out}/keep/f1.txt)
+  set(RunCMake_TEST_FAILED "keep/f1.txt was removed by the failed copy")
+endif()
@@ -0,0 +1,5 @@
+# Files in /proc report no size but have content.
+file(READ ${out}/proc_version version)
+if(NOT version MATCHES "Linux")
+  set(RunCMake_TEST_FAILED "proc_version was copied without its content")
+endif()
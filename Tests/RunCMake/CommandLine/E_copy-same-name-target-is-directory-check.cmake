@@ -0,0 +1,5 @@
+# The last source copied to a path wins, as it does without threads.
+file(READ ${out}/same/f1.txt content)
+if(NOT content STREQUAL "other\n")
+  set(RunCMake_TEST_FAILED "same/f1.txt was not copied last from other/:\n  ${content}")
+endif()
@@ -0,0 +1,6 @@
+# Files after the one that cannot be removed are kept.
+if(EXISTS ${out}/remove/r1)
+  set(RunCMake_TEST_FAILED "remove/r1 was not removed")
+elseif(NOT EXISTS ${out}/remove/r2)
+  set(RunCMake_TEST_FAILED "remove/r2 was removed after the error")
+endif()
@@ -132,6 +132,30 @@ run_cmake_command(E_copy_if_different-three-source-files-target-is-directory
   ${CMAKE_COMMAND} -E copy_if_different ${in}/f1.txt ${in}/f2.txt ${in}/f3.txt ${out})
 run_cmake_command(E_copy_if_different-three-source-files-target-is-file
   ${CMAKE_COMMAND} -E copy_if_different ${in}/f1.txt ${in}/f2.txt ${in}/f3.txt ${out}/f1.txt)
+file(WRITE ${out}/files.list "${in}/f1.txt\n${in}/f2.txt\n\n${in}/f3.txt\n")
+file(MAKE_DIRECTORY ${out}/response)
+run_cmake_command(E_copy-response-file-target-is-directory
+  ${CMAKE_COMMAND} -E copy @${out}/files.list ${out}/response)
+run_cmake_command(E_copy-response-file-target-is-file
+  ${CMAKE_COMMAND} -E copy @${out}/files.list ${out}/f1.txt)
+file(WRITE ${out}/other/f1.txt "other\n")
+file(MAKE_DIRECTORY ${out}/same)
+run_cmake_command(E_copy-same-name-target-is-directory
+  ${CMAKE_COMMAND} -E copy ${in}/f1.txt ${out}/other/f1.txt ${in}/f2.txt
+  ${out}/same)
+file(WRITE ${out}/keep/f1.txt "keep\n")
+run_cmake_command(E_copy-missing-source-keeps-target
+  ${CMAKE_COMMAND} -E copy ${in}/not_existing_file.bad ${out}/keep/f1.txt)
+if(CMAKE_HOST_SYSTEM_NAME STREQUAL "Linux" AND EXISTS /proc/version)
+  run_cmake_command(E_copy-proc-file
+    ${CMAKE_COMMAND} -E copy /proc/version ${out}/proc_version)
+endif()
+file(WRITE ${out}/remove/r1 "")
+file(WRITE ${out}/remove/r2 "")
+file(MAKE_DIRECTORY ${out}/remove/dir)
+run_cmake_command(E_remove-stop-at-first-error
+  ${CMAKE_COMMAND} -E remove ${out}/remove/r1 ${out}/remove/dir
+  ${out}/remove/r2)
 unset(in)
 unset(out)
 
@@ -189,6 +213,9 @@ run_cmake_command(E_sha512sum-no-file ${CMAKE_COMMAND} -E sha512sum nonexisting)
 file(WRITE "${RunCMake_BINARY_DIR}/dummy" "dummy")
 run_cmake_command(E_md5sum ${CMAKE_COMMAND} -E md5sum ../dummy)
 run_cmake_command(E_md5sum-mixed ${CMAKE_COMMAND} -E md5sum . ../dummy nonexisting)
+file(WRITE "${RunCMake_BINARY_DIR}/dummy.list" "../dummy\n.\n../dummy\n")
+run_cmake_command(E_md5sum-response-file ${CMAKE_COMMAND} -E md5sum ../dummy @../dummy.list)
+file(REMOVE "${RunCMake_BINARY_DIR}/dummy.list")
 run_cmake_command(E_sha1sum ${CMAKE_COMMAND} -E sha1sum ../dummy)
 run_cmake_command(E_sha224sum ${CMAKE_COMMAND} -E sha224sum ../dummy)
 run_cmake_command(E_sha256sum ${CMAKE_COMMAND} -E sha256sum ../dummy)
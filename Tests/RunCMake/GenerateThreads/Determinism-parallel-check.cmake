@@ -0,0 +1,19 @@
+set(serial_dir "${RunCMake_TEST_BINARY_DIR}-serial")
+file(GLOB_RECURSE files RELATIVE "${serial_dir}"
+  "${serial_dir}/*.make"
+  "${serial_dir}/*.ninja"
+  "${serial_dir}/Makefile"
+  "${serial_dir}/Makefile2"
+  )
+if(NOT files)
+  set(RunCMake_TEST_FAILED "No generated files found in\n  ${serial_dir}")
+  return()
+endif()
+foreach(f IN LISTS files)
+  file(READ "${serial_dir}/${f}" serial)
+  file(READ "${RunCMake_TEST_BINARY_DIR}/${f}" parallel)
+  if(NOT serial STREQUAL parallel)
+    string(APPEND RunCMake_TEST_FAILED
+      "Generated file differs between serial and parallel runs:\n  ${f}\n")
+  endif()
+endforeach()
@@ -0,0 +1,15 @@
+set(sources
+  a.c
+  sub/a.c
+  ${CMAKE_CURRENT_BINARY_DIR}/gen/a.c
+  ${CMAKE_CURRENT_SOURCE_DIR}/../ObjectLibrary/a.c
+  )
+set_property(SOURCE ${CMAKE_CURRENT_BINARY_DIR}/gen/a.c PROPERTY GENERATED 1)
+set_property(SOURCE sub/a.c PROPERTY KEEP_EXTENSION 1)
+
+foreach(i RANGE 1 16)
+  add_library(static${i} STATIC ${sources})
+  add_library(object${i} OBJECT ${sources})
+  add_executable(exe${i} $<TARGET_OBJECTS:object${i}>)
+endforeach()
+set_property(TARGET object1 PROPERTY CUDA_PTX_COMPILATION ON)
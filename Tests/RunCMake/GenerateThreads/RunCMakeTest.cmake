@@ -0,0 +1,20 @@
+include(RunCMake)
+
+function(run_Determinism)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Determinism-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+
+  # The first configuration run may differ from later runs, so compare
+  # two runs after it.
+  run_cmake(Determinism)
+  run_cmake_command(Determinism-serial
+    ${CMAKE_COMMAND} -DCMAKE_GENERATE_THREADS=1 .)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}-serial")
+  file(COPY "${RunCMake_TEST_BINARY_DIR}/"
+    DESTINATION "${RunCMake_TEST_BINARY_DIR}-serial")
+  run_cmake_command(Determinism-parallel
+    ${CMAKE_COMMAND} -DCMAKE_GENERATE_THREADS=8 .)
+endfunction()
+run_Determinism()
@@ -0,0 +1,9 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/rules.ninja" rules_file)
+file(READ "${RunCMake_TEST_BINARY_DIR}/build.ninja" build_file)
+if(NOT rules_file MATCHES "rule C_COMPILER__greeting\n[^\n]*\n[^\n]*\n  command = [^\n]*TARGET_DEF \\$DEFINES [^\n]*TargetInclude")
+  set(RunCMake_TEST_FAILED "rules.ninja does not spell out the target definitions and include directories in the compile rule.")
+elseif(NOT build_file MATCHES "\n  DEFINES = [-/]DSOURCE_DEF\n")
+  set(RunCMake_TEST_FAILED "build.ninja does not bind only the source definitions.")
+elseif(build_file MATCHES "TARGET_DEF|TargetInclude")
+  set(RunCMake_TEST_FAILED "build.ninja repeats the target-wide compile flags.")
+endif()
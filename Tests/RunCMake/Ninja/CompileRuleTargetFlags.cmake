@@ -0,0 +1,5 @@
+enable_language(C)
+add_library(greeting STATIC greeting.c)
+target_compile_definitions(greeting PRIVATE TARGET_DEF)
+target_include_directories(greeting PRIVATE TargetInclude)
+set_property(SOURCE greeting.c PROPERTY COMPILE_DEFINITIONS SOURCE_DEF)
@@ -0,0 +1,3 @@
+enable_language(C)
+set(CMAKE_NINJA_FOCUS_TARGETS hello missing)
+add_executable(hello hello.c)
@@ -0,0 +1,10 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/build.ninja" build_file)
+if(NOT build_file MATCHES "\nbuild hello: ")
+  set(RunCMake_TEST_FAILED "build.ninja does not contain the focus target.")
+elseif(NOT build_file MATCHES "\nbuild greeting: ")
+  set(RunCMake_TEST_FAILED "build.ninja does not contain a dependency of the focus target.")
+elseif(build_file MATCHES "hello2|greeting2")
+  set(RunCMake_TEST_FAILED "build.ninja contains targets outside of the focus.")
+elseif(NOT build_file MATCHES "\nbuild rebuild_cache: ")
+  set(RunCMake_TEST_FAILED "build.ninja does not contain the global targets.")
+endif()
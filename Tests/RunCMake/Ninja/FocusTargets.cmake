@@ -0,0 +1,9 @@
+enable_language(C)
+set(CMAKE_NINJA_FOCUS_TARGETS hello)
+include_directories(${CMAKE_CURRENT_SOURCE_DIR})
+add_library(greeting STATIC greeting.c)
+add_library(greeting2 STATIC greeting2.c)
+add_executable(hello hello_with_greeting.c)
+target_link_libraries(hello greeting)
+add_executable(hello2 hello_with_two_greetings.c)
+target_link_libraries(hello2 greeting greeting2)
@@ -39,6 +39,9 @@ run_CMP0058(NEW-no)
 run_CMP0058(NEW-by)
 
 run_cmake(CustomCommandDepfile)
+run_cmake(CompileRuleTargetFlags)
+run_cmake(FocusTargets)
+run_cmake(FocusTargets-NoTarget)
 
 function(run_CommandConcat)
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/CommandConcat-build)
@@ -81,6 +84,16 @@ function(run_SubDir)
 endfunction()
 run_SubDir()
 
+function(run_SubninjaPerDirectory)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/SubninjaPerDirectory-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  run_cmake(SubninjaPerDirectory)
+  run_cmake_command(SubninjaPerDirectory-build ${CMAKE_COMMAND} --build . --target SubDirSourceInAll)
+endfunction()
+run_SubninjaPerDirectory()
+
 function(run_ninja dir)
   execute_process(
     COMMAND "${RunCMake_MAKE_PROGRAM}" ${ARGN}
@@ -0,0 +1,12 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/build.ninja" build_file)
+string(FIND "${build_file}" "\nsubninja " subninja_pos)
+string(FIND "${build_file}" "\ndefault " default_pos)
+if(NOT build_file MATCHES "\nsubninja CMakeFiles/build\\.ninja\nsubninja SubDirBinary/CMakeFiles/build\\.ninja\n")
+  set(RunCMake_TEST_FAILED "build.ninja does not include the directory build files.")
+elseif(subninja_pos GREATER default_pos)
+  set(RunCMake_TEST_FAILED "build.ninja includes the directory build files after the default statement.")
+elseif(build_file MATCHES "\nbuild SubDirBinary/CMakeFiles/SubDirSourceInAll")
+  set(RunCMake_TEST_FAILED "build.ninja contains build statements of a subdirectory.")
+elseif(NOT build_file MATCHES "\nbuild build\\.ninja[^:\n]* CMakeFiles/build\\.ninja SubDirBinary/CMakeFiles/build\\.ninja: RERUN_CMAKE")
+  set(RunCMake_TEST_FAILED "build.ninja does not regenerate the directory build files.")
+endif()
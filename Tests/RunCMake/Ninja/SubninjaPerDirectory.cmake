@@ -0,0 +1,2 @@
+set(CMAKE_NINJA_SUBNINJA_PER_DIRECTORY ON)
+add_subdirectory(SubDirSource SubDirBinary)
@@ -0,0 +1,15 @@
+if(EXISTS "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/exe.dir/link.txt")
+  file(READ "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/exe.dir/link.txt" link)
+else()
+  file(READ "${RunCMake_TEST_BINARY_DIR}/build.ninja" link)
+endif()
+string(REGEX MATCHALL "${RunCMake_TEST_BINARY_DIR}/d[0-9]+" actual "${link}")
+string(REPLACE "${RunCMake_TEST_BINARY_DIR}/" "" actual "${actual}")
+set(expect "")
+foreach(d RANGE 19 0 -1)
+  list(APPEND expect d${d})
+endforeach()
+if(NOT actual STREQUAL expect)
+  set(RunCMake_TEST_FAILED
+    "Runtime path directories are\n  ${actual}\nbut expected\n  ${expect}")
+endif()
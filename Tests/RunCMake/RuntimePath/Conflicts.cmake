@@ -0,0 +1,24 @@
+enable_language(C)
+
+# Each library has a file of the same name in the preceding directory,
+# so every directory must come before the one preceding it.
+set(dirs "")
+foreach(i RANGE 1 40)
+  math(EXPR d "${i} % 20")
+  set(dir ${CMAKE_CURRENT_BINARY_DIR}/d${d})
+  file(WRITE ${dir}/libL${i}.so "L${i}\n")
+  if(d GREATER 0)
+    math(EXPR p "${d} - 1")
+    file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/d${p}/libL${i}.so "decoy\n")
+  endif()
+  add_library(L${i} SHARED IMPORTED)
+  set_property(TARGET L${i} PROPERTY IMPORTED_LOCATION ${dir}/libL${i}.so)
+  # Use a known soname for half of the libraries.
+  if(i GREATER 20)
+    set_property(TARGET L${i} PROPERTY IMPORTED_SONAME libL${i}.so)
+  endif()
+  list(APPEND libs L${i})
+endforeach()
+
+add_executable(exe main.c)
+target_link_libraries(exe ${libs})
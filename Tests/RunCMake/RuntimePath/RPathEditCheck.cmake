@@ -0,0 +1,34 @@
+# Edit several copies of the executable at once.
+file(MAKE_DIRECTORY ${dir}/edit)
+foreach(n 1 2 3)
+  file(COPY ${dir}/bin/exe DESTINATION ${dir}/edit/${n})
+endforeach()
+# A file listed again, under any name, is edited once.
+file(RPATH_CHANGE FILE ${dir}/edit/1/exe ${dir}/edit/2/exe ${dir}/edit/1/exe
+  ${dir}/edit/../edit/2/exe
+  OLD_RPATH "${dir}/libAlways" NEW_RPATH "/new/path")
+# A file listed again through a link is edited once too.
+file(REMOVE ${dir}/edit/link)
+execute_process(COMMAND ${CMAKE_COMMAND} -E create_symlink
+  ${dir}/edit/3/exe ${dir}/edit/link)
+execute_process(COMMAND ${CMAKE_COMMAND} -E remove_rpath
+  ${dir}/edit/2/exe ${dir}/edit/3/exe ${dir}/edit/link ${dir}/edit/3/exe
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "cmake -E remove_rpath failed: ${result}")
+endif()
+
+file(READ_ELF ${dir}/edit/1/exe RPATH rpath RUNPATH runpath)
+if(NOT "${rpath}${runpath}" MATCHES "^/new/path(;|$)")
+  message(FATAL_ERROR "RPATH_CHANGE did not set the new path:\n"
+    "  ${rpath}${runpath}")
+endif()
+foreach(n 2 3)
+  unset(rpath)
+  unset(runpath)
+  file(READ_ELF ${dir}/edit/${n}/exe RPATH rpath RUNPATH runpath)
+  if(NOT "${rpath}${runpath}" STREQUAL "")
+    message(FATAL_ERROR "remove_rpath left a path in edit/${n}/exe:\n"
+      "  ${rpath}${runpath}")
+  endif()
+endforeach()
@@ -14,5 +14,8 @@ function(run_SymlinkImplicit)
   run_cmake_command(SymlinkImplicit-build ${CMAKE_COMMAND} --build . --config Debug)
   run_cmake_command(SymlinkImplicitCheck
     ${CMAKE_COMMAND} -Ddir=${RunCMake_TEST_BINARY_DIR} -P ${RunCMake_SOURCE_DIR}/SymlinkImplicitCheck.cmake)
+  run_cmake_command(RPathEditCheck
+    ${CMAKE_COMMAND} -Ddir=${RunCMake_TEST_BINARY_DIR} -P ${RunCMake_SOURCE_DIR}/RPathEditCheck.cmake)
 endfunction()
 run_SymlinkImplicit()
+run_cmake(Conflicts)
@@ -0,0 +1,4 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/glob.txt" content)
+if(NOT content STREQUAL "first.txt")
+  set(RunCMake_TEST_FAILED "Expected 'first.txt' but got: '${content}'")
+endif()
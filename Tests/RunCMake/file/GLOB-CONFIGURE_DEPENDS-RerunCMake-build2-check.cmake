@@ -0,0 +1,5 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/glob.txt" content)
+if(NOT content STREQUAL "first.txt;sub/second.txt")
+  set(RunCMake_TEST_FAILED
+    "Expected 'first.txt;sub/second.txt' but got: '${content}'")
+endif()
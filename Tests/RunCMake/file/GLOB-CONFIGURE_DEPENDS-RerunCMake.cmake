@@ -0,0 +1,4 @@
+file(GLOB_RECURSE CONTENT_LIST
+  RELATIVE "${CMAKE_CURRENT_BINARY_DIR}/test" CONFIGURE_DEPENDS
+  "${CMAKE_CURRENT_BINARY_DIR}/test/*.txt")
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/glob.txt" "${CONTENT_LIST}")
@@ -0,0 +1,20 @@
+# Directory listings read by earlier globs must not hide files created
+# by later commands.
+set(dir "${CMAKE_CURRENT_BINARY_DIR}/created")
+file(REMOVE_RECURSE "${dir}")
+file(MAKE_DIRECTORY "${dir}")
+
+function(check_glob step)
+  file(GLOB files RELATIVE "${dir}" "${dir}/*")
+  file(GLOB_RECURSE recursed RELATIVE "${dir}" "${dir}/*")
+  message("${step}: ${files} | ${recursed}")
+endfunction()
+
+check_glob("empty")
+write_file("${dir}/write_file.txt" "content")
+check_glob("write_file")
+make_directory("${dir}/made")
+check_glob("make_directory")
+file(LOCK "${dir}/made/lock.txt")
+check_glob("file(LOCK)")
+file(LOCK "${dir}/made/lock.txt" RELEASE)
@@ -0,0 +1 @@
+file(GLOB CONTENT_LIST CONFIGURE_DEPENDS "${CMAKE_CURRENT_LIST_DIR}/*")
@@ -0,0 +1,22 @@
+# Copy a file with the old time stamp of its source, so that it is parsed
+# once more to be cached and then reused.
+file(COPY "${CMAKE_CURRENT_LIST_DIR}/IncludeRewrittenMacro.cmake"
+  DESTINATION "${CMAKE_CURRENT_BINARY_DIR}")
+set(file "${CMAKE_CURRENT_BINARY_DIR}/IncludeRewrittenMacro.cmake")
+include("${file}")
+include("${file}")
+include("${file}")
+set_value(1)
+if(NOT value STREQUAL "11")
+  message(FATAL_ERROR "value is '${value}' instead of 11")
+endif()
+
+# Rewrite the file with the same size.  Its new time must be noticed.
+file(READ "${file}" content)
+string(REPLACE "set(value 1" "set(value 2" content "${content}")
+file(WRITE "${file}" "${content}")
+include("${file}")
+set_value(2)
+if(NOT value STREQUAL "22")
+  message(FATAL_ERROR "value is '${value}' instead of 22")
+endif()
@@ -0,0 +1,3 @@
+macro(set_value v)
+  set(value 1${v})
+endmacro()
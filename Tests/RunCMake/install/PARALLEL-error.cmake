@@ -0,0 +1,9 @@
+set(CMAKE_INSTALL_PARALLEL_LEVEL 2)
+set(dir "${CMAKE_CURRENT_BINARY_DIR}/PARALLEL-error")
+file(REMOVE_RECURSE "${dir}")
+file(INSTALL_QUEUE BEGIN)
+file(INSTALL "${CMAKE_CURRENT_LIST_DIR}/empty.c" DESTINATION "${dir}")
+file(RPATH_CHANGE FILE "${dir}/empty.c" OLD_RPATH "/old" NEW_RPATH "/new")
+message("queued")
+file(INSTALL_QUEUE END)
+message("after")
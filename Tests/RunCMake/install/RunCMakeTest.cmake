@@ -64,6 +64,22 @@ if(NOT RunCMake_GENERATOR STREQUAL "Xcode" OR NOT "$ENV{CMAKE_OSX_ARCHITECTURES}
   run_install_test(FILES-TARGET_OBJECTS)
 endif()
 
+run_install_test(TARGETS-PARALLEL)
+run_cmake_command(PARALLEL-error ${CMAKE_COMMAND}
+  -P ${RunCMake_SOURCE_DIR}/PARALLEL-error.cmake)
+run_install_test(TARGETS-HARDLINK)
+function(run_install_touch_test case file)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/${case}-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  set(CMAKE_INSTALL_PREFIX ${RunCMake_TEST_BINARY_DIR}/root-all)
+  # Give the source a time the installed copy cannot have.
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  execute_process(COMMAND ${CMAKE_COMMAND} -E touch
+    ${RunCMake_TEST_BINARY_DIR}/${file})
+  run_cmake_command(${case}-touch ${CMAKE_COMMAND} -DCMAKE_INSTALL_PREFIX=${CMAKE_INSTALL_PREFIX} -DBUILD_TYPE=Debug -P cmake_install.cmake)
+endfunction()
+run_install_touch_test(TARGETS-HARDLINK obj2.c)
+
 set(run_install_test_components 1)
 run_install_test(FILES-EXCLUDE_FROM_ALL)
 run_install_test(TARGETS-EXCLUDE_FROM_ALL)
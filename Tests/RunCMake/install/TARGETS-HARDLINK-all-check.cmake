@@ -0,0 +1,16 @@
+check_installed([[^bin;(bin/[^;]*;)+lib;(lib/[^;]*;)+src;src/main\.c;src/obj1\.c;src/obj2\.c$]])
+
+# The hashes of all installed files are recorded.
+file(STRINGS ${RunCMake_TEST_BINARY_DIR}/install_manifest_hashes.txt hashes
+  REGEX "^[0-9a-f]+ ")
+list(LENGTH hashes count)
+if(NOT count GREATER 4)
+  string(APPEND RunCMake_TEST_FAILED "Unexpected install hashes:\n  ${hashes}\n")
+endif()
+
+# src/main.c is a hard link to its source, so writing one changes both.
+file(APPEND ${CMAKE_INSTALL_PREFIX}/src/main.c "/* linked */\n")
+file(READ ${RunCMake_TEST_BINARY_DIR}/main.c main)
+if(NOT main MATCHES "linked")
+  string(APPEND RunCMake_TEST_FAILED "src/main.c is not a hard link to its source.\n")
+endif()
@@ -0,0 +1,11 @@
+# The source of src/obj2.c has a new time but the recorded content.
+if(NOT actual_stdout MATCHES "Up-to-date: [^\n]*/src/obj2\\.c")
+  string(APPEND RunCMake_TEST_FAILED "src/obj2.c was installed again.\n")
+endif()
+
+# src/obj2.c has other permissions than its source, so it is a copy.
+file(APPEND ${RunCMake_TEST_BINARY_DIR}/obj2.c "/* changed */\n")
+file(READ ${CMAKE_INSTALL_PREFIX}/src/obj2.c obj2)
+if(obj2 MATCHES "changed")
+  string(APPEND RunCMake_TEST_FAILED "src/obj2.c is a hard link to its source.\n")
+endif()
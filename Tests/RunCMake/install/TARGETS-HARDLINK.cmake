@@ -0,0 +1,23 @@
+enable_language(C)
+install(CODE [[
+  set(CMAKE_INSTALL_HARDLINK 1)
+  set(CMAKE_INSTALL_HASH_CHECK 1)
+]])
+add_library(mylib SHARED obj1.c)
+add_executable(myexe main.c)
+target_link_libraries(myexe mylib)
+install(TARGETS myexe mylib
+  RUNTIME DESTINATION bin
+  LIBRARY DESTINATION lib
+  ARCHIVE DESTINATION lib
+  )
+# Install copies in the build tree, which the checks modify.  Only files
+# installed with the permissions of their source are linked.
+set(perms OWNER_READ OWNER_WRITE GROUP_READ WORLD_READ)
+file(COPY main.c obj2.c DESTINATION ${CMAKE_CURRENT_BINARY_DIR}
+  FILE_PERMISSIONS ${perms})
+install(FILES ${CMAKE_CURRENT_BINARY_DIR}/main.c DESTINATION src
+  PERMISSIONS ${perms})
+install(FILES obj1.c DESTINATION src)
+install(PROGRAMS ${CMAKE_CURRENT_BINARY_DIR}/obj2.c DESTINATION src
+  PERMISSIONS OWNER_READ OWNER_WRITE)
@@ -0,0 +1,18 @@
+check_installed([[^bin;(bin/[^;]*;)+lib;(lib/[^;]*;)+src;src/empty\.c;src/main\.c;src/obj1\.c;src/obj2\.c;src/parallel\.cmake$]])
+
+# The manifest lists the files in the order of the install rules.
+file(STRINGS ${RunCMake_TEST_BINARY_DIR}/install_manifest.txt manifest)
+string(REPLACE "${CMAKE_INSTALL_PREFIX}/" "" manifest "${manifest}")
+if(NOT manifest MATCHES [[^bin/myexe(\.exe)?;.*mylib3[^;]*;src/main\.c;src/obj1\.c;src/obj2\.c;src/parallel\.cmake;src/empty\.c$]])
+  string(APPEND RunCMake_TEST_FAILED "Unexpected install manifest:\n  ${manifest}\n")
+endif()
+
+# The targets of both directories are queued together, so their RPATHs
+# are only set once all of them have been listed for installation.
+if(actual_stdout MATCHES "Installing: [^\n]*/libmylib\\.so")
+  if(NOT actual_stdout MATCHES "Set runtime path")
+    string(APPEND RunCMake_TEST_FAILED "No runtime path was set.\n")
+  elseif(actual_stdout MATCHES "Set runtime path[^\n]*\n(.*\n)?-- Installing: [^\n]*/(myexe|libmylib)")
+    string(APPEND RunCMake_TEST_FAILED "Targets were installed one after another.\n")
+  endif()
+endif()
@@ -0,0 +1,16 @@
+enable_language(C)
+set(CMAKE_INSTALL_PARALLEL_LEVEL 4)
+# Give every target an RPATH to change, so the check can tell whether the
+# changes were queued behind the copies.
+set(CMAKE_INSTALL_RPATH "/parallel")
+add_library(mylib SHARED obj1.c)
+add_library(mylib2 SHARED obj2.c)
+add_executable(myexe main.c)
+target_link_libraries(myexe mylib)
+install(TARGETS myexe mylib mylib2
+  RUNTIME DESTINATION bin
+  LIBRARY DESTINATION lib
+  ARCHIVE DESTINATION lib
+  )
+# The subdirectory script is included right after the rules above.
+add_subdirectory(TARGETS-PARALLEL)
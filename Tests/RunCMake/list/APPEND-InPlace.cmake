@@ -0,0 +1,33 @@
+cmake_policy(SET CMP0007 NEW)
+
+set(mylist a)
+list(LENGTH mylist n)
+list(APPEND mylist "b\;c" "[d;e")
+list(LENGTH mylist n)
+message("after brackets: ${n} ${mylist}")
+list(APPEND mylist "f]" g)
+list(LENGTH mylist n)
+list(GET mylist -1 last)
+message("closed: ${n} ${last}")
+list(APPEND mylist "h\\")
+list(APPEND mylist i "")
+list(LENGTH mylist n)
+list(GET mylist -2 last)
+message("escaped: ${n} ${last}")
+list(APPEND mylist j)
+list(FIND mylist j idx)
+message("empty: ${idx} ${mylist}")
+
+function(append_in_function)
+  list(APPEND mylist k)
+  list(LENGTH mylist n)
+  message("function: ${n}")
+endfunction()
+append_in_function()
+list(LENGTH mylist n)
+message("caller: ${n}")
+
+set(mycache x CACHE STRING "")
+list(APPEND mycache y)
+list(LENGTH mycache n)
+message("cache: ${n} ${mycache}")
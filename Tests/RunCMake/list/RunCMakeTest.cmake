@@ -31,3 +31,4 @@ run_cmake(FILTER-REGEX-InvalidMode)
 run_cmake(FILTER-REGEX-InvalidOperator)
 run_cmake(FILTER-REGEX-Valid0)
 run_cmake(FILTER-REGEX-Valid1)
+run_cmake(APPEND-InPlace)
@@ -0,0 +1,24 @@
+# The same expressions are used by several commands and inputs, so all
+# but the first use of each get a copy of the program from the cache.
+# Each copy must match on its own, without the groups of an earlier use.
+foreach(src a/one.c b/two.cxx c/three.h)
+  string(REGEX MATCH "([^/]+)\\.([a-z]+)$" name "${src}")
+  message("match: ${name} ${CMAKE_MATCH_1} ${CMAKE_MATCH_2}")
+  if(src MATCHES "^([a-z])/.*\\.c(xx)?$")
+    message("source: ${CMAKE_MATCH_1} ${CMAKE_MATCH_2}")
+  endif()
+  string(REGEX REPLACE "^([a-z])/" "\\1:" replaced "${src}")
+  message("replace: ${replaced}")
+endforeach()
+
+set(srcs a/one.c b/two.cxx c/three.h)
+list(FILTER srcs INCLUDE REGEX "^([a-z])/.*\\.c(xx)?$")
+message("filter: ${srcs}")
+
+# Use more distinct expressions than the cache keeps so that the first
+# ones are evicted, then use an evicted one again.
+foreach(i RANGE 300)
+  string(REGEX MATCH "^x${i}(y*)$" ignored "x${i}yy")
+endforeach()
+string(REGEX MATCH "^x0(y*)$" name "x0yyy")
+message("evicted: ${name} ${CMAKE_MATCH_1}")
@@ -0,0 +1,5 @@
+# An expression that fails to compile is not cached, so every use of it
+# reports the error.
+foreach(i 1 2)
+  string(REGEX MATCH "(" name "${i}")
+endforeach()
@@ -21,6 +21,8 @@ run_cmake(UuidBadType)
 
 run_cmake(RegexClear)
 run_cmake(RegexMultiMatchClear)
+run_cmake(RegexCached)
+run_cmake(RegexCachedInvalid)
 
 run_cmake(UTF-16BE)
 run_cmake(UTF-16LE)
@@ -0,0 +1,34 @@
+# Compare the dependency graphs and the generated project files of a
+# configuration that reuses dependencies with one that does not.
+string(REGEX REPLACE "^.*more configurations\\.\n" "" graphs
+  "${actual_stderr}")
+file(GLOB projects RELATIVE "${RunCMake_TEST_BINARY_DIR}"
+  "${RunCMake_TEST_BINARY_DIR}/*.sln"
+  "${RunCMake_TEST_BINARY_DIR}/*.vcproj"
+  "${RunCMake_TEST_BINARY_DIR}/*.vcxproj"
+  )
+set(reuse_dir "${RunCMake_BINARY_DIR}/ConfigDepends-reuse")
+
+if(ConfigDepends_STEP STREQUAL "reuse")
+  file(REMOVE_RECURSE "${reuse_dir}")
+  file(WRITE "${reuse_dir}/graphs.txt" "${graphs}")
+  foreach(p IN LISTS projects)
+    configure_file("${RunCMake_TEST_BINARY_DIR}/${p}" "${reuse_dir}/${p}"
+      COPYONLY)
+  endforeach()
+  return()
+endif()
+
+file(READ "${reuse_dir}/graphs.txt" reuse_graphs)
+if(NOT graphs STREQUAL reuse_graphs)
+  string(APPEND RunCMake_TEST_FAILED
+    "Dependency graphs differ from those with reuse:\n${reuse_graphs}\n")
+endif()
+foreach(p IN LISTS projects)
+  file(READ "${RunCMake_TEST_BINARY_DIR}/${p}" actual)
+  file(READ "${reuse_dir}/${p}" expect)
+  if(NOT actual STREQUAL expect)
+    string(APPEND RunCMake_TEST_FAILED
+      "Generated ${p} differs from the one with reuse.\n")
+  endif()
+endforeach()
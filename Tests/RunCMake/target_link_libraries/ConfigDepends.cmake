@@ -0,0 +1,27 @@
+enable_language(C)
+
+set_property(GLOBAL PROPERTY GLOBAL_DEPENDS_DEBUG_MODE 1)
+
+add_library(base STATIC empty.c)
+add_library(debugonly STATIC empty.c)
+add_library(opt STATIC empty.c)
+add_library(iface INTERFACE)
+target_link_libraries(iface INTERFACE base)
+
+add_library(mid STATIC empty.c)
+target_link_libraries(mid PUBLIC iface $<$<CONFIG:Debug>:debugonly>)
+
+add_executable(main empty.c)
+target_link_libraries(main PRIVATE mid debug base optimized opt)
+
+add_executable(plain empty.c)
+target_link_libraries(plain PRIVATE iface)
+
+# Make every configuration of every target be evaluated separately
+# without changing the dependencies.
+if(EVALUATE_EVERY_CONFIG)
+  foreach(t base debugonly opt mid main plain)
+    set_property(TARGET ${t} APPEND PROPERTY
+      LINK_LIBRARIES "$<$<CONFIG:NoSuchConfig>:>")
+  endforeach()
+endif()
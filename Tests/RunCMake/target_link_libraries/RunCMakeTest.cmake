@@ -10,3 +10,24 @@ run_cmake(SubDirTarget)
 run_cmake(SharedDepNotTarget)
 run_cmake(StaticPrivateDepNotExported)
 run_cmake(StaticPrivateDepNotTarget)
+
+if(RunCMake_GENERATOR MATCHES "Visual Studio|Xcode")
+  # Configure one tree twice, first reusing the dependencies of targets
+  # that do not depend on the configuration and then evaluating every
+  # configuration, and compare the results.
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ConfigDepends-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  foreach(ConfigDepends_STEP reuse every)
+    if(ConfigDepends_STEP STREQUAL "every")
+      set(RunCMake_TEST_OPTIONS -DEVALUATE_EVERY_CONFIG=ON)
+    endif()
+    set(RunCMake-stderr-file ConfigDepends-${ConfigDepends_STEP}-stderr.txt)
+    run_cmake(ConfigDepends)
+  endforeach()
+  unset(RunCMake-stderr-file)
+  unset(RunCMake_TEST_OPTIONS)
+  unset(RunCMake_TEST_NO_CLEAN)
+  unset(RunCMake_TEST_BINARY_DIR)
+endif()
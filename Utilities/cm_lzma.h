@@ -8,6 +8,9 @@
 #ifdef CMAKE_USE_SYSTEM_LIBLZMA
 #include <lzma.h>
 #else
+#ifndef LZMA_API_STATIC
+#define LZMA_API_STATIC
+#endif
 #include <cmliblzma/liblzma/api/lzma.h>
 #endif
 